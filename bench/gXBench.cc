@@ -0,0 +1,1330 @@
+// *************************************
+// Ganymede Xpedia
+// Benchmarks
+// 'gXBench.cc'
+// Author: jcjuarez
+// *************************************
+
+#include <deque>
+#include <cmath>
+#include <memory>
+#include <netdb.h>
+#include <poll.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <iostream>
+#include <sys/un.h>
+#include <sys/socket.h>
+#include <netinet/tcp.h>
+#include "gXCrc32c.hh"
+#include "gXCpuTopology.hh"
+#include "gXLatencyHistogram.hh"
+#include "gXDataTransmissionServer.hh"
+#include "gXDataTransmissionProtocol.hh"
+
+namespace gX
+{
+
+//
+// Load generation models.
+//
+enum class LoadModel : uint8_t
+{
+
+    //
+    // Every connection keeps a fixed number of requests outstanding and sends the next one as soon
+    // as a response arrives. Measures the throughput the server sustains.
+    //
+    ClosedLoop,
+
+    //
+    // Requests are issued at a fixed rate regardless of how fast responses come back.
+    // Measures the latency clients observe at a given offered load.
+    //
+    OpenLoop
+
+};
+
+//
+// Configurations for the load generator.
+//
+struct BenchmarkConfiguration
+{
+
+    //
+    // Constructor.
+    //
+    BenchmarkConfiguration();
+
+    //
+    // Host name or address of the DTP server.
+    //
+    std::string m_Host;
+
+    //
+    // Port of the DTP server.
+    //
+    uint32_t m_Port;
+
+    //
+    // Path of the AF_UNIX socket to load instead of the host and port. Embedded servers listen on it too.
+    // A leading '@' refers to the abstract namespace. Empty means TCP.
+    //
+    std::string m_UnixSocketPath;
+
+    //
+    // Number of load generation threads. Connections are spread evenly across them.
+    //
+    uint16_t m_NumberThreads;
+
+    //
+    // Total number of connections.
+    //
+    uint16_t m_NumberConnections;
+
+    //
+    // Load generation model.
+    //
+    LoadModel m_LoadModel;
+
+    //
+    // Total number of requests per second issued in open-loop mode.
+    //
+    uint64_t m_RequestRate;
+
+    //
+    // Number of requests each connection keeps outstanding in closed-loop mode.
+    //
+    uint16_t m_PipelineDepth;
+
+    //
+    // Payload size of every request.
+    //
+    uint32_t m_PayloadSize;
+
+    //
+    // Packet tags to send along with their relative weights.
+    //
+    std::vector<std::pair<PacketTag, uint32_t>> m_PacketTagMix;
+
+    //
+    // Whether requests carry a CRC32C of their payload for the server to verify.
+    //
+    bool m_EnableChecksums;
+
+    //
+    // Time budget carried by every request, after which the server drops it instead of executing it. Zero for none.
+    //
+    uint32_t m_DeadlineMilliseconds;
+
+    //
+    // Duration of the measurement.
+    //
+    uint32_t m_DurationSeconds;
+
+    //
+    // Duration of the warmup preceding the measurement, whose responses are not recorded.
+    //
+    uint32_t m_WarmupSeconds;
+
+    //
+    // I/O backends of the servers started in-process, one run each. Empty to load an external server.
+    //
+    std::vector<IoBackend> m_EmbeddedServerBackends;
+
+    //
+    // Thread pool size of the in-process servers. Zero uses the server default.
+    //
+    uint16_t m_EmbeddedServerThreadPoolSize;
+
+    //
+    // Where the in-process servers execute the echo endpoint.
+    //
+    EndpointExecutionMode m_EmbeddedServerExecutionMode;
+
+    //
+    // CPUs the in-process server I/O threads are pinned to. Empty leaves them unpinned.
+    //
+    std::vector<uint16_t> m_EmbeddedServerIoThreadCpus;
+
+    //
+    // CPUs the in-process server workers are pinned to. Empty leaves them unpinned.
+    //
+    std::vector<uint16_t> m_EmbeddedServerWorkerThreadCpus;
+
+    //
+    // Default host.
+    //
+    static constexpr const char* c_DefaultHost = "127.0.0.1";
+
+    //
+    // Default port.
+    //
+    static constexpr uint32_t c_DefaultPortNumber = 9090u;
+
+    //
+    // Default number of threads.
+    //
+    static constexpr uint16_t c_DefaultNumberThreads = 2u;
+
+    //
+    // Default number of connections.
+    //
+    static constexpr uint16_t c_DefaultNumberConnections = 8u;
+
+    //
+    // Default request rate.
+    //
+    static constexpr uint64_t c_DefaultRequestRate = 10000u;
+
+    //
+    // Default pipeline depth.
+    //
+    static constexpr uint16_t c_DefaultPipelineDepth = 1u;
+
+    //
+    // Default payload size.
+    //
+    static constexpr uint32_t c_DefaultPayloadSize = 64u;
+
+    //
+    // Default measurement duration.
+    //
+    static constexpr uint32_t c_DefaultDurationSeconds = 10u;
+
+    //
+    // Default warmup duration.
+    //
+    static constexpr uint32_t c_DefaultWarmupSeconds = 2u;
+
+};
+
+//
+// Results of a load generation run.
+//
+struct BenchmarkResult
+{
+
+    //
+    // Constructor.
+    //
+    BenchmarkResult();
+
+    //
+    // Number of responses received during the measurement.
+    //
+    uint64_t m_NumberResponses;
+
+    //
+    // Number of responses carrying a failure status.
+    //
+    uint64_t m_NumberFailedResponses;
+
+    //
+    // Latency buckets measured from the time each request was meant to be sent, in nanoseconds.
+    // Open-loop runs measure it directly; closed-loop runs derive it from the service latency.
+    //
+    std::vector<uint64_t> m_Latency;
+
+    //
+    // Latency buckets measured from the time each request was actually sent, in nanoseconds.
+    //
+    std::vector<uint64_t> m_ServiceLatency;
+
+    //
+    // Duration of the measurement.
+    //
+    std::chrono::steady_clock::duration m_Duration;
+
+};
+
+//
+// Multi-threaded DTP load generator.
+//
+class LoadGenerator
+{
+
+public:
+
+    //
+    // Constructor.
+    //
+    LoadGenerator(
+        const BenchmarkConfiguration& p_Configuration);
+
+    //
+    // Connects to the server, generates load for the warmup and measurement durations and merges the results.
+    //
+    StatusCode
+    Run(
+        BenchmarkResult& p_Result);
+
+private:
+
+    //
+    // Request sent and waiting for its response.
+    //
+    struct OutstandingRequest
+    {
+
+        //
+        // Time the request was meant to be sent.
+        //
+        std::chrono::steady_clock::time_point m_IntendedTime;
+
+        //
+        // Time the request was sent.
+        //
+        std::chrono::steady_clock::time_point m_SendTime;
+
+    };
+
+    //
+    // Non-blocking connection to the server, only used by its thread.
+    //
+    struct Connection
+    {
+
+        //
+        // Constructor.
+        //
+        Connection();
+
+        //
+        // Destructor. Closes the connection handle.
+        //
+        ~Connection();
+
+        //
+        // Connection socket handle.
+        //
+        FileDescriptor m_Handle;
+
+        //
+        // Requests waiting for their responses, in send order.
+        //
+        std::deque<OutstandingRequest> m_OutstandingRequests;
+
+        //
+        // Serialized requests not yet accepted by the socket.
+        //
+        std::vector<Byte> m_OutputData;
+
+        //
+        // Number of bytes of the output buffer already sent.
+        //
+        size_t m_OutputOffset;
+
+        //
+        // Received bytes not yet parsed as responses.
+        //
+        std::vector<Byte> m_InputData;
+
+        //
+        // Number of valid bytes in the input buffer.
+        //
+        size_t m_InputSize;
+
+    };
+
+    //
+    // Load generation thread along with the results it records.
+    //
+    struct Worker
+    {
+
+        //
+        // Constructor.
+        //
+        Worker();
+
+        //
+        // Connections of the thread.
+        //
+        std::vector<std::unique_ptr<Connection>> m_Connections;
+
+        //
+        // Latency from the intended send time.
+        //
+        LatencyHistogram m_Latency;
+
+        //
+        // Latency from the actual send time.
+        //
+        LatencyHistogram m_ServiceLatency;
+
+        //
+        // Number of responses received during the measurement.
+        //
+        uint64_t m_NumberResponses;
+
+        //
+        // Number of responses carrying a failure status.
+        //
+        uint64_t m_NumberFailedResponses;
+
+        //
+        // Status of the thread; a failure aborts the run.
+        //
+        StatusCode m_Status;
+
+        //
+        // Offset of the thread into the packet tag sequence, so that threads do not send in lockstep.
+        //
+        size_t m_PacketTagOffset;
+
+    };
+
+    //
+    // Establishes a non-blocking connection to the server.
+    //
+    StatusCode
+    Connect(
+        Connection& p_Connection) const;
+
+    //
+    // Generates load on the connections of a worker until the end of the run.
+    //
+    void
+    RunWorker(
+        Worker& p_Worker);
+
+    //
+    // Appends a request to the output of a connection.
+    //
+    void
+    QueueRequest(
+        Worker& p_Worker,
+        Connection& p_Connection,
+        const std::chrono::steady_clock::time_point p_IntendedTime,
+        const std::chrono::steady_clock::time_point p_Now);
+
+    //
+    // Writes as much of the connection output as the socket accepts.
+    //
+    StatusCode
+    WriteConnection(
+        Connection& p_Connection);
+
+    //
+    // Reads the available data of a connection and records the responses it completes.
+    //
+    StatusCode
+    ReadConnection(
+        Worker& p_Worker,
+        Connection& p_Connection);
+
+    //
+    // Load generation configurations.
+    //
+    const BenchmarkConfiguration& m_Configuration;
+
+    //
+    // Server address information, either IPv4 or AF_UNIX.
+    //
+    sockaddr_storage m_Address;
+
+    //
+    // Size of the server address information.
+    //
+    socklen_t m_AddressLength;
+
+    //
+    // Serialized request of each entry of the packet tag sequence.
+    //
+    std::vector<std::vector<Byte>> m_Requests;
+
+    //
+    // Start of the measurement; responses to requests meant to be sent earlier are not recorded.
+    //
+    std::chrono::steady_clock::time_point m_MeasurementStartTime;
+
+    //
+    // End of the run; no requests are sent afterwards.
+    //
+    std::chrono::steady_clock::time_point m_EndTime;
+
+    //
+    // Size of the receive buffer of each connection.
+    //
+    static constexpr size_t c_ReceiveBufferSize = 1u << 16;
+
+    //
+    // Time responses are still collected after the end of the run.
+    //
+    static constexpr std::chrono::seconds c_DrainTimeout = std::chrono::seconds(1);
+
+    //
+    // Longest wait for responses before the worker checks the clock again.
+    //
+    static constexpr std::chrono::milliseconds c_PollTimeout = std::chrono::milliseconds(10);
+
+};
+
+BenchmarkConfiguration::BenchmarkConfiguration()
+    : m_Host(c_DefaultHost),
+      m_Port(c_DefaultPortNumber),
+      m_NumberThreads(c_DefaultNumberThreads),
+      m_NumberConnections(c_DefaultNumberConnections),
+      m_LoadModel(LoadModel::ClosedLoop),
+      m_RequestRate(c_DefaultRequestRate),
+      m_PipelineDepth(c_DefaultPipelineDepth),
+      m_PayloadSize(c_DefaultPayloadSize),
+      m_PacketTagMix { { DataTransmissionServer::c_DefaultEndpointPacketTag, 1u } },
+      m_EnableChecksums(false),
+      m_DeadlineMilliseconds(0),
+      m_DurationSeconds(c_DefaultDurationSeconds),
+      m_WarmupSeconds(c_DefaultWarmupSeconds),
+      m_EmbeddedServerThreadPoolSize(0),
+      m_EmbeddedServerExecutionMode(EndpointExecutionMode::Pooled)
+{}
+
+BenchmarkResult::BenchmarkResult()
+    : m_NumberResponses(0),
+      m_NumberFailedResponses(0),
+      m_Latency(LatencyHistogram::c_NumberBuckets, 0u),
+      m_ServiceLatency(LatencyHistogram::c_NumberBuckets, 0u),
+      m_Duration(std::chrono::steady_clock::duration::zero())
+{}
+
+LoadGenerator::Connection::Connection()
+    : m_Handle(-1),
+      m_OutputOffset(0),
+      m_InputData(c_ReceiveBufferSize),
+      m_InputSize(0)
+{}
+
+LoadGenerator::Connection::~Connection()
+{
+    if (m_Handle >= 0)
+    {
+        close(m_Handle);
+    }
+}
+
+LoadGenerator::Worker::Worker()
+    : m_NumberResponses(0),
+      m_NumberFailedResponses(0),
+      m_Status(Status::Success),
+      m_PacketTagOffset(0)
+{}
+
+LoadGenerator::LoadGenerator(
+    const BenchmarkConfiguration& p_Configuration)
+    : m_Configuration(p_Configuration),
+      m_Address {},
+      m_AddressLength(0)
+{}
+
+StatusCode
+LoadGenerator::Run(
+    BenchmarkResult& p_Result)
+{
+    const std::string& unixSocketPath = m_Configuration.m_UnixSocketPath;
+
+    if (!unixSocketPath.empty())
+    {
+        sockaddr_un& address = *reinterpret_cast<sockaddr_un*>(&m_Address);
+        address.sun_family = AF_UNIX;
+
+        if (unixSocketPath.size() >= sizeof(address.sun_path))
+        {
+            return Status::InvalidArgument;
+        }
+
+        std::memcpy(address.sun_path, unixSocketPath.data(), unixSocketPath.size());
+
+        const bool isAbstract = unixSocketPath.front() == '@';
+
+        if (isAbstract)
+        {
+            address.sun_path[0] = '\0';
+        }
+
+        m_AddressLength = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + unixSocketPath.size() + (isAbstract ? 0u : 1u));
+    }
+    else
+    {
+        addrinfo hints {};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* addresses = nullptr;
+
+        if (getaddrinfo(m_Configuration.m_Host.c_str(), nullptr, &hints, &addresses) != 0 ||
+            addresses == nullptr)
+        {
+            return Status::AddressResolutionFailed;
+        }
+
+        sockaddr_in& address = *reinterpret_cast<sockaddr_in*>(&m_Address);
+        address = *reinterpret_cast<const sockaddr_in*>(addresses->ai_addr);
+        address.sin_port = htons(m_Configuration.m_Port);
+        m_AddressLength = sizeof(address);
+        freeaddrinfo(addresses);
+    }
+
+    //
+    // Expand the packet tag mix into a sequence following its weights, so that every run sends the same requests in the same order.
+    //
+    m_Requests.clear();
+
+    for (const auto& [packetTag, weight] : m_Configuration.m_PacketTagMix)
+    {
+        const uint8_t flags =
+            (m_Configuration.m_EnableChecksums ? DataTransmissionFrameHeader::c_FlagChecksum : 0u) |
+            (m_Configuration.m_DeadlineMilliseconds != 0 ? DataTransmissionFrameHeader::c_FlagDeadline : 0u);
+        const uint32_t headerSize = DataTransmissionProtocol::GetHeaderSize(flags);
+        std::vector<Byte> request(headerSize + m_Configuration.m_PayloadSize, 'x');
+
+        DataTransmissionProtocol::SerializeFrameHeader(
+            DataTransmissionFrameHeader {
+                DataTransmissionFrameHeader::c_Magic,
+                DataTransmissionFrameHeader::c_Version,
+                flags,
+                packetTag,
+                m_Configuration.m_PayloadSize,
+                Crc32c::Compute(request.data() + headerSize, m_Configuration.m_PayloadSize),
+                static_cast<uint32_t>(std::min<uint64_t>(m_Configuration.m_DeadlineMilliseconds * 1000ull, UINT32_MAX)) },
+            request.data());
+
+        m_Requests.insert(m_Requests.end(), weight, request);
+    }
+
+    if (m_Requests.empty())
+    {
+        return Status::Fail;
+    }
+
+    //
+    // Connect every worker before starting the clock so that handshakes do not count.
+    //
+    const uint16_t numberThreads = std::max<uint16_t>(1u, std::min(m_Configuration.m_NumberThreads, m_Configuration.m_NumberConnections));
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    for (uint16_t threadIndex = 0; threadIndex < numberThreads; ++threadIndex)
+    {
+        workers.emplace_back(std::make_unique<Worker>());
+        workers.back()->m_PacketTagOffset = threadIndex * m_Requests.size() / numberThreads;
+    }
+
+    for (uint16_t connectionIndex = 0; connectionIndex < std::max<uint16_t>(1u, m_Configuration.m_NumberConnections); ++connectionIndex)
+    {
+        Worker& worker = *workers[connectionIndex % numberThreads];
+        worker.m_Connections.emplace_back(std::make_unique<Connection>());
+
+        const StatusCode status = Connect(*worker.m_Connections.back());
+
+        if (Status::Failed(status))
+        {
+            return status;
+        }
+    }
+
+    m_MeasurementStartTime = std::chrono::steady_clock::now() + std::chrono::seconds(m_Configuration.m_WarmupSeconds);
+    m_EndTime = m_MeasurementStartTime + std::chrono::seconds(m_Configuration.m_DurationSeconds);
+
+    std::vector<std::thread> threads;
+
+    for (std::unique_ptr<Worker>& worker : workers)
+    {
+        threads.emplace_back(&LoadGenerator::RunWorker, this, std::ref(*worker));
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    p_Result = BenchmarkResult();
+    p_Result.m_Duration = m_EndTime - m_MeasurementStartTime;
+
+    for (const std::unique_ptr<Worker>& worker : workers)
+    {
+        if (Status::Failed(worker->m_Status))
+        {
+            return worker->m_Status;
+        }
+
+        p_Result.m_NumberResponses += worker->m_NumberResponses;
+        p_Result.m_NumberFailedResponses += worker->m_NumberFailedResponses;
+        worker->m_Latency.MergeInto(p_Result.m_Latency);
+        worker->m_ServiceLatency.MergeInto(p_Result.m_ServiceLatency);
+    }
+
+    if (m_Configuration.m_LoadModel == LoadModel::ClosedLoop &&
+        p_Result.m_NumberResponses != 0)
+    {
+        //
+        // A closed-loop client stops sending while it waits, which hides the requests that would have queued
+        // behind a slow response (coordinated omission). Back-fill them the way HdrHistogram does, taking the
+        // mean latency as the interval at which each pipeline slot would otherwise have sent.
+        //
+        long double totalLatency = 0;
+
+        for (uint32_t bucketIndex = 0; bucketIndex < LatencyHistogram::c_NumberBuckets; ++bucketIndex)
+        {
+            totalLatency += static_cast<long double>(p_Result.m_ServiceLatency[bucketIndex]) * LatencyHistogram::GetBucketValue(bucketIndex);
+        }
+
+        const uint64_t expectedInterval = std::max<uint64_t>(1u, static_cast<uint64_t>(totalLatency / p_Result.m_NumberResponses));
+
+        for (uint32_t bucketIndex = 0; bucketIndex < LatencyHistogram::c_NumberBuckets; ++bucketIndex)
+        {
+            const uint64_t count = p_Result.m_ServiceLatency[bucketIndex];
+            const uint64_t value = LatencyHistogram::GetBucketValue(bucketIndex);
+
+            p_Result.m_Latency[bucketIndex] += count;
+
+            for (uint64_t missingValue = value - std::min(value, expectedInterval);
+                missingValue >= expectedInterval && count != 0;
+                missingValue -= expectedInterval)
+            {
+                p_Result.m_Latency[LatencyHistogram::GetBucketIndex(missingValue)] += count;
+            }
+        }
+    }
+
+    return Status::Success;
+}
+
+StatusCode
+LoadGenerator::Connect(
+    Connection& p_Connection) const
+{
+    if ((p_Connection.m_Handle = socket(m_Address.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0)) < 0)
+    {
+        return Status::SocketCreationFailed;
+    }
+
+    int32_t opt = 1;
+
+    if (m_Address.ss_family == AF_INET &&
+        setsockopt(p_Connection.m_Handle, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt)))
+    {
+        return Status::SocketConfigurationFailed;
+    }
+
+    while (connect(p_Connection.m_Handle, reinterpret_cast<const sockaddr*>(&m_Address), m_AddressLength) < 0)
+    {
+        if (errno != EINTR)
+        {
+            return Status::ConnectionFailed;
+        }
+    }
+
+    if (fcntl(p_Connection.m_Handle, F_SETFL, fcntl(p_Connection.m_Handle, F_GETFL) | O_NONBLOCK) < 0)
+    {
+        return Status::SocketConfigurationFailed;
+    }
+
+    return Status::Success;
+}
+
+void
+LoadGenerator::RunWorker(
+    Worker& p_Worker)
+{
+    const bool isOpenLoop = m_Configuration.m_LoadModel == LoadModel::OpenLoop;
+    std::vector<pollfd> pollHandles(p_Worker.m_Connections.size());
+
+    //
+    // In open-loop mode every thread issues its share of the rate on its own schedule.
+    //
+    const uint64_t threadRequestRate = std::max<uint64_t>(1u, m_Configuration.m_RequestRate * p_Worker.m_Connections.size() / std::max<uint16_t>(1u, m_Configuration.m_NumberConnections));
+    const std::chrono::nanoseconds sendInterval(1'000'000'000u / threadRequestRate);
+    std::chrono::steady_clock::time_point nextSendTime = std::chrono::steady_clock::now();
+    size_t nextConnectionIndex = 0;
+
+    FOREVER
+    {
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+        if (now >= m_EndTime)
+        {
+            break;
+        }
+
+        if (isOpenLoop)
+        {
+            //
+            // Issue every request whose time has come, even if earlier ones are still waiting for their responses.
+            //
+            while (nextSendTime <= now)
+            {
+                QueueRequest(p_Worker, *p_Worker.m_Connections[nextConnectionIndex], nextSendTime, now);
+                nextConnectionIndex = (nextConnectionIndex + 1) % p_Worker.m_Connections.size();
+                nextSendTime += sendInterval;
+            }
+        }
+        else
+        {
+            for (std::unique_ptr<Connection>& connection : p_Worker.m_Connections)
+            {
+                while (connection->m_OutstandingRequests.size() < m_Configuration.m_PipelineDepth)
+                {
+                    QueueRequest(p_Worker, *connection, now, now);
+                }
+            }
+        }
+
+        for (size_t connectionIndex = 0; connectionIndex < p_Worker.m_Connections.size(); ++connectionIndex)
+        {
+            Connection& connection = *p_Worker.m_Connections[connectionIndex];
+
+            p_Worker.m_Status = WriteConnection(connection);
+
+            if (Status::Failed(p_Worker.m_Status))
+            {
+                return;
+            }
+
+            pollHandles[connectionIndex].fd = connection.m_Handle;
+            pollHandles[connectionIndex].events = static_cast<int16_t>(POLLIN | (connection.m_OutputOffset < connection.m_OutputData.size() ? POLLOUT : 0));
+            pollHandles[connectionIndex].revents = 0;
+        }
+
+        //
+        // Wait for responses, but not past the next scheduled request.
+        //
+        std::chrono::nanoseconds timeout = c_PollTimeout;
+
+        if (isOpenLoop)
+        {
+            timeout = std::clamp<std::chrono::nanoseconds>(
+                nextSendTime - std::chrono::steady_clock::now(),
+                std::chrono::nanoseconds::zero(),
+                timeout);
+        }
+
+        //
+        // Nanosecond timeout so that open-loop schedules above 1000 requests per second do not busy-spin.
+        //
+        const timespec timeoutSpecification = {
+            static_cast<time_t>(timeout.count() / 1000000000),
+            static_cast<long>(timeout.count() % 1000000000) };
+
+        if (ppoll(pollHandles.data(), pollHandles.size(), &timeoutSpecification, nullptr) <= 0)
+        {
+            continue;
+        }
+
+        for (size_t connectionIndex = 0; connectionIndex < p_Worker.m_Connections.size(); ++connectionIndex)
+        {
+            if (pollHandles[connectionIndex].revents & (POLLIN | POLLERR | POLLHUP))
+            {
+                p_Worker.m_Status = ReadConnection(p_Worker, *p_Worker.m_Connections[connectionIndex]);
+
+                if (Status::Failed(p_Worker.m_Status))
+                {
+                    return;
+                }
+            }
+        }
+    }
+
+    //
+    // Collect the responses still on their way for a while; they were issued within the measurement.
+    //
+    const std::chrono::steady_clock::time_point drainEndTime = m_EndTime + c_DrainTimeout;
+
+    for (std::unique_ptr<Connection>& connection : p_Worker.m_Connections)
+    {
+        while (!connection->m_OutstandingRequests.empty() &&
+            std::chrono::steady_clock::now() < drainEndTime)
+        {
+            pollfd pollHandle { connection->m_Handle, static_cast<int16_t>(POLLIN | (connection->m_OutputOffset < connection->m_OutputData.size() ? POLLOUT : 0)), 0 };
+
+            if (poll(&pollHandle, 1u, 10) <= 0)
+            {
+                continue;
+            }
+
+            p_Worker.m_Status = WriteConnection(*connection);
+
+            if (Status::Succeeded(p_Worker.m_Status) &&
+                (pollHandle.revents & (POLLIN | POLLERR | POLLHUP)))
+            {
+                p_Worker.m_Status = ReadConnection(p_Worker, *connection);
+            }
+
+            if (Status::Failed(p_Worker.m_Status))
+            {
+                return;
+            }
+        }
+    }
+}
+
+void
+LoadGenerator::QueueRequest(
+    Worker& p_Worker,
+    Connection& p_Connection,
+    const std::chrono::steady_clock::time_point p_IntendedTime,
+    const std::chrono::steady_clock::time_point p_Now)
+{
+    const std::vector<Byte>& request = m_Requests[p_Worker.m_PacketTagOffset++ % m_Requests.size()];
+
+    p_Connection.m_OutputData.insert(p_Connection.m_OutputData.end(), request.begin(), request.end());
+    p_Connection.m_OutstandingRequests.push_back(OutstandingRequest { p_IntendedTime, p_Now });
+}
+
+StatusCode
+LoadGenerator::WriteConnection(
+    Connection& p_Connection)
+{
+    while (p_Connection.m_OutputOffset < p_Connection.m_OutputData.size())
+    {
+        const ssize_t sendResult = send(
+            p_Connection.m_Handle,
+            p_Connection.m_OutputData.data() + p_Connection.m_OutputOffset,
+            p_Connection.m_OutputData.size() - p_Connection.m_OutputOffset,
+            MSG_NOSIGNAL);
+
+        if (sendResult >= 0)
+        {
+            p_Connection.m_OutputOffset += static_cast<size_t>(sendResult);
+
+            continue;
+        }
+
+        if (errno == EINTR)
+        {
+            continue;
+        }
+
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            return Status::Success;
+        }
+
+        return Status::ConnectionLost;
+    }
+
+    p_Connection.m_OutputData.clear();
+    p_Connection.m_OutputOffset = 0;
+
+    return Status::Success;
+}
+
+StatusCode
+LoadGenerator::ReadConnection(
+    Worker& p_Worker,
+    Connection& p_Connection)
+{
+    FOREVER
+    {
+        if (p_Connection.m_InputSize == p_Connection.m_InputData.size())
+        {
+            p_Connection.m_InputData.resize(p_Connection.m_InputData.size() * 2);
+        }
+
+        const ssize_t readResult = recv(
+            p_Connection.m_Handle,
+            p_Connection.m_InputData.data() + p_Connection.m_InputSize,
+            p_Connection.m_InputData.size() - p_Connection.m_InputSize,
+            0);
+
+        if (readResult < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (readResult < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            return Status::Success;
+        }
+
+        if (readResult <= 0)
+        {
+            return Status::ConnectionLost;
+        }
+
+        p_Connection.m_InputSize += static_cast<size_t>(readResult);
+
+        //
+        // Record every complete response; responses come back in request order.
+        //
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        size_t inputOffset = 0;
+
+        while (p_Connection.m_InputSize - inputOffset >= DataTransmissionProtocol::c_ResponseHeaderSize)
+        {
+            DataTransmissionFrameHeader header;
+            StatusCode responseStatus;
+
+            if (Status::Failed(DataTransmissionProtocol::DeserializeResponseHeader(p_Connection.m_InputData.data() + inputOffset, header, responseStatus)) ||
+                p_Connection.m_OutstandingRequests.empty())
+            {
+                return Status::InvalidFrame;
+            }
+
+            const size_t responseSize = DataTransmissionProtocol::c_ResponseHeaderSize + header.m_PayloadSize;
+
+            if (p_Connection.m_InputSize - inputOffset < responseSize)
+            {
+                break;
+            }
+
+            inputOffset += responseSize;
+
+            const OutstandingRequest request = p_Connection.m_OutstandingRequests.front();
+            p_Connection.m_OutstandingRequests.pop_front();
+
+            if (request.m_IntendedTime < m_MeasurementStartTime ||
+                request.m_IntendedTime >= m_EndTime)
+            {
+                continue;
+            }
+
+            ++p_Worker.m_NumberResponses;
+            p_Worker.m_NumberFailedResponses += Status::Failed(responseStatus) ? 1u : 0u;
+
+            if (m_Configuration.m_LoadModel == LoadModel::OpenLoop)
+            {
+                p_Worker.m_Latency.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(now - request.m_IntendedTime).count());
+            }
+
+            p_Worker.m_ServiceLatency.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(now - request.m_SendTime).count());
+        }
+
+        std::memmove(p_Connection.m_InputData.data(), p_Connection.m_InputData.data() + inputOffset, p_Connection.m_InputSize - inputOffset);
+        p_Connection.m_InputSize -= inputOffset;
+    }
+}
+
+//
+// Prints a latency percentile line in microseconds.
+//
+void
+PrintLatency(
+    const char* p_Name,
+    const std::vector<uint64_t>& p_Counts)
+{
+    const double percentiles[] = { 50.0, 90.0, 99.0, 99.9, 99.99, 100.0 };
+
+    std::printf("%-12s", p_Name);
+
+    for (const double percentile : percentiles)
+    {
+        std::printf(" %11.1f", LatencyHistogram::GetValueAtPercentile(p_Counts, percentile) / 1000.0);
+    }
+
+    std::printf("\n");
+}
+
+//
+// Prints the results of a run.
+//
+void
+PrintResult(
+    const BenchmarkConfiguration& p_Configuration,
+    const char* p_ServerName,
+    const BenchmarkResult& p_Result)
+{
+    const double durationSeconds = std::chrono::duration<double>(p_Result.m_Duration).count();
+
+    std::printf(
+        "server=%s transport=%s model=%s threads=%u connections=%u %s=%llu payload=%u checksum=%s deadline=%ums duration=%us warmup=%us\n",
+        p_ServerName,
+        p_Configuration.m_UnixSocketPath.empty() ? "tcp" : "unix",
+        p_Configuration.m_LoadModel == LoadModel::OpenLoop ? "open" : "closed",
+        p_Configuration.m_NumberThreads,
+        p_Configuration.m_NumberConnections,
+        p_Configuration.m_LoadModel == LoadModel::OpenLoop ? "rate" : "pipeline",
+        p_Configuration.m_LoadModel == LoadModel::OpenLoop ?
+            static_cast<unsigned long long>(p_Configuration.m_RequestRate) :
+            static_cast<unsigned long long>(p_Configuration.m_PipelineDepth),
+        p_Configuration.m_PayloadSize,
+        p_Configuration.m_EnableChecksums ? "on" : "off",
+        p_Configuration.m_DeadlineMilliseconds,
+        p_Configuration.m_DurationSeconds,
+        p_Configuration.m_WarmupSeconds);
+
+    std::printf(
+        "responses=%llu failed=%llu throughput=%.0f req/s\n",
+        static_cast<unsigned long long>(p_Result.m_NumberResponses),
+        static_cast<unsigned long long>(p_Result.m_NumberFailedResponses),
+        p_Result.m_NumberResponses / durationSeconds);
+
+    std::printf("%-12s %11s %11s %11s %11s %11s %11s\n", "latency(us)", "p50", "p90", "p99", "p99.9", "p99.99", "max");
+    PrintLatency("corrected", p_Result.m_Latency);
+    PrintLatency("service", p_Result.m_ServiceLatency);
+    std::printf("\n");
+}
+
+//
+// Parses the command line into the configuration. Returns false on invalid arguments.
+//
+bool
+ParseArguments(
+    const int p_NumberArguments,
+    char** p_Arguments,
+    BenchmarkConfiguration& p_Configuration)
+{
+    for (int argumentIndex = 1; argumentIndex < p_NumberArguments; ++argumentIndex)
+    {
+        const std::string argument = p_Arguments[argumentIndex];
+        const size_t separator = argument.find('=');
+
+        if (argument.rfind("--", 0) != 0 ||
+            separator == std::string::npos)
+        {
+            return false;
+        }
+
+        const std::string name = argument.substr(2, separator - 2);
+        const std::string value = argument.substr(separator + 1);
+
+        try
+        {
+            if (name == "host")
+            {
+                p_Configuration.m_Host = value;
+            }
+            else if (name == "port")
+            {
+                p_Configuration.m_Port = std::stoul(value);
+            }
+            else if (name == "unix-socket")
+            {
+                p_Configuration.m_UnixSocketPath = value;
+            }
+            else if (name == "threads")
+            {
+                p_Configuration.m_NumberThreads = static_cast<uint16_t>(std::stoul(value));
+            }
+            else if (name == "connections")
+            {
+                p_Configuration.m_NumberConnections = static_cast<uint16_t>(std::stoul(value));
+            }
+            else if (name == "mode" && (value == "open" || value == "closed"))
+            {
+                p_Configuration.m_LoadModel = value == "open" ? LoadModel::OpenLoop : LoadModel::ClosedLoop;
+            }
+            else if (name == "rate")
+            {
+                p_Configuration.m_RequestRate = std::stoull(value);
+            }
+            else if (name == "pipeline")
+            {
+                p_Configuration.m_PipelineDepth = static_cast<uint16_t>(std::max(1ul, std::stoul(value)));
+            }
+            else if (name == "payload")
+            {
+                p_Configuration.m_PayloadSize = std::stoul(value);
+            }
+            else if (name == "duration")
+            {
+                p_Configuration.m_DurationSeconds = std::stoul(value);
+            }
+            else if (name == "warmup")
+            {
+                p_Configuration.m_WarmupSeconds = std::stoul(value);
+            }
+            else if (name == "tags")
+            {
+                //
+                // Comma-separated list of tag[:weight] entries.
+                //
+                p_Configuration.m_PacketTagMix.clear();
+                size_t entryStart = 0;
+
+                while (entryStart <= value.size())
+                {
+                    const size_t entryEnd = std::min(value.find(',', entryStart), value.size());
+                    const std::string entry = value.substr(entryStart, entryEnd - entryStart);
+                    const size_t weightSeparator = entry.find(':');
+
+                    p_Configuration.m_PacketTagMix.emplace_back(
+                        static_cast<PacketTag>(std::stoul(entry.substr(0, weightSeparator))),
+                        weightSeparator == std::string::npos ? 1u : static_cast<uint32_t>(std::stoul(entry.substr(weightSeparator + 1))));
+
+                    entryStart = entryEnd + 1;
+                }
+            }
+            else if (name == "server")
+            {
+                //
+                // In-process server backends to run against in turn: epoll, iouring or both.
+                //
+                p_Configuration.m_EmbeddedServerBackends.clear();
+
+                if (value == "epoll" || value == "both")
+                {
+                    p_Configuration.m_EmbeddedServerBackends.push_back(IoBackend::Epoll);
+                }
+
+                if (value == "iouring" || value == "both")
+                {
+                    p_Configuration.m_EmbeddedServerBackends.push_back(IoBackend::IoUring);
+                }
+
+                if (p_Configuration.m_EmbeddedServerBackends.empty())
+                {
+                    return false;
+                }
+            }
+            else if (name == "server-threads")
+            {
+                p_Configuration.m_EmbeddedServerThreadPoolSize = static_cast<uint16_t>(std::stoul(value));
+            }
+            else if (name == "checksum" && (value == "on" || value == "off"))
+            {
+                p_Configuration.m_EnableChecksums = value == "on";
+            }
+            else if (name == "deadline")
+            {
+                p_Configuration.m_DeadlineMilliseconds = std::stoul(value);
+            }
+            else if (name == "io-cpus" || name == "worker-cpus")
+            {
+                std::vector<uint16_t>& cpus = name == "io-cpus" ?
+                    p_Configuration.m_EmbeddedServerIoThreadCpus :
+                    p_Configuration.m_EmbeddedServerWorkerThreadCpus;
+
+                if (Status::Failed(CpuTopology::ParseCpuList(value, cpus)))
+                {
+                    return false;
+                }
+            }
+            else if (name == "execution")
+            {
+                if (value == "pooled")
+                {
+                    p_Configuration.m_EmbeddedServerExecutionMode = EndpointExecutionMode::Pooled;
+                }
+                else if (value == "inline")
+                {
+                    p_Configuration.m_EmbeddedServerExecutionMode = EndpointExecutionMode::Inline;
+                }
+                else
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                return false;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//
+// Echo endpoint served by the in-process servers.
+//
+StatusCode
+EchoEndpoint(
+    std::string_view p_Packet,
+    ResponseWriter& p_Response)
+{
+    return p_Response.Append(p_Packet);
+}
+
+} // namespace gX.
+
+int main(int argc, char** argv)
+{
+    gX::BenchmarkConfiguration configuration;
+
+    if (!gX::ParseArguments(argc, argv, configuration))
+    {
+        std::cerr <<
+            "Usage: gxbench [--host=H] [--port=P] [--unix-socket=PATH] [--threads=N] [--connections=N]\n"
+            "               [--mode=closed|open] [--pipeline=N] [--rate=REQ_PER_S]\n"
+            "               [--payload=BYTES] [--tags=TAG[:WEIGHT],...]\n"
+            "               [--duration=S] [--warmup=S]\n"
+            "               [--server=epoll|iouring|both] [--server-threads=N]\n"
+            "               [--execution=pooled|inline] [--checksum=on|off] [--deadline=MS]\n"
+            "               [--io-cpus=CPULIST] [--worker-cpus=CPULIST]\n";
+
+        return 1;
+    }
+
+    if (configuration.m_EmbeddedServerBackends.empty())
+    {
+        gX::BenchmarkResult result;
+        gX::LoadGenerator loadGenerator(configuration);
+
+        const gX::StatusCode status = loadGenerator.Run(result);
+
+        if (gX::Status::Failed(status))
+        {
+            std::cerr << "Benchmark failed with status 0x" << std::hex << status << std::endl;
+
+            return 1;
+        }
+
+        gX::PrintResult(configuration, "external", result);
+
+        return 0;
+    }
+
+    //
+    // Run the same load against an in-process server for each backend, one after the other,
+    // so that their results are directly comparable.
+    //
+    for (const gX::IoBackend backend : configuration.m_EmbeddedServerBackends)
+    {
+        gX::BenchmarkResult result;
+        gX::StatusCode status;
+
+        {
+            gX::DataTransmissionServerConfiguration serverConfiguration;
+            serverConfiguration.m_Port = configuration.m_Port;
+            serverConfiguration.m_UnixSocketPath = configuration.m_UnixSocketPath;
+            serverConfiguration.m_IoBackend = backend;
+            serverConfiguration.m_BlockingExecution = false;
+            serverConfiguration.m_MaxNumberAllowedConnections = std::max<uint16_t>(configuration.m_NumberConnections, serverConfiguration.m_MaxNumberAllowedConnections);
+
+            if (configuration.m_EmbeddedServerThreadPoolSize != 0)
+            {
+                serverConfiguration.m_ThreadPoolSize = configuration.m_EmbeddedServerThreadPoolSize;
+            }
+
+            serverConfiguration.m_IoThreadCpus = configuration.m_EmbeddedServerIoThreadCpus;
+            serverConfiguration.m_WorkerThreadCpus = configuration.m_EmbeddedServerWorkerThreadCpus;
+
+            for (const auto& [packetTag, weight] : configuration.m_PacketTagMix)
+            {
+                serverConfiguration.m_PacketTagResolverTable[packetTag] = gX::Endpoint::Bind<&gX::EchoEndpoint>(configuration.m_EmbeddedServerExecutionMode);
+            }
+
+            gX::DataTransmissionServer server("gxbench");
+            status = server.Init(&serverConfiguration);
+
+            if (gX::Status::Succeeded(status))
+            {
+                server.Run();
+
+                gX::LoadGenerator loadGenerator(configuration);
+                status = loadGenerator.Run(result);
+            }
+        }
+
+        if (gX::Status::Failed(status))
+        {
+            std::cerr << "Benchmark failed with status 0x" << std::hex << status << std::endl;
+
+            return 1;
+        }
+
+        gX::PrintResult(configuration, backend == gX::IoBackend::IoUring ? "iouring" : "epoll", result);
+    }
+
+    return 0;
+}
@@ -0,0 +1,410 @@
+// *************************************
+// Ganymede Xpedia
+// Benchmarks
+// 'gXMicroBench.cc'
+// Author: jcjuarez
+// *************************************
+
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include <iostream>
+#include "gXThreadPool.hh"
+#include "gXCrc32c.hh"
+#include "gXLatencyHistogram.hh"
+
+namespace gX
+{
+
+//
+// Configurations for the thread pool microbenchmarks.
+//
+struct MicroBenchmarkConfiguration
+{
+
+    //
+    // Constructor.
+    //
+    MicroBenchmarkConfiguration();
+
+    //
+    // Thread counts to measure.
+    //
+    std::vector<uint16_t> m_ThreadCounts;
+
+    //
+    // Number of tasks submitted by each throughput measurement.
+    //
+    uint32_t m_NumberTasks;
+
+    //
+    // Number of round trips timed by each dispatch overhead measurement.
+    //
+    uint32_t m_NumberRoundTrips;
+
+    //
+    // Number of tasks submitted per EnqueueBatch call by the batched throughput measurement.
+    //
+    uint32_t m_BatchSize;
+
+    //
+    // Default number of tasks.
+    //
+    static constexpr uint32_t c_DefaultNumberTasks = 200000u;
+
+    //
+    // Default number of round trips.
+    //
+    static constexpr uint32_t c_DefaultNumberRoundTrips = 20000u;
+
+    //
+    // Default batch size.
+    //
+    static constexpr uint32_t c_DefaultBatchSize = 16u;
+
+};
+
+MicroBenchmarkConfiguration::MicroBenchmarkConfiguration()
+    : m_ThreadCounts { 1u, 2u, 4u, 8u },
+      m_NumberTasks(c_DefaultNumberTasks),
+      m_NumberRoundTrips(c_DefaultNumberRoundTrips),
+      m_BatchSize(c_DefaultBatchSize)
+{}
+
+//
+// Measures how many tasks per second EnqueueTask schedules and executes, waiting on every returned future.
+//
+double
+MeasureEnqueueTaskThroughput(
+    ThreadPool& p_ThreadPool,
+    const uint32_t p_NumberTasks)
+{
+    std::vector<std::future<uint32_t>> results;
+    results.reserve(p_NumberTasks);
+
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    for (uint32_t taskIndex = 0; taskIndex < p_NumberTasks; ++taskIndex)
+    {
+        std::optional<std::future<uint32_t>> result = p_ThreadPool.EnqueueTask(
+            [](const uint32_t p_Value)
+            {
+                return p_Value;
+            },
+            taskIndex);
+
+        if (result.has_value())
+        {
+            results.emplace_back(std::move(result.value()));
+        }
+    }
+
+    for (std::future<uint32_t>& result : results)
+    {
+        result.get();
+    }
+
+    return results.size() / std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+//
+// Measures how many tasks per second Post schedules and executes.
+//
+double
+MeasurePostThroughput(
+    ThreadPool& p_ThreadPool,
+    const uint32_t p_NumberTasks)
+{
+    std::atomic<uint32_t> numberExecutedTasks(0);
+    uint32_t numberPostedTasks = 0;
+
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    for (uint32_t taskIndex = 0; taskIndex < p_NumberTasks; ++taskIndex)
+    {
+        const StatusCode status = p_ThreadPool.Post(
+            [](std::atomic<uint32_t>* p_NumberExecutedTasks)
+            {
+                p_NumberExecutedTasks->fetch_add(1, std::memory_order_relaxed);
+            },
+            &numberExecutedTasks);
+
+        numberPostedTasks += Status::Succeeded(status) ? 1u : 0u;
+    }
+
+    while (numberExecutedTasks.load(std::memory_order_relaxed) != numberPostedTasks)
+    {
+        std::this_thread::yield();
+    }
+
+    return numberPostedTasks / std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+//
+// Measures how many tasks per second EnqueueBatch schedules and executes, submitting them in batches of the specified size.
+//
+double
+MeasureBatchThroughput(
+    ThreadPool& p_ThreadPool,
+    const uint32_t p_NumberTasks,
+    const uint32_t p_BatchSize)
+{
+    std::atomic<uint32_t> numberExecutedTasks(0);
+    uint32_t numberEnqueuedTasks = 0;
+    ThreadPoolBatch batch;
+
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    for (uint32_t taskIndex = 0; taskIndex < p_NumberTasks; taskIndex += p_BatchSize)
+    {
+        for (uint32_t batchIndex = 0; batchIndex < p_BatchSize && taskIndex + batchIndex < p_NumberTasks; ++batchIndex)
+        {
+            batch.Add(
+                0u,
+                [](std::atomic<uint32_t>* p_NumberExecutedTasks)
+                {
+                    p_NumberExecutedTasks->fetch_add(1, std::memory_order_relaxed);
+                },
+                &numberExecutedTasks);
+        }
+
+        size_t numberBatchTasks;
+        p_ThreadPool.EnqueueBatch(batch, numberBatchTasks);
+        numberEnqueuedTasks += static_cast<uint32_t>(numberBatchTasks);
+
+        batch.Clear();
+    }
+
+    while (numberExecutedTasks.load(std::memory_order_relaxed) != numberEnqueuedTasks)
+    {
+        std::this_thread::yield();
+    }
+
+    return numberEnqueuedTasks / std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+//
+// Times single tasks from submission until a worker starts running them, one at a time, which isolates
+// the hand-off cost (queueing, wakeup and scheduling) from the task itself. The values are in nanoseconds.
+//
+std::vector<uint64_t>
+MeasureDispatchOverhead(
+    ThreadPool& p_ThreadPool,
+    const uint32_t p_NumberRoundTrips)
+{
+    LatencyHistogram histogram;
+
+    for (uint32_t roundTripIndex = 0; roundTripIndex < p_NumberRoundTrips; ++roundTripIndex)
+    {
+        std::atomic<int64_t> executionStartTime(0);
+        const std::chrono::steady_clock::time_point submitTime = std::chrono::steady_clock::now();
+
+        const StatusCode status = p_ThreadPool.Post(
+            [](std::atomic<int64_t>* p_ExecutionStartTime)
+            {
+                p_ExecutionStartTime->store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_release);
+            },
+            &executionStartTime);
+
+        if (Status::Failed(status))
+        {
+            continue;
+        }
+
+        int64_t startTicks;
+
+        while ((startTicks = executionStartTime.load(std::memory_order_acquire)) == 0)
+        {
+            //
+            // Yield rather than spin so that the worker gets the core when there are fewer cores than threads.
+            //
+            std::this_thread::yield();
+        }
+
+        histogram.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(startTicks)) - submitTime).count());
+    }
+
+    std::vector<uint64_t> counts(LatencyHistogram::c_NumberBuckets, 0u);
+    histogram.MergeInto(counts);
+
+    return counts;
+}
+
+//
+// Measures how many gigabytes per second the specified checksum function covers over buffers of the specified size.
+//
+double
+MeasureChecksumThroughput(
+    uint32_t (*p_Checksum)(const Byte*, const size_t, const uint32_t),
+    const size_t p_BufferSize)
+{
+    std::vector<Byte> buffer(p_BufferSize);
+
+    for (size_t byteIndex = 0; byteIndex < buffer.size(); ++byteIndex)
+    {
+        buffer[byteIndex] = static_cast<Byte>(byteIndex * 31u);
+    }
+
+    //
+    // Cover the same number of bytes at every size, and chain the checksums so that no call can be elided.
+    //
+    constexpr size_t numberBytesPerMeasurement = 256u << 20;
+    const size_t numberIterations = std::max<size_t>(1u, numberBytesPerMeasurement / p_BufferSize);
+    uint32_t checksum = 0;
+
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    for (size_t iteration = 0; iteration < numberIterations; ++iteration)
+    {
+        checksum = p_Checksum(buffer.data(), buffer.size(), checksum);
+    }
+
+    const double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    //
+    // Store the chained checksum into a volatile and read it back, both observable accesses, so that the
+    // loop producing it cannot be removed.
+    //
+    volatile uint32_t checksumSink = checksum;
+    static_cast<void>(checksumSink);
+
+    return numberIterations * p_BufferSize / elapsedSeconds / 1e9;
+}
+
+//
+// Parses the command line into the configuration. Returns false on invalid arguments.
+//
+bool
+ParseArguments(
+    const int p_NumberArguments,
+    char** p_Arguments,
+    MicroBenchmarkConfiguration& p_Configuration)
+{
+    for (int argumentIndex = 1; argumentIndex < p_NumberArguments; ++argumentIndex)
+    {
+        const std::string argument = p_Arguments[argumentIndex];
+        const size_t separator = argument.find('=');
+
+        if (argument.rfind("--", 0) != 0 ||
+            separator == std::string::npos)
+        {
+            return false;
+        }
+
+        const std::string name = argument.substr(2, separator - 2);
+        const std::string value = argument.substr(separator + 1);
+
+        try
+        {
+            if (name == "threads")
+            {
+                //
+                // Comma-separated list of thread counts.
+                //
+                p_Configuration.m_ThreadCounts.clear();
+                size_t entryStart = 0;
+
+                while (entryStart <= value.size())
+                {
+                    const size_t entryEnd = std::min(value.find(',', entryStart), value.size());
+                    p_Configuration.m_ThreadCounts.push_back(static_cast<uint16_t>(std::stoul(value.substr(entryStart, entryEnd - entryStart))));
+                    entryStart = entryEnd + 1;
+                }
+            }
+            else if (name == "tasks")
+            {
+                p_Configuration.m_NumberTasks = std::stoul(value);
+            }
+            else if (name == "round-trips")
+            {
+                p_Configuration.m_NumberRoundTrips = std::stoul(value);
+            }
+            else if (name == "batch")
+            {
+                p_Configuration.m_BatchSize = std::max(1ul, std::stoul(value));
+            }
+            else
+            {
+                return false;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace gX.
+
+int main(int argc, char** argv)
+{
+    gX::MicroBenchmarkConfiguration configuration;
+
+    if (!gX::ParseArguments(argc, argv, configuration))
+    {
+        std::cerr << "Usage: gxmicrobench [--threads=N,...] [--tasks=N] [--round-trips=N] [--batch=N]\n";
+
+        return 1;
+    }
+
+    std::printf("tasks=%u round-trips=%u batch=%u\n", configuration.m_NumberTasks, configuration.m_NumberRoundTrips, configuration.m_BatchSize);
+    std::printf(
+        "%-13s %7s %16s %13s %14s %16s %16s\n",
+        "scheduler", "threads", "enqueue(task/s)", "post(task/s)", "batch(task/s)", "dispatch p50(ns)", "dispatch p99(ns)");
+
+    for (const gX::ThreadPoolScheduler scheduler : { gX::ThreadPoolScheduler::SharedQueue, gX::ThreadPoolScheduler::WorkStealing })
+    {
+        for (const uint16_t numberThreads : configuration.m_ThreadCounts)
+        {
+            gX::ThreadPool threadPool;
+
+            if (gX::Status::Failed(threadPool.Init(numberThreads, scheduler)))
+            {
+                std::cerr << "Thread pool initialization failed." << std::endl;
+
+                return 1;
+            }
+
+            const double enqueueThroughput = gX::MeasureEnqueueTaskThroughput(threadPool, configuration.m_NumberTasks);
+            const double postThroughput = gX::MeasurePostThroughput(threadPool, configuration.m_NumberTasks);
+            const double batchThroughput = gX::MeasureBatchThroughput(threadPool, configuration.m_NumberTasks, configuration.m_BatchSize);
+            const std::vector<uint64_t> dispatchOverhead = gX::MeasureDispatchOverhead(threadPool, configuration.m_NumberRoundTrips);
+
+            std::printf(
+                "%-13s %7u %16.0f %13.0f %14.0f %16llu %16llu\n",
+                scheduler == gX::ThreadPoolScheduler::SharedQueue ? "shared-queue" : "work-stealing",
+                numberThreads,
+                enqueueThroughput,
+                postThroughput,
+                batchThroughput,
+                static_cast<unsigned long long>(gX::LatencyHistogram::GetValueAtPercentile(dispatchOverhead, 50.0)),
+                static_cast<unsigned long long>(gX::LatencyHistogram::GetValueAtPercentile(dispatchOverhead, 99.0)));
+        }
+    }
+
+    //
+    // Checksum throughput up to the default maximum packet size, the most a single frame carries.
+    //
+    std::printf("\n%-13s %16s %16s\n", "checksum(B)", "crc32c(GB/s)", "table(GB/s)");
+
+    for (const size_t bufferSize : { 64u, 1024u, 16384u, 1048576u })
+    {
+        std::printf(
+            "%-13zu %16.2f %16.2f\n",
+            bufferSize,
+            gX::MeasureChecksumThroughput(&gX::Crc32c::Compute, bufferSize),
+            gX::MeasureChecksumThroughput(&gX::Crc32c::ComputeSoftware, bufferSize));
+    }
+
+    std::printf("hardware crc32c: %s\n", gX::Crc32c::IsHardwareAccelerated() ? "yes" : "no");
+
+    return 0;
+}
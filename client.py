@@ -1,30 +1,52 @@
 import socket
+import struct
+
+# DTP frame header: magic, version, flags, packet tag, payload size (network byte order).
+FRAME_HEADER_FORMAT = '!HBBII'
+FRAME_MAGIC = 0x6758
+FRAME_VERSION = 1
+
+# DTP response header: frame header followed by the status code.
+RESPONSE_HEADER_FORMAT = FRAME_HEADER_FORMAT + 'I'
+
+def recv_exact(client_socket, size):
+    data = b''
+    while len(data) < size:
+        chunk = client_socket.recv(size - len(data))
+        if not chunk:
+            raise socket.error("Connection closed by server")
+        data += chunk
+    return data
 
 def tcp_client():
     # Define server address and port
     SERVER_ADDRESS = 'localhost'
     SERVER_PORT = 9090
-    
+    PACKET_TAG = 0
+
     # Create a TCP socket
     client_socket = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
-    
+
     try:
         # Connect to the server
         client_socket.connect((SERVER_ADDRESS, SERVER_PORT))
         print(f"Connected to server {SERVER_ADDRESS} on port {SERVER_PORT}")
-        
-        # Send data to the server
-        message = "Hello, New Server :DDDD!"
-        client_socket.sendall(message.encode('utf-8'))
+
+        # Send a DTP frame to the server
+        message = "Hello, New Server :DDDD!".encode('utf-8')
+        header = struct.pack(FRAME_HEADER_FORMAT, FRAME_MAGIC, FRAME_VERSION, 0, PACKET_TAG, len(message))
+        client_socket.sendall(header + message)
         print(f"Sent: {message}")
-        
-        # Receive data from the server
-        response = client_socket.recv(1024)
-        print("Received from server:", response.decode('utf-8'))
-    
+
+        # Receive the response frame from the server
+        response = recv_exact(client_socket, struct.calcsize(RESPONSE_HEADER_FORMAT))
+        _, _, _, tag, payload_size, status = struct.unpack(RESPONSE_HEADER_FORMAT, response)
+        payload = recv_exact(client_socket, payload_size)
+        print(f"Received from server: tag={tag} status={status:#010x} payload={payload}")
+
     except socket.error as e:
         print(f"Socket error: {e}")
-    
+
     finally:
         # Close the connection
         client_socket.close()
@@ -0,0 +1,498 @@
+// *************************************
+// Ganymede Xpedia
+// Common
+// 'gXAsyncEventLoop.cc'
+// Author: jcjuarez
+// *************************************
+
+#include <vector>
+#include <algorithm>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+#include "gXAsyncEventLoop.hh"
+
+namespace gX
+{
+
+AsyncEventLoop::ReadinessAwaiter::ReadinessAwaiter(
+    AsyncEventLoop* p_AsyncEventLoop,
+    const FileDescriptor p_Handle,
+    const uint32_t p_Events)
+    : Waiter { nullptr, Status::Success, 0u },
+      m_AsyncEventLoop(p_AsyncEventLoop),
+      m_Handle(p_Handle),
+      m_Events(p_Events)
+{}
+
+bool
+AsyncEventLoop::ReadinessAwaiter::await_ready() const noexcept
+{
+    return false;
+}
+
+bool
+AsyncEventLoop::ReadinessAwaiter::await_suspend(
+    std::coroutine_handle<> p_Coroutine)
+{
+    m_Coroutine = p_Coroutine;
+
+    return m_AsyncEventLoop->AddReadinessWaiter(this);
+}
+
+StatusCode
+AsyncEventLoop::ReadinessAwaiter::await_resume() const noexcept
+{
+    return m_Status;
+}
+
+AsyncEventLoop::TimerAwaiter::TimerAwaiter(
+    AsyncEventLoop* p_AsyncEventLoop,
+    const std::chrono::steady_clock::time_point p_Deadline)
+    : Waiter { nullptr, Status::Success, 0u },
+      m_AsyncEventLoop(p_AsyncEventLoop),
+      m_Deadline(p_Deadline)
+{}
+
+bool
+AsyncEventLoop::TimerAwaiter::await_ready() const noexcept
+{
+    return false;
+}
+
+bool
+AsyncEventLoop::TimerAwaiter::await_suspend(
+    std::coroutine_handle<> p_Coroutine)
+{
+    m_Coroutine = p_Coroutine;
+
+    return m_AsyncEventLoop->AddTimerWaiter(this);
+}
+
+StatusCode
+AsyncEventLoop::TimerAwaiter::await_resume() const noexcept
+{
+    return m_Status;
+}
+
+AsyncEventLoop::AsyncEventLoop()
+    : m_WakeupHandle(-1),
+      m_ThreadPool(nullptr),
+      m_TimerWheel(c_TimerResolution, std::chrono::steady_clock::now()),
+      m_WakeupTime(std::chrono::steady_clock::time_point::min()),
+      m_IsStopped(true)
+{}
+
+AsyncEventLoop::~AsyncEventLoop()
+{
+    Stop();
+
+    if (m_WakeupHandle >= 0)
+    {
+        close(m_WakeupHandle);
+    }
+}
+
+StatusCode
+AsyncEventLoop::Init(
+    ThreadPool* p_ThreadPool)
+{
+    if (m_EventLoopThreadHandle.joinable())
+    {
+        return Status::AlreadyInitialized;
+    }
+
+    StatusCode status = m_EventLoop.Init();
+
+    if (Status::Failed(status))
+    {
+        return status;
+    }
+
+    if ((m_WakeupHandle = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0)
+    {
+        return Status::EventLoopCreationFailed;
+    }
+
+    //
+    // The wakeup handle is told apart from sockets by its context pointing at itself.
+    //
+    status = m_EventLoop.Register(m_WakeupHandle, EPOLLIN, &m_WakeupHandle);
+
+    if (Status::Failed(status))
+    {
+        return status;
+    }
+
+    m_ThreadPool = p_ThreadPool;
+    m_IsStopped = false;
+
+    try
+    {
+        m_EventLoopThreadHandle = std::thread(&AsyncEventLoop::Run, this);
+    }
+    catch (const std::system_error& exception)
+    {
+        m_IsStopped = true;
+
+        return Status::ThreadLaunchFailed;
+    }
+
+    return Status::Success;
+}
+
+void
+AsyncEventLoop::Stop()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_Lock);
+
+        if (m_IsStopped)
+        {
+            return;
+        }
+
+        m_IsStopped = true;
+    }
+
+    Wakeup();
+
+    if (m_EventLoopThreadHandle.joinable())
+    {
+        m_EventLoopThreadHandle.join();
+    }
+
+    //
+    // Nothing else removes waiters now; hand every pending one back with the stop status.
+    //
+    std::vector<Waiter*> waiters;
+
+    {
+        std::unique_lock<std::mutex> lock(m_Lock);
+
+        for (const auto& [handle, awaiter] : m_ReadinessWaiters)
+        {
+            m_EventLoop.Unregister(handle);
+            waiters.push_back(awaiter);
+        }
+
+        m_TimerWheel.CancelAll(
+            [&waiters](TimerWheel::Timer& p_Timer)
+            {
+                waiters.push_back(static_cast<TimerAwaiter*>(p_Timer.m_Context));
+            });
+
+        m_ReadinessWaiters.clear();
+    }
+
+    for (Waiter* waiter : waiters)
+    {
+        waiter->m_Status = Status::ServiceIsStopped;
+        Resume(waiter);
+    }
+}
+
+AsyncEventLoop::ReadinessAwaiter
+AsyncEventLoop::WaitReadable(
+    const FileDescriptor p_Handle)
+{
+    return ReadinessAwaiter(this, p_Handle, EPOLLIN | EPOLLRDHUP);
+}
+
+AsyncEventLoop::ReadinessAwaiter
+AsyncEventLoop::WaitWritable(
+    const FileDescriptor p_Handle)
+{
+    return ReadinessAwaiter(this, p_Handle, EPOLLOUT);
+}
+
+AsyncEventLoop::TimerAwaiter
+AsyncEventLoop::SleepFor(
+    const std::chrono::steady_clock::duration p_Duration)
+{
+    return TimerAwaiter(this, std::chrono::steady_clock::now() + p_Duration);
+}
+
+AsyncEventLoop::TimerAwaiter
+AsyncEventLoop::SleepUntil(
+    const std::chrono::steady_clock::time_point p_Deadline)
+{
+    return TimerAwaiter(this, p_Deadline);
+}
+
+Task<StatusCode>
+AsyncEventLoop::Receive(
+    const FileDescriptor p_Handle,
+    Byte* p_Data,
+    const size_t p_Size,
+    size_t& p_NumberReceivedBytes)
+{
+    FOREVER
+    {
+        const ssize_t receiveResult = recv(p_Handle, p_Data, p_Size, 0);
+
+        if (receiveResult >= 0)
+        {
+            p_NumberReceivedBytes = static_cast<size_t>(receiveResult);
+
+            co_return Status::Success;
+        }
+
+        if (errno == EINTR)
+        {
+            continue;
+        }
+
+        if (errno != EAGAIN &&
+            errno != EWOULDBLOCK)
+        {
+            co_return Status::ConnectionLost;
+        }
+
+        const StatusCode status = co_await WaitReadable(p_Handle);
+
+        if (Status::Failed(status))
+        {
+            co_return status;
+        }
+    }
+}
+
+Task<StatusCode>
+AsyncEventLoop::Send(
+    const FileDescriptor p_Handle,
+    const Byte* p_Data,
+    const size_t p_Size)
+{
+    size_t offset = 0;
+
+    while (offset < p_Size)
+    {
+        const ssize_t sendResult = send(p_Handle, p_Data + offset, p_Size - offset, MSG_NOSIGNAL);
+
+        if (sendResult >= 0)
+        {
+            offset += static_cast<size_t>(sendResult);
+
+            continue;
+        }
+
+        if (errno == EINTR)
+        {
+            continue;
+        }
+
+        if (errno != EAGAIN &&
+            errno != EWOULDBLOCK)
+        {
+            co_return Status::ConnectionLost;
+        }
+
+        const StatusCode status = co_await WaitWritable(p_Handle);
+
+        if (Status::Failed(status))
+        {
+            co_return status;
+        }
+    }
+
+    co_return Status::Success;
+}
+
+void
+AsyncEventLoop::Run()
+{
+    std::vector<Waiter*> readyWaiters;
+
+    while (!m_IsStopped)
+    {
+        int32_t timeoutMilliseconds;
+
+        {
+            std::unique_lock<std::mutex> lock(m_Lock);
+
+            const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+            m_WakeupTime = std::min(m_TimerWheel.GetNextExpiryTime(), now + std::chrono::milliseconds(c_MaxWaitMilliseconds));
+
+            //
+            // Round up so that the loop never wakes up just before the timer it sleeps for.
+            //
+            timeoutMilliseconds = static_cast<int32_t>(std::clamp<int64_t>(
+                std::chrono::ceil<std::chrono::milliseconds>(m_WakeupTime - now).count(),
+                0,
+                c_MaxWaitMilliseconds));
+        }
+
+        const int32_t numberEvents = m_EventLoop.Wait(timeoutMilliseconds);
+
+        {
+            std::unique_lock<std::mutex> lock(m_Lock);
+
+            m_WakeupTime = std::chrono::steady_clock::time_point::min();
+
+            for (int32_t eventIndex = 0; eventIndex < numberEvents; ++eventIndex)
+            {
+                void* context = m_EventLoop.GetEventContext(eventIndex);
+
+                if (context == &m_WakeupHandle)
+                {
+                    eventfd_t value;
+                    eventfd_read(m_WakeupHandle, &value);
+
+                    continue;
+                }
+
+                //
+                // The socket stays registered only for the duration of a single wait; errors and hang-ups
+                // also complete it, and surface on the next receive or send.
+                //
+                ReadinessAwaiter* awaiter = static_cast<ReadinessAwaiter*>(context);
+
+                m_EventLoop.Unregister(awaiter->m_Handle);
+                m_ReadinessWaiters.erase(awaiter->m_Handle);
+                readyWaiters.push_back(awaiter);
+            }
+
+            const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+            m_TimerWheel.Advance(
+                now,
+                [this, &readyWaiters, now](TimerWheel::Timer& p_Timer)
+                {
+                    TimerAwaiter* awaiter = static_cast<TimerAwaiter*>(p_Timer.m_Context);
+
+                    if (awaiter->m_Deadline > now)
+                    {
+                        //
+                        // Only for deadlines beyond the span of the wheel, which expire at its end.
+                        //
+                        m_TimerWheel.Schedule(p_Timer, awaiter->m_Deadline);
+
+                        return;
+                    }
+
+                    readyWaiters.push_back(awaiter);
+                });
+        }
+
+        for (Waiter* waiter : readyWaiters)
+        {
+            Resume(waiter);
+        }
+
+        readyWaiters.clear();
+    }
+}
+
+bool
+AsyncEventLoop::AddReadinessWaiter(
+    ReadinessAwaiter* p_Awaiter)
+{
+    p_Awaiter->m_PriorityClass = m_ThreadPool != nullptr ? m_ThreadPool->GetCurrentPriorityClass() : 0u;
+
+    std::unique_lock<std::mutex> lock(m_Lock);
+
+    if (m_IsStopped)
+    {
+        p_Awaiter->m_Status = Status::ServiceIsStopped;
+
+        return false;
+    }
+
+    if (!m_ReadinessWaiters.emplace(p_Awaiter->m_Handle, p_Awaiter).second)
+    {
+        //
+        // Another coroutine is already waiting on the socket.
+        //
+        p_Awaiter->m_Status = Status::EventLoopRegistrationFailed;
+
+        return false;
+    }
+
+    //
+    // Registering under the lock keeps the event from being handled before the waiter is recorded.
+    //
+    p_Awaiter->m_Status = m_EventLoop.Register(p_Awaiter->m_Handle, p_Awaiter->m_Events | EPOLLONESHOT, p_Awaiter);
+
+    if (Status::Failed(p_Awaiter->m_Status))
+    {
+        m_ReadinessWaiters.erase(p_Awaiter->m_Handle);
+
+        return false;
+    }
+
+    return true;
+}
+
+bool
+AsyncEventLoop::AddTimerWaiter(
+    TimerAwaiter* p_Awaiter)
+{
+    p_Awaiter->m_PriorityClass = m_ThreadPool != nullptr ? m_ThreadPool->GetCurrentPriorityClass() : 0u;
+    p_Awaiter->m_Timer.m_Context = p_Awaiter;
+
+    bool isWakeupNeeded;
+
+    {
+        std::unique_lock<std::mutex> lock(m_Lock);
+
+        if (m_IsStopped)
+        {
+            p_Awaiter->m_Status = Status::ServiceIsStopped;
+
+            return false;
+        }
+
+        m_TimerWheel.Schedule(p_Awaiter->m_Timer, p_Awaiter->m_Deadline);
+        isWakeupNeeded = m_TimerWheel.GetExpiryTime(p_Awaiter->m_Timer) < m_WakeupTime;
+    }
+
+    if (isWakeupNeeded)
+    {
+        //
+        // The event loop thread may be sleeping past the new deadline.
+        //
+        Wakeup();
+    }
+
+    return true;
+}
+
+void
+AsyncEventLoop::Resume(
+    Waiter* p_Waiter)
+{
+    //
+    // The waiter lives in the coroutine frame; read it before the coroutine can resume.
+    //
+    const std::coroutine_handle<> coroutine = p_Waiter->m_Coroutine;
+
+    if (m_ThreadPool == nullptr ||
+        Status::Failed(m_ThreadPool->PostWithPriority(p_Waiter->m_PriorityClass, &AsyncEventLoop::ResumeCoroutine, coroutine)))
+    {
+        //
+        // The pool is stopping or full; a suspended coroutine must not be dropped, so resume it here.
+        //
+        coroutine.resume();
+    }
+}
+
+void
+AsyncEventLoop::ResumeCoroutine(
+    std::coroutine_handle<> p_Coroutine)
+{
+    p_Coroutine.resume();
+}
+
+void
+AsyncEventLoop::Wakeup()
+{
+    if (m_WakeupHandle >= 0)
+    {
+        eventfd_write(m_WakeupHandle, 1u);
+    }
+}
+
+} // namespace gX.
@@ -0,0 +1,329 @@
+// *************************************
+// Ganymede Xpedia
+// Common
+// 'gXAsyncEventLoop.hh'
+// Author: jcjuarez
+// *************************************
+
+#ifndef GX_ASYNC_EVENT_LOOP_
+#define GX_ASYNC_EVENT_LOOP_
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cstddef>
+#include <cstdint>
+#include <coroutine>
+#include <unordered_map>
+#include "gXTask.hh"
+#include "gXStatus.hh"
+#include "gXEventLoop.hh"
+#include "gXThreadPool.hh"
+#include "gXTimerWheel.hh"
+
+namespace gX
+{
+
+//
+// Event loop for coroutines. Coroutines suspend on socket readiness or timers without holding a
+// thread, and are resumed on the thread pool, in the priority class they were running in, once the
+// socket is ready or the timer expires. Waits are served by a single dedicated thread; timers are kept
+// in a timer wheel embedded in the awaiters, so waiting never allocates.
+//
+class AsyncEventLoop
+{
+
+public:
+
+    //
+    // Suspended coroutine along with the outcome of its wait.
+    //
+    struct Waiter
+    {
+
+        //
+        // Coroutine to resume.
+        //
+        std::coroutine_handle<> m_Coroutine;
+
+        //
+        // Outcome of the wait; ServiceIsStopped if the event loop stopped before the wait completed.
+        //
+        StatusCode m_Status;
+
+        //
+        // Thread pool priority class the coroutine resumes in.
+        //
+        uint8_t m_PriorityClass;
+
+    };
+
+    //
+    // Awaiter suspending a coroutine until a socket is ready. Only one coroutine can wait on a socket at a time.
+    //
+    class ReadinessAwaiter : public Waiter
+    {
+
+    public:
+
+        //
+        // Constructor.
+        //
+        ReadinessAwaiter(
+            AsyncEventLoop* p_AsyncEventLoop,
+            const FileDescriptor p_Handle,
+            const uint32_t p_Events);
+
+        bool
+        await_ready() const noexcept;
+
+        bool
+        await_suspend(
+            std::coroutine_handle<> p_Coroutine);
+
+        StatusCode
+        await_resume() const noexcept;
+
+    private:
+
+        friend class AsyncEventLoop;
+
+        //
+        // Event loop serving the wait.
+        //
+        AsyncEventLoop* m_AsyncEventLoop;
+
+        //
+        // Socket waited on.
+        //
+        FileDescriptor m_Handle;
+
+        //
+        // Events waited for.
+        //
+        uint32_t m_Events;
+
+    };
+
+    //
+    // Awaiter suspending a coroutine until a point in time.
+    //
+    class TimerAwaiter : public Waiter
+    {
+
+    public:
+
+        //
+        // Constructor.
+        //
+        TimerAwaiter(
+            AsyncEventLoop* p_AsyncEventLoop,
+            const std::chrono::steady_clock::time_point p_Deadline);
+
+        bool
+        await_ready() const noexcept;
+
+        bool
+        await_suspend(
+            std::coroutine_handle<> p_Coroutine);
+
+        StatusCode
+        await_resume() const noexcept;
+
+    private:
+
+        friend class AsyncEventLoop;
+
+        //
+        // Event loop serving the wait.
+        //
+        AsyncEventLoop* m_AsyncEventLoop;
+
+        //
+        // Time the coroutine resumes at.
+        //
+        std::chrono::steady_clock::time_point m_Deadline;
+
+        //
+        // Timer of the wait, pointing back at the awaiter.
+        //
+        TimerWheel::Timer m_Timer;
+
+    };
+
+    //
+    // Constructor.
+    //
+    AsyncEventLoop();
+
+    //
+    // Destructor. Stops the event loop.
+    //
+    ~AsyncEventLoop();
+
+    //
+    // Initializes the event loop and starts its thread. Coroutines are resumed on the specified pool.
+    //
+    StatusCode
+    Init(
+        ThreadPool* p_ThreadPool);
+
+    //
+    // Stops the event loop. Coroutines still waiting are resumed with ServiceIsStopped, and later waits fail right away.
+    //
+    void
+    Stop();
+
+    //
+    // Waits until the non-blocking socket has data to read.
+    //
+    ReadinessAwaiter
+    WaitReadable(
+        const FileDescriptor p_Handle);
+
+    //
+    // Waits until the non-blocking socket can be written to.
+    //
+    ReadinessAwaiter
+    WaitWritable(
+        const FileDescriptor p_Handle);
+
+    //
+    // Waits for the specified duration.
+    //
+    TimerAwaiter
+    SleepFor(
+        const std::chrono::steady_clock::duration p_Duration);
+
+    //
+    // Waits until the specified point in time.
+    //
+    TimerAwaiter
+    SleepUntil(
+        const std::chrono::steady_clock::time_point p_Deadline);
+
+    //
+    // Receives up to the specified number of bytes from the non-blocking socket, suspending until some data
+    // arrives. Zero bytes received means the peer closed the connection.
+    //
+    Task<StatusCode>
+    Receive(
+        const FileDescriptor p_Handle,
+        Byte* p_Data,
+        const size_t p_Size,
+        size_t& p_NumberReceivedBytes);
+
+    //
+    // Sends all the data over the non-blocking socket, suspending whenever its send buffer is full.
+    //
+    Task<StatusCode>
+    Send(
+        const FileDescriptor p_Handle,
+        const Byte* p_Data,
+        const size_t p_Size);
+
+private:
+
+    //
+    // Waits for events and expired timers until the event loop is stopped.
+    //
+    void
+    Run();
+
+    //
+    // Registers a coroutine waiting on a socket. Returns false if the wait could not be started.
+    //
+    bool
+    AddReadinessWaiter(
+        ReadinessAwaiter* p_Awaiter);
+
+    //
+    // Registers a coroutine waiting on a timer. Returns false if the event loop is stopped.
+    //
+    bool
+    AddTimerWaiter(
+        TimerAwaiter* p_Awaiter);
+
+    //
+    // Hands a waiter over to the thread pool for resumption, resuming it right away if the pool rejects it.
+    //
+    void
+    Resume(
+        Waiter* p_Waiter);
+
+    //
+    // Resumes a coroutine.
+    //
+    static
+    void
+    ResumeCoroutine(
+        std::coroutine_handle<> p_Coroutine);
+
+    //
+    // Wakes the event loop thread up.
+    //
+    void
+    Wakeup();
+
+    //
+    // Reactor for socket readiness.
+    //
+    EventLoop m_EventLoop;
+
+    //
+    // Event file descriptor for waking the event loop thread up when the earliest timer changes or on stop.
+    //
+    FileDescriptor m_WakeupHandle;
+
+    //
+    // Thread pool coroutines are resumed on.
+    //
+    ThreadPool* m_ThreadPool;
+
+    //
+    // Thread of the event loop.
+    //
+    std::thread m_EventLoopThreadHandle;
+
+    //
+    // Exclusive lock for synchronizing access to the waiters.
+    //
+    std::mutex m_Lock;
+
+    //
+    // Coroutines waiting on sockets, by socket.
+    //
+    std::unordered_map<FileDescriptor, ReadinessAwaiter*> m_ReadinessWaiters;
+
+    //
+    // Timers of the coroutines waiting on them.
+    //
+    TimerWheel m_TimerWheel;
+
+    //
+    // Time the event loop thread sleeps until; the minimum time point while it is awake, since it looks at
+    // the timers again before going back to sleep. A timer expiring earlier has to wake the thread up.
+    //
+    std::chrono::steady_clock::time_point m_WakeupTime;
+
+    //
+    // Flag for stopping the event loop.
+    //
+    std::atomic<bool> m_IsStopped;
+
+    //
+    // Longest time the event loop thread sleeps without a timer to serve.
+    //
+    static constexpr int32_t c_MaxWaitMilliseconds = 1000;
+
+    //
+    // Resolution of the timers, matching the granularity of the reactor wait.
+    //
+    static constexpr std::chrono::milliseconds c_TimerResolution = std::chrono::milliseconds(1);
+
+};
+
+} // namespace gX.
+
+#endif
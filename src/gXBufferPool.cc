@@ -0,0 +1,268 @@
+// *************************************
+// Ganymede Xpedia
+// Common
+// 'gXBufferPool.cc'
+// Author: jcjuarez
+// *************************************
+
+#include <new>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include "gXBufferPool.hh"
+
+namespace gX
+{
+
+Buffer::Buffer(
+    BufferPool* p_Pool,
+    const uint32_t p_Capacity,
+    const bool p_IsPooled)
+    : m_ReferenceCount(1),
+      m_Pool(p_Pool),
+      m_Capacity(p_Capacity),
+      m_IsPooled(p_IsPooled)
+{}
+
+BufferReference::BufferReference()
+    : m_Buffer(nullptr)
+{}
+
+BufferReference::BufferReference(
+    Buffer* p_Buffer)
+    : m_Buffer(p_Buffer)
+{}
+
+BufferReference::BufferReference(
+    const BufferReference& p_Other)
+    : m_Buffer(p_Other.m_Buffer)
+{
+    if (m_Buffer != nullptr)
+    {
+        m_Buffer->m_ReferenceCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+BufferReference::BufferReference(
+    BufferReference&& p_Other) noexcept
+    : m_Buffer(std::exchange(p_Other.m_Buffer, nullptr))
+{}
+
+BufferReference::~BufferReference()
+{
+    Reset();
+}
+
+BufferReference&
+BufferReference::operator=(
+    const BufferReference& p_Other)
+{
+    if (this != &p_Other)
+    {
+        BufferReference copy(p_Other);
+        std::swap(m_Buffer, copy.m_Buffer);
+    }
+
+    return *this;
+}
+
+BufferReference&
+BufferReference::operator=(
+    BufferReference&& p_Other) noexcept
+{
+    if (this != &p_Other)
+    {
+        Reset();
+        m_Buffer = std::exchange(p_Other.m_Buffer, nullptr);
+    }
+
+    return *this;
+}
+
+BufferReference::operator bool() const
+{
+    return m_Buffer != nullptr;
+}
+
+Byte*
+BufferReference::GetData() const
+{
+    //
+    // The buffer memory is laid out right after its header.
+    //
+    return reinterpret_cast<Byte*>(m_Buffer + 1);
+}
+
+uint32_t
+BufferReference::GetCapacity() const
+{
+    return m_Buffer->m_Capacity;
+}
+
+bool
+BufferReference::IsShared() const
+{
+    return m_Buffer->m_ReferenceCount.load(std::memory_order_acquire) > 1;
+}
+
+bool
+BufferReference::IsPooled() const
+{
+    return m_Buffer->m_IsPooled;
+}
+
+void
+BufferReference::Reset()
+{
+    Buffer* buffer = std::exchange(m_Buffer, nullptr);
+
+    if (buffer != nullptr &&
+        buffer->m_ReferenceCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        buffer->m_Pool->Release(buffer);
+    }
+}
+
+BufferPool::BufferPool()
+    : m_BufferSize(0),
+      m_MaxNumberCachedBuffers(0),
+      m_SlabAllocator(nullptr)
+{}
+
+BufferPool::~BufferPool()
+{
+    for (Buffer* buffer : m_CachedBuffers)
+    {
+        Free(buffer);
+    }
+}
+
+StatusCode
+BufferPool::Init(
+    const uint32_t p_BufferSize,
+    const uint32_t p_MaxNumberCachedBuffers,
+    SlabAllocator* p_SlabAllocator)
+{
+    m_BufferSize = p_BufferSize;
+    m_MaxNumberCachedBuffers = p_MaxNumberCachedBuffers;
+    m_SlabAllocator = p_SlabAllocator;
+
+    try
+    {
+        m_CachedBuffers.reserve(m_MaxNumberCachedBuffers);
+    }
+    catch (const std::bad_alloc& e)
+    {
+        return Status::OutOfMemory;
+    }
+
+    return Status::Success;
+}
+
+BufferReference
+BufferPool::Acquire(
+    const uint32_t p_Size)
+{
+    if (p_Size > m_BufferSize)
+    {
+        //
+        // Oversized request; serve it with a dedicated buffer.
+        //
+        return BufferReference(Allocate(p_Size, false));
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(m_Lock);
+
+        if (!m_CachedBuffers.empty())
+        {
+            Buffer* buffer = m_CachedBuffers.back();
+            m_CachedBuffers.pop_back();
+            buffer->m_ReferenceCount.store(1, std::memory_order_relaxed);
+
+            return BufferReference(buffer);
+        }
+    }
+
+    return BufferReference(Allocate(m_BufferSize, true));
+}
+
+uint32_t
+BufferPool::GetBufferSize() const
+{
+    return m_BufferSize;
+}
+
+void
+BufferPool::Release(
+    Buffer* p_Buffer)
+{
+    if (p_Buffer->m_IsPooled)
+    {
+        std::unique_lock<std::mutex> lock(m_Lock);
+
+        if (m_CachedBuffers.size() < m_MaxNumberCachedBuffers)
+        {
+            m_CachedBuffers.push_back(p_Buffer);
+
+            return;
+        }
+    }
+
+    Free(p_Buffer);
+}
+
+Buffer*
+BufferPool::Allocate(
+    const uint32_t p_Capacity,
+    const bool p_IsPooled)
+{
+    if (m_SlabAllocator == nullptr)
+    {
+        void* memory = ::operator new(sizeof(Buffer) + p_Capacity, std::nothrow);
+
+        if (memory == nullptr)
+        {
+            return nullptr;
+        }
+
+        return new (memory) Buffer(this, p_Capacity, p_IsPooled);
+    }
+
+    void* memory = m_SlabAllocator->Allocate(sizeof(Buffer) + p_Capacity);
+
+    if (memory == nullptr)
+    {
+        return nullptr;
+    }
+
+    //
+    // Buffers get the whole block rather than leaving its tail unused: the header pushes a power-of-two
+    // buffer size into the next size class, and a growing frame fills its class before moving up.
+    //
+    const uint32_t capacity = static_cast<uint32_t>(std::min<size_t>(
+        SlabAllocator::GetBlockSize(sizeof(Buffer) + p_Capacity) - sizeof(Buffer),
+        std::numeric_limits<uint32_t>::max()));
+
+    return new (memory) Buffer(this, capacity, p_IsPooled);
+}
+
+void
+BufferPool::Free(
+    Buffer* p_Buffer)
+{
+    const size_t size = sizeof(Buffer) + p_Buffer->m_Capacity;
+
+    p_Buffer->~Buffer();
+
+    if (m_SlabAllocator == nullptr)
+    {
+        ::operator delete(p_Buffer);
+
+        return;
+    }
+
+    m_SlabAllocator->Free(p_Buffer, size);
+}
+
+} // namespace gX.
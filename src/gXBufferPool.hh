@@ -0,0 +1,261 @@
+// *************************************
+// Ganymede Xpedia
+// Common
+// 'gXBufferPool.hh'
+// Author: jcjuarez
+// *************************************
+
+#ifndef GX_BUFFER_POOL_
+#define GX_BUFFER_POOL_
+
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include "gXStatus.hh"
+#include "gXSlabAllocator.hh"
+
+namespace gX
+{
+
+class BufferPool;
+
+//
+// Reference counted memory block. Only accessible through buffer references.
+//
+class Buffer
+{
+
+    friend class BufferPool;
+    friend class BufferReference;
+
+    //
+    // Constructor.
+    //
+    Buffer(
+        BufferPool* p_Pool,
+        const uint32_t p_Capacity,
+        const bool p_IsPooled);
+
+    //
+    // Number of references to the buffer.
+    //
+    std::atomic<uint32_t> m_ReferenceCount;
+
+    //
+    // Pool the buffer is returned to once unreferenced.
+    //
+    BufferPool* m_Pool;
+
+    //
+    // Usable size of the buffer.
+    //
+    uint32_t m_Capacity;
+
+    //
+    // Whether the buffer is one of the fixed-size buffers of the pool, cached on release, or a dedicated one.
+    //
+    bool m_IsPooled;
+
+};
+
+//
+// Shared reference to a buffer. The buffer is returned to its pool when the last reference is dropped.
+// References can be dropped from any thread.
+//
+class BufferReference
+{
+
+public:
+
+    //
+    // Constructor. Creates an empty reference.
+    //
+    BufferReference();
+
+    //
+    // Copy constructor. Adds a reference to the buffer.
+    //
+    BufferReference(
+        const BufferReference& p_Other);
+
+    //
+    // Move constructor.
+    //
+    BufferReference(
+        BufferReference&& p_Other) noexcept;
+
+    //
+    // Destructor. Drops the reference to the buffer.
+    //
+    ~BufferReference();
+
+    //
+    // Copy assignment operator.
+    //
+    BufferReference&
+    operator=(
+        const BufferReference& p_Other);
+
+    //
+    // Move assignment operator.
+    //
+    BufferReference&
+    operator=(
+        BufferReference&& p_Other) noexcept;
+
+    //
+    // Determines whether the reference points to a buffer.
+    //
+    explicit
+    operator bool() const;
+
+    //
+    // Returns the start of the buffer memory.
+    //
+    Byte*
+    GetData() const;
+
+    //
+    // Returns the usable size of the buffer.
+    //
+    uint32_t
+    GetCapacity() const;
+
+    //
+    // Determines whether other references to the same buffer exist.
+    // Shared buffers must be treated as read-only.
+    //
+    bool
+    IsShared() const;
+
+    //
+    // Determines whether the buffer is one of the fixed-size buffers of its pool,
+    // as opposed to a dedicated buffer serving an oversized request.
+    //
+    bool
+    IsPooled() const;
+
+    //
+    // Drops the reference to the buffer.
+    //
+    void
+    Reset();
+
+private:
+
+    friend class BufferPool;
+
+    //
+    // Constructor. Takes over an already accounted reference.
+    //
+    explicit
+    BufferReference(
+        Buffer* p_Buffer);
+
+    //
+    // Referenced buffer.
+    //
+    Buffer* m_Buffer;
+
+};
+
+//
+// Thread-safe pool of fixed-size reference counted buffers.
+// Requests larger than the pool buffer size are served with dedicated buffers that are freed on release.
+// Buffers are drawn from a slab allocator if one is given, which bounds the memory of all the pools sharing
+// it; otherwise from the heap. Slab buffers get the whole block, so their capacity can exceed the size asked for.
+//
+class BufferPool
+{
+
+public:
+
+    //
+    // Constructor.
+    //
+    BufferPool();
+
+    //
+    // Destructor. Frees all cached buffers. No buffer of the pool may be referenced at this point.
+    //
+    ~BufferPool();
+
+    //
+    // Initializes the pool.
+    //
+    StatusCode
+    Init(
+        const uint32_t p_BufferSize,
+        const uint32_t p_MaxNumberCachedBuffers,
+        SlabAllocator* p_SlabAllocator);
+
+    //
+    // Acquires a buffer of at least the specified size. Returns an empty reference on allocation failure.
+    //
+    BufferReference
+    Acquire(
+        const uint32_t p_Size);
+
+    //
+    // Returns the size of the pooled buffers.
+    //
+    uint32_t
+    GetBufferSize() const;
+
+private:
+
+    friend class BufferReference;
+
+    //
+    // Returns an unreferenced buffer to the pool.
+    //
+    void
+    Release(
+        Buffer* p_Buffer);
+
+    //
+    // Allocates a new buffer with at least the specified capacity.
+    //
+    Buffer*
+    Allocate(
+        const uint32_t p_Capacity,
+        const bool p_IsPooled);
+
+    //
+    // Frees a buffer.
+    //
+    void
+    Free(
+        Buffer* p_Buffer);
+
+    //
+    // Size of the pooled buffers.
+    //
+    uint32_t m_BufferSize;
+
+    //
+    // Maximum number of unreferenced buffers kept for reuse.
+    //
+    uint32_t m_MaxNumberCachedBuffers;
+
+    //
+    // Allocator the buffers are drawn from. Null if the heap is used.
+    //
+    SlabAllocator* m_SlabAllocator;
+
+    //
+    // Exclusive lock for synchronizing access to the cached buffers.
+    //
+    std::mutex m_Lock;
+
+    //
+    // Unreferenced buffers ready for reuse.
+    //
+    std::vector<Buffer*> m_CachedBuffers;
+
+};
+
+} // namespace gX.
+
+#endif
@@ -0,0 +1,260 @@
+// *************************************
+// Ganymede Xpedia
+// Common
+// 'gXCpuTopology.cc'
+// Author: jcjuarez
+// *************************************
+
+#include <sched.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <charconv>
+#include <fstream>
+#include <algorithm>
+#include "gXCpuTopology.hh"
+
+namespace gX
+{
+
+static_assert(CPU_SETSIZE >= 1024, "CPU sets must hold every supported CPU.");
+
+CpuTopology::Topology::Topology()
+    : m_AvailableCpus(c_MaxNumberCpus, false),
+      m_NumberNumaNodes(1u)
+{
+    //
+    // Every node directory lists the CPUs it holds; without them all CPUs are on node zero.
+    //
+    const std::string nodesPath = "/sys/devices/system/node";
+    DIR* nodesDirectory = opendir(nodesPath.c_str());
+
+    if (nodesDirectory != nullptr)
+    {
+        while (const dirent* entry = readdir(nodesDirectory))
+        {
+            const std::string entryName = entry->d_name;
+            uint16_t numaNode;
+
+            if (entryName.size() <= 4u ||
+                entryName.compare(0, 4u, "node") != 0)
+            {
+                continue;
+            }
+
+            const std::from_chars_result result = std::from_chars(entryName.data() + 4u, entryName.data() + entryName.size(), numaNode);
+
+            if (result.ec != std::errc() ||
+                result.ptr != entryName.data() + entryName.size())
+            {
+                continue;
+            }
+
+            std::ifstream cpuListFile(nodesPath + "/" + entryName + "/cpulist");
+            std::string cpuList;
+            std::vector<uint16_t> cpus;
+
+            if (!std::getline(cpuListFile, cpuList) ||
+                Status::Failed(ParseCpuList(cpuList, cpus)))
+            {
+                continue;
+            }
+
+            for (const uint16_t cpu : cpus)
+            {
+                if (cpu >= m_CpuNumaNodes.size())
+                {
+                    m_CpuNumaNodes.resize(cpu + 1u, 0u);
+                }
+
+                m_CpuNumaNodes[cpu] = numaNode;
+            }
+
+            m_NumberNumaNodes = std::max<uint16_t>(m_NumberNumaNodes, numaNode + 1u);
+        }
+
+        closedir(nodesDirectory);
+    }
+
+    cpu_set_t availableCpus;
+    CPU_ZERO(&availableCpus);
+
+    if (sched_getaffinity(0, sizeof(availableCpus), &availableCpus) == 0)
+    {
+        for (uint16_t cpu = 0; cpu < c_MaxNumberCpus; ++cpu)
+        {
+            m_AvailableCpus[cpu] = CPU_ISSET(cpu, &availableCpus);
+        }
+    }
+}
+
+StatusCode
+CpuTopology::ParseCpuList(
+    const std::string& p_CpuList,
+    std::vector<uint16_t>& p_Cpus)
+{
+    p_Cpus.clear();
+
+    const char* position = p_CpuList.data();
+    const char* end = p_CpuList.data() + p_CpuList.size();
+
+    //
+    // Sysfs lists end with a line break.
+    //
+    while (end != position &&
+        (end[-1] == '\n' || end[-1] == ' '))
+    {
+        --end;
+    }
+
+    while (position != end)
+    {
+        uint16_t firstCpu;
+        uint16_t lastCpu;
+        std::from_chars_result result = std::from_chars(position, end, firstCpu);
+
+        if (result.ec != std::errc())
+        {
+            return Status::InvalidArgument;
+        }
+
+        lastCpu = firstCpu;
+        position = result.ptr;
+
+        if (position != end &&
+            *position == '-')
+        {
+            result = std::from_chars(position + 1, end, lastCpu);
+
+            if (result.ec != std::errc() ||
+                lastCpu < firstCpu)
+            {
+                return Status::InvalidArgument;
+            }
+
+            position = result.ptr;
+        }
+
+        if (lastCpu >= c_MaxNumberCpus)
+        {
+            return Status::InvalidArgument;
+        }
+
+        for (uint32_t cpu = firstCpu; cpu <= lastCpu; ++cpu)
+        {
+            p_Cpus.push_back(static_cast<uint16_t>(cpu));
+        }
+
+        if (position != end)
+        {
+            //
+            // Ranges are separated by commas, and a trailing one is not allowed.
+            //
+            if (*position != ',' ||
+                ++position == end)
+            {
+                return Status::InvalidArgument;
+            }
+        }
+    }
+
+    std::sort(p_Cpus.begin(), p_Cpus.end());
+    p_Cpus.erase(std::unique(p_Cpus.begin(), p_Cpus.end()), p_Cpus.end());
+
+    return Status::Success;
+}
+
+uint16_t
+CpuTopology::GetNumaNode(
+    const uint16_t p_Cpu)
+{
+    const Topology& topology = GetTopology();
+
+    return p_Cpu < topology.m_CpuNumaNodes.size() ?
+        topology.m_CpuNumaNodes[p_Cpu] :
+        0u;
+}
+
+uint16_t
+CpuTopology::GetNumberNumaNodes()
+{
+    return GetTopology().m_NumberNumaNodes;
+}
+
+uint16_t
+CpuTopology::GetCurrentNumaNode()
+{
+    const int32_t cpu = sched_getcpu();
+
+    return cpu >= 0 ?
+        GetNumaNode(static_cast<uint16_t>(cpu)) :
+        0u;
+}
+
+bool
+CpuTopology::IsCpuAvailable(
+    const uint16_t p_Cpu)
+{
+    return p_Cpu < c_MaxNumberCpus &&
+        GetTopology().m_AvailableCpus[p_Cpu];
+}
+
+StatusCode
+CpuTopology::GetCurrentThreadCpus(
+    std::vector<uint16_t>& p_Cpus)
+{
+    p_Cpus.clear();
+
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+
+    if (pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0)
+    {
+        return Status::InvalidArgument;
+    }
+
+    for (uint16_t cpu = 0; cpu < c_MaxNumberCpus; ++cpu)
+    {
+        if (CPU_ISSET(cpu, &cpus))
+        {
+            p_Cpus.push_back(cpu);
+        }
+    }
+
+    return Status::Success;
+}
+
+StatusCode
+CpuTopology::PinCurrentThread(
+    const std::vector<uint16_t>& p_Cpus)
+{
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+
+    for (const uint16_t cpu : p_Cpus)
+    {
+        if (cpu >= c_MaxNumberCpus)
+        {
+            return Status::InvalidArgument;
+        }
+
+        CPU_SET(cpu, &cpus);
+    }
+
+    if (p_Cpus.empty() ||
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0)
+    {
+        return Status::InvalidArgument;
+    }
+
+    return Status::Success;
+}
+
+const CpuTopology::Topology&
+CpuTopology::GetTopology()
+{
+    static const Topology topology;
+
+    return topology;
+}
+
+} // namespace gX.
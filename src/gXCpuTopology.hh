@@ -0,0 +1,136 @@
+// *************************************
+// Ganymede Xpedia
+// Common
+// 'gXCpuTopology.hh'
+// Author: jcjuarez
+// *************************************
+
+#ifndef GX_CPU_TOPOLOGY_
+#define GX_CPU_TOPOLOGY_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "gXStatus.hh"
+
+namespace gX
+{
+
+//
+// Static class for querying the NUMA layout of the machine and pinning threads to CPUs.
+// The layout is read once from sysfs; machines without NUMA information are treated as a single node.
+//
+class CpuTopology
+{
+
+    //
+    // Static class.
+    //
+    CpuTopology() = delete;
+
+public:
+
+    //
+    // Parses a CPU list in the kernel format, such as "0-3,8,10-11", into sorted, unique CPU indexes.
+    // Returns InvalidArgument if the list is malformed or names a CPU beyond the supported range.
+    //
+    static
+    StatusCode
+    ParseCpuList(
+        const std::string& p_CpuList,
+        std::vector<uint16_t>& p_Cpus);
+
+    //
+    // Returns the NUMA node of the CPU, or zero if unknown.
+    //
+    static
+    uint16_t
+    GetNumaNode(
+        const uint16_t p_Cpu);
+
+    //
+    // Returns the number of NUMA nodes, counting up to the highest node index.
+    //
+    static
+    uint16_t
+    GetNumberNumaNodes();
+
+    //
+    // Returns the NUMA node of the CPU the calling thread is running on.
+    //
+    static
+    uint16_t
+    GetCurrentNumaNode();
+
+    //
+    // Determines whether the process is allowed to run on the CPU.
+    //
+    static
+    bool
+    IsCpuAvailable(
+        const uint16_t p_Cpu);
+
+    //
+    // Retrieves the CPUs the calling thread is allowed to run on.
+    //
+    static
+    StatusCode
+    GetCurrentThreadCpus(
+        std::vector<uint16_t>& p_Cpus);
+
+    //
+    // Restricts the calling thread to the specified CPUs. Memory the thread touches first from then on
+    // is placed on their nodes by the kernel. Returns InvalidArgument if none of them is available.
+    //
+    static
+    StatusCode
+    PinCurrentThread(
+        const std::vector<uint16_t>& p_Cpus);
+
+private:
+
+    //
+    // Layout of the machine, read once on first use.
+    //
+    struct Topology
+    {
+
+        //
+        // Constructor. Reads the layout from sysfs.
+        //
+        Topology();
+
+        //
+        // NUMA node of each CPU, indexed by CPU.
+        //
+        std::vector<uint16_t> m_CpuNumaNodes;
+
+        //
+        // Whether the process is allowed to run on each CPU, indexed by CPU.
+        //
+        std::vector<bool> m_AvailableCpus;
+
+        //
+        // Number of NUMA nodes.
+        //
+        uint16_t m_NumberNumaNodes;
+
+    };
+
+    //
+    // Returns the layout of the machine.
+    //
+    static
+    const Topology&
+    GetTopology();
+
+    //
+    // Maximum number of CPUs supported.
+    //
+    static constexpr uint16_t c_MaxNumberCpus = 1024u;
+
+};
+
+} // namespace gX.
+
+#endif
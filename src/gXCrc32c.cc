@@ -0,0 +1,318 @@
+// *************************************
+// Ganymede Xpedia
+// Common
+// 'gXCrc32c.cc'
+// Author: jcjuarez
+// *************************************
+
+#include <cstring>
+#include <endian.h>
+#include "gXCrc32c.hh"
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
+namespace gX
+{
+
+Crc32c::Tables::Tables()
+    : m_IsHardwareAccelerated(false)
+{
+    for (uint32_t value = 0; value < 256u; ++value)
+    {
+        uint32_t checksum = value;
+
+        for (uint32_t bitIndex = 0; bitIndex < 8u; ++bitIndex)
+        {
+            checksum = checksum & 1u ?
+                (checksum >> 1) ^ c_Polynomial :
+                checksum >> 1;
+        }
+
+        m_Slices[0][value] = checksum;
+    }
+
+    //
+    // Each slice advances the checksum by one more byte, so that eight bytes are folded with independent lookups.
+    //
+    for (uint32_t value = 0; value < 256u; ++value)
+    {
+        for (uint32_t sliceIndex = 1; sliceIndex < 8u; ++sliceIndex)
+        {
+            const uint32_t previous = m_Slices[sliceIndex - 1u][value];
+
+            m_Slices[sliceIndex][value] = (previous >> 8) ^ m_Slices[0][previous & 0xFFu];
+        }
+    }
+
+    BuildShiftTable(m_LongShift, c_LongBlockSize);
+    BuildShiftTable(m_ShortShift, c_ShortBlockSize);
+
+#if defined(__x86_64__)
+    m_IsHardwareAccelerated = __builtin_cpu_supports("sse4.2");
+#endif
+}
+
+uint32_t
+Crc32c::Compute(
+    const Byte* p_Data,
+    const size_t p_Size,
+    const uint32_t p_Checksum)
+{
+    return GetTables().m_IsHardwareAccelerated ?
+        ComputeHardware(p_Data, p_Size, p_Checksum) :
+        ComputeSoftware(p_Data, p_Size, p_Checksum);
+}
+
+uint32_t
+Crc32c::ComputeSoftware(
+    const Byte* p_Data,
+    const size_t p_Size,
+    const uint32_t p_Checksum)
+{
+    const Tables& tables = GetTables();
+    const Byte* data = p_Data;
+    size_t size = p_Size;
+    uint32_t checksum = ~p_Checksum;
+
+    while (size != 0 &&
+        (reinterpret_cast<uintptr_t>(data) & 7u) != 0)
+    {
+        checksum = tables.m_Slices[0][(checksum ^ *data++) & 0xFFu] ^ (checksum >> 8);
+        --size;
+    }
+
+    while (size >= 8u)
+    {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        word = le64toh(word) ^ checksum;
+
+        checksum =
+            tables.m_Slices[7][word & 0xFFu] ^
+            tables.m_Slices[6][(word >> 8) & 0xFFu] ^
+            tables.m_Slices[5][(word >> 16) & 0xFFu] ^
+            tables.m_Slices[4][(word >> 24) & 0xFFu] ^
+            tables.m_Slices[3][(word >> 32) & 0xFFu] ^
+            tables.m_Slices[2][(word >> 40) & 0xFFu] ^
+            tables.m_Slices[1][(word >> 48) & 0xFFu] ^
+            tables.m_Slices[0][word >> 56];
+
+        data += 8u;
+        size -= 8u;
+    }
+
+    while (size != 0)
+    {
+        checksum = tables.m_Slices[0][(checksum ^ *data++) & 0xFFu] ^ (checksum >> 8);
+        --size;
+    }
+
+    return ~checksum;
+}
+
+bool
+Crc32c::IsHardwareAccelerated()
+{
+    return GetTables().m_IsHardwareAccelerated;
+}
+
+const Crc32c::Tables&
+Crc32c::GetTables()
+{
+    static const Tables tables;
+
+    return tables;
+}
+
+#if defined(__x86_64__)
+
+__attribute__((target("sse4.2")))
+uint32_t
+Crc32c::ComputeHardware(
+    const Byte* p_Data,
+    size_t p_Size,
+    const uint32_t p_Checksum)
+{
+    const Tables& tables = GetTables();
+    const Byte* data = p_Data;
+    uint64_t checksum = ~p_Checksum;
+
+    while (p_Size != 0 &&
+        (reinterpret_cast<uintptr_t>(data) & 7u) != 0)
+    {
+        checksum = _mm_crc32_u8(static_cast<uint32_t>(checksum), *data++);
+        --p_Size;
+    }
+
+    //
+    // Checksum three adjacent blocks at a time as independent streams, then fold the second and third
+    // streams in by appending to the running checksum as many zero bytes as a block holds.
+    //
+    for (uint32_t passIndex = 0; passIndex < 2u; ++passIndex)
+    {
+        const bool isLongBlock = passIndex == 0;
+        const size_t blockSize = isLongBlock ? c_LongBlockSize : c_ShortBlockSize;
+        const uint32_t (&shiftTable)[4][256] = isLongBlock ? tables.m_LongShift : tables.m_ShortShift;
+
+        while (p_Size >= blockSize * 3u)
+        {
+            uint64_t secondChecksum = 0;
+            uint64_t thirdChecksum = 0;
+            const Byte* blockEnd = data + blockSize;
+
+            do
+            {
+                uint64_t firstWord;
+                uint64_t secondWord;
+                uint64_t thirdWord;
+
+                std::memcpy(&firstWord, data, sizeof(firstWord));
+                std::memcpy(&secondWord, data + blockSize, sizeof(secondWord));
+                std::memcpy(&thirdWord, data + blockSize * 2u, sizeof(thirdWord));
+
+                checksum = _mm_crc32_u64(checksum, firstWord);
+                secondChecksum = _mm_crc32_u64(secondChecksum, secondWord);
+                thirdChecksum = _mm_crc32_u64(thirdChecksum, thirdWord);
+
+                data += 8u;
+            }
+            while (data < blockEnd);
+
+            checksum = Shift(shiftTable, static_cast<uint32_t>(checksum)) ^ secondChecksum;
+            checksum = Shift(shiftTable, static_cast<uint32_t>(checksum)) ^ thirdChecksum;
+
+            data += blockSize * 2u;
+            p_Size -= blockSize * 3u;
+        }
+    }
+
+    while (p_Size >= 8u)
+    {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+
+        checksum = _mm_crc32_u64(checksum, word);
+
+        data += 8u;
+        p_Size -= 8u;
+    }
+
+    while (p_Size != 0)
+    {
+        checksum = _mm_crc32_u8(static_cast<uint32_t>(checksum), *data++);
+        --p_Size;
+    }
+
+    return ~static_cast<uint32_t>(checksum);
+}
+
+#else
+
+uint32_t
+Crc32c::ComputeHardware(
+    const Byte* p_Data,
+    size_t p_Size,
+    const uint32_t p_Checksum)
+{
+    return ComputeSoftware(p_Data, p_Size, p_Checksum);
+}
+
+#endif
+
+uint32_t
+Crc32c::Shift(
+    const uint32_t (&p_ShiftTable)[4][256],
+    const uint32_t p_Checksum)
+{
+    return
+        p_ShiftTable[0][p_Checksum & 0xFFu] ^
+        p_ShiftTable[1][(p_Checksum >> 8) & 0xFFu] ^
+        p_ShiftTable[2][(p_Checksum >> 16) & 0xFFu] ^
+        p_ShiftTable[3][p_Checksum >> 24];
+}
+
+void
+Crc32c::BuildShiftTable(
+    uint32_t (&p_ShiftTable)[4][256],
+    size_t p_NumberZeroBytes)
+{
+    //
+    // Start from the operator appending a single zero bit and square it up to one zero byte, then keep
+    // squaring once per halving of the number of bytes, alternating between the two matrices.
+    //
+    uint32_t even[32];
+    uint32_t odd[32];
+
+    odd[0] = c_Polynomial;
+
+    for (uint32_t rowIndex = 1; rowIndex < 32u; ++rowIndex)
+    {
+        odd[rowIndex] = 1u << (rowIndex - 1u);
+    }
+
+    SquareMatrix(even, odd);
+    SquareMatrix(odd, even);
+
+    const uint32_t* shiftOperator = nullptr;
+
+    do
+    {
+        SquareMatrix(even, odd);
+        p_NumberZeroBytes >>= 1;
+        shiftOperator = even;
+
+        if (p_NumberZeroBytes == 0)
+        {
+            break;
+        }
+
+        SquareMatrix(odd, even);
+        p_NumberZeroBytes >>= 1;
+        shiftOperator = odd;
+    }
+    while (p_NumberZeroBytes != 0);
+
+    uint32_t matrix[32];
+    std::memcpy(matrix, shiftOperator, sizeof(matrix));
+
+    for (uint32_t value = 0; value < 256u; ++value)
+    {
+        p_ShiftTable[0][value] = MultiplyMatrix(matrix, value);
+        p_ShiftTable[1][value] = MultiplyMatrix(matrix, value << 8);
+        p_ShiftTable[2][value] = MultiplyMatrix(matrix, value << 16);
+        p_ShiftTable[3][value] = MultiplyMatrix(matrix, value << 24);
+    }
+}
+
+uint32_t
+Crc32c::MultiplyMatrix(
+    const uint32_t (&p_Matrix)[32],
+    uint32_t p_Vector)
+{
+    uint32_t product = 0;
+
+    for (uint32_t rowIndex = 0; p_Vector != 0; ++rowIndex, p_Vector >>= 1)
+    {
+        if (p_Vector & 1u)
+        {
+            product ^= p_Matrix[rowIndex];
+        }
+    }
+
+    return product;
+}
+
+void
+Crc32c::SquareMatrix(
+    uint32_t (&p_Square)[32],
+    const uint32_t (&p_Matrix)[32])
+{
+    for (uint32_t rowIndex = 0; rowIndex < 32u; ++rowIndex)
+    {
+        p_Square[rowIndex] = MultiplyMatrix(p_Matrix, p_Matrix[rowIndex]);
+    }
+}
+
+} // namespace gX.
@@ -0,0 +1,169 @@
+// *************************************
+// Ganymede Xpedia
+// Common
+// 'gXCrc32c.hh'
+// Author: jcjuarez
+// *************************************
+
+#ifndef GX_CRC32C_
+#define GX_CRC32C_
+
+#include <cstddef>
+#include <cstdint>
+#include "gXStatus.hh"
+
+namespace gX
+{
+
+//
+// Static class for computing CRC32C (Castagnoli) checksums.
+// Uses the SSE4.2 crc32 instruction when the processor supports it, and a table-driven
+// implementation otherwise; both produce the same values.
+//
+class Crc32c
+{
+
+    //
+    // Static class.
+    //
+    Crc32c() = delete;
+
+public:
+
+    //
+    // Computes the checksum of the data. A previous checksum can be specified to extend it over more data.
+    //
+    static
+    uint32_t
+    Compute(
+        const Byte* p_Data,
+        const size_t p_Size,
+        const uint32_t p_Checksum = 0u);
+
+    //
+    // Computes the checksum of the data with the table-driven implementation, regardless of the processor.
+    //
+    static
+    uint32_t
+    ComputeSoftware(
+        const Byte* p_Data,
+        const size_t p_Size,
+        const uint32_t p_Checksum = 0u);
+
+    //
+    // Determines whether checksums are computed with the crc32 instruction.
+    //
+    static
+    bool
+    IsHardwareAccelerated();
+
+private:
+
+    //
+    // Lookup tables, built once on first use.
+    //
+    struct Tables
+    {
+
+        //
+        // Constructor. Builds all the tables.
+        //
+        Tables();
+
+        //
+        // Slicing-by-8 tables of the table-driven implementation.
+        //
+        uint32_t m_Slices[8][256];
+
+        //
+        // Operator appending c_LongBlockSize zero bytes to a checksum, split per checksum byte.
+        //
+        uint32_t m_LongShift[4][256];
+
+        //
+        // Operator appending c_ShortBlockSize zero bytes to a checksum, split per checksum byte.
+        //
+        uint32_t m_ShortShift[4][256];
+
+        //
+        // Whether the processor supports the crc32 instruction.
+        //
+        bool m_IsHardwareAccelerated;
+
+    };
+
+    //
+    // Returns the lookup tables.
+    //
+    static
+    const Tables&
+    GetTables();
+
+    //
+    // Computes the checksum of the data with the crc32 instruction. Only called if the processor supports it.
+    //
+    static
+    uint32_t
+    ComputeHardware(
+        const Byte* p_Data,
+        size_t p_Size,
+        const uint32_t p_Checksum);
+
+    //
+    // Appends the number of zero bytes of the specified shift tables to a raw checksum.
+    //
+    static
+    uint32_t
+    Shift(
+        const uint32_t (&p_ShiftTable)[4][256],
+        const uint32_t p_Checksum);
+
+    //
+    // Builds the tables of the operator appending the specified number of zero bytes, which must be a power of two.
+    //
+    static
+    void
+    BuildShiftTable(
+        uint32_t (&p_ShiftTable)[4][256],
+        size_t p_NumberZeroBytes);
+
+    //
+    // Multiplies a vector by a matrix over GF(2).
+    //
+    static
+    uint32_t
+    MultiplyMatrix(
+        const uint32_t (&p_Matrix)[32],
+        uint32_t p_Vector);
+
+    //
+    // Squares a matrix over GF(2).
+    //
+    static
+    void
+    SquareMatrix(
+        uint32_t (&p_Square)[32],
+        const uint32_t (&p_Matrix)[32]);
+
+    //
+    // Reflected CRC32C polynomial.
+    //
+    static constexpr uint32_t c_Polynomial = 0x82F63B78u;
+
+    //
+    // Size of each of the three blocks checksummed in parallel for large inputs. The crc32 instruction
+    // has a latency of three cycles but a throughput of one per cycle, so three independent streams
+    // keep it busy; their checksums are combined afterwards.
+    //
+    static constexpr size_t c_LongBlockSize = 8192u;
+
+    //
+    // Size of each of the three blocks checksummed in parallel for medium inputs.
+    //
+    static constexpr size_t c_ShortBlockSize = 256u;
+
+};
+
+} // namespace gX.
+
+#endif
@@ -0,0 +1,1010 @@
+// *************************************
+// Ganymede Xpedia
+// gXDTP (Data Transmission Protocol)
+// 'gXDataTransmissionClient.cc'
+// Author: jcjuarez
+// *************************************
+
+#include <netdb.h>
+#include <cerrno>
+#include <cstring>
+#include <climits>
+#include <unistd.h>
+#include <thread>
+#include <poll.h>
+#include <algorithm>
+#include <sys/un.h>
+#include <sys/uio.h>
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+#include "gXDataTransmissionClient.hh"
+#include "gXCrc32c.hh"
+
+namespace gX
+{
+
+DataTransmissionClientConfiguration::DataTransmissionClientConfiguration()
+    : m_Host(c_DefaultHost),
+      m_Port(c_DefaultPortNumber),
+      m_EnableSharedMemory(c_DefaultEnableSharedMemory),
+      m_MaxNumberConnections(c_DefaultMaxNumberConnections),
+      m_NumberWarmConnections(c_DefaultNumberWarmConnections),
+      m_ThreadPoolSize(c_DefaultThreadPoolSize),
+      m_MaxNumberInFlightRequests(c_DefaultMaxNumberInFlightRequests),
+      m_ReceiveBufferSize(c_DefaultReceiveBufferSize),
+      m_MaxPacketSize(c_DefaultMaxPacketSize),
+      m_TimeoutMilliseconds(c_DefaultTimeoutMilliseconds),
+      m_EnableChecksums(c_DefaultEnableChecksums),
+      m_EnableDeadlines(c_DefaultEnableDeadlines)
+{}
+
+DataTransmissionClient::DataTransmissionClient()
+    : m_IsInitialized(false),
+      m_AddressLength(0),
+      m_EnableChecksums(false),
+      m_EnableDeadlines(false),
+      m_EnableSharedMemory(false),
+      m_NumberOpenConnections(0)
+{}
+
+DataTransmissionClient::~DataTransmissionClient()
+{}
+
+StatusCode
+DataTransmissionClient::Init(
+    const DataTransmissionClientConfiguration* p_Configuration)
+{
+    if (m_IsInitialized)
+    {
+        return Status::AlreadyInitialized;
+    }
+
+    DataTransmissionClientConfiguration defaultConfiguration;
+
+    if (p_Configuration == nullptr)
+    {
+        //
+        // If no configurations are specified, use the default ones.
+        //
+        p_Configuration = &defaultConfiguration;
+    }
+
+    m_MaxNumberConnections = std::max<uint16_t>(1u, p_Configuration->m_MaxNumberConnections);
+    m_MaxNumberInFlightRequests = std::clamp<uint16_t>(p_Configuration->m_MaxNumberInFlightRequests, 1u, IOV_MAX / 2);
+    m_ReceiveBufferSize = std::max(DataTransmissionProtocol::c_ResponseHeaderSize, p_Configuration->m_ReceiveBufferSize);
+    m_MaxPacketSize = p_Configuration->m_MaxPacketSize;
+    m_TimeoutMilliseconds = p_Configuration->m_TimeoutMilliseconds;
+    m_EnableChecksums = p_Configuration->m_EnableChecksums;
+    m_EnableDeadlines = p_Configuration->m_EnableDeadlines;
+
+    const std::string& unixSocketPath = p_Configuration->m_UnixSocketPath;
+
+    if (p_Configuration->m_EnableSharedMemory &&
+        unixSocketPath.empty())
+    {
+        return Status::InvalidArgument;
+    }
+
+    m_EnableSharedMemory = p_Configuration->m_EnableSharedMemory;
+
+    if (!unixSocketPath.empty())
+    {
+        //
+        // Same-host server; abstract socket names are given with a leading '@' in place of their null byte.
+        //
+        sockaddr_un& address = *reinterpret_cast<sockaddr_un*>(&m_Address);
+        address = sockaddr_un {};
+        address.sun_family = AF_UNIX;
+
+        if (unixSocketPath.size() >= sizeof(address.sun_path))
+        {
+            return Status::InvalidArgument;
+        }
+
+        std::memcpy(address.sun_path, unixSocketPath.data(), unixSocketPath.size());
+
+        const bool isAbstract = unixSocketPath.front() == '@';
+
+        if (isAbstract)
+        {
+            address.sun_path[0] = '\0';
+        }
+
+        m_AddressLength = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + unixSocketPath.size() + (isAbstract ? 0u : 1u));
+    }
+    else
+    {
+        //
+        // Resolve the server address.
+        //
+        addrinfo hints {};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* addresses = nullptr;
+
+        if (getaddrinfo(p_Configuration->m_Host.c_str(), nullptr, &hints, &addresses) != 0 ||
+            addresses == nullptr)
+        {
+            return Status::AddressResolutionFailed;
+        }
+
+        sockaddr_in& address = *reinterpret_cast<sockaddr_in*>(&m_Address);
+        address = *reinterpret_cast<const sockaddr_in*>(addresses->ai_addr);
+        address.sin_port = htons(p_Configuration->m_Port);
+        m_AddressLength = sizeof(address);
+        freeaddrinfo(addresses);
+    }
+
+    //
+    // Initialize the thread pool for asynchronous requests.
+    //
+    StatusCode status = m_ThreadPool.Init(p_Configuration->m_ThreadPoolSize);
+
+    if (Status::Failed(status))
+    {
+        return status;
+    }
+
+    //
+    // Establish the warm connections so that the first requests do not pay for the handshake.
+    //
+    const uint16_t numberWarmConnections = std::min(p_Configuration->m_NumberWarmConnections, m_MaxNumberConnections);
+
+    for (uint16_t connectionIndex = 0; connectionIndex < numberWarmConnections; ++connectionIndex)
+    {
+        std::unique_ptr<Connection> connection;
+        status = Connect(connection);
+
+        if (Status::Failed(status))
+        {
+            return status;
+        }
+
+        m_IdleConnections.emplace_back(std::move(connection));
+        ++m_NumberOpenConnections;
+    }
+
+    m_IsInitialized = true;
+
+    return Status::Success;
+}
+
+StatusCode
+DataTransmissionClient::Send(
+    const PacketTag p_PacketTag,
+    const std::string& p_Packet,
+    DataTransmissionResponse& p_Response)
+{
+    if (!m_IsInitialized)
+    {
+        return Status::NotInitialized;
+    }
+
+    std::unique_ptr<Connection> connection;
+    StatusCode status = AcquireConnection(connection);
+
+    if (Status::Failed(status))
+    {
+        return status;
+    }
+
+    //
+    // Write the header and the payload in one system call without copying the payload.
+    //
+    iovec vector[2];
+    Byte header[DataTransmissionProtocol::c_MaxHeaderSize];
+    const uint32_t headerSize = SerializeRequestHeader(p_PacketTag, p_Packet, header);
+
+    vector[0] = { header, headerSize };
+    vector[1] = { const_cast<char*>(p_Packet.data()), p_Packet.size() };
+
+    status = SendVector(*connection, vector, 2);
+
+    if (Status::Succeeded(status))
+    {
+        status = ReadResponse(*connection, p_PacketTag, p_Response);
+    }
+
+    ReleaseConnection(std::move(connection), Status::Succeeded(status));
+
+    return status;
+}
+
+std::future<DataTransmissionResponse>
+DataTransmissionClient::SendAsync(
+    const PacketTag p_PacketTag,
+    std::string p_Packet)
+{
+    auto enqueueResult = m_ThreadPool.EnqueueTask(
+        [this, p_PacketTag, packet = std::move(p_Packet)]()
+        {
+            DataTransmissionResponse response {};
+            const StatusCode status = Send(p_PacketTag, packet, response);
+
+            if (Status::Failed(status))
+            {
+                response.m_Status = status;
+            }
+
+            return response;
+        });
+
+    if (enqueueResult != std::nullopt)
+    {
+        return std::move(*enqueueResult);
+    }
+
+    //
+    // The client is being destroyed; report the failure through an already satisfied future.
+    //
+    std::promise<DataTransmissionResponse> failedResponse;
+    failedResponse.set_value(DataTransmissionResponse { Status::ServiceIsStopped, std::string() });
+
+    return failedResponse.get_future();
+}
+
+StatusCode
+DataTransmissionClient::SendBatch(
+    const std::vector<DataTransmissionRequest>& p_Requests,
+    std::vector<DataTransmissionResponse>& p_Responses)
+{
+    if (!m_IsInitialized)
+    {
+        return Status::NotInitialized;
+    }
+
+    p_Responses.clear();
+    p_Responses.resize(p_Requests.size());
+
+    if (p_Requests.empty())
+    {
+        return Status::Success;
+    }
+
+    std::unique_ptr<Connection> connection;
+    StatusCode status = AcquireConnection(connection);
+
+    if (Status::Failed(status))
+    {
+        return status;
+    }
+
+    size_t numberRequestsSent = 0;
+    size_t numberResponsesReceived = 0;
+
+    //
+    // Keep up to m_MaxNumberInFlightRequests requests in the pipe. Writing everything upfront
+    // could deadlock once the server stops reading to apply its in-flight limit.
+    //
+    while (numberResponsesReceived < p_Requests.size())
+    {
+        const size_t numberRequestsToSend = std::min(
+            p_Requests.size() - numberRequestsSent,
+            m_MaxNumberInFlightRequests - (numberRequestsSent - numberResponsesReceived));
+
+        if (numberRequestsToSend != 0)
+        {
+            status = WriteRequests(*connection, p_Requests.data() + numberRequestsSent, numberRequestsToSend);
+
+            if (Status::Failed(status))
+            {
+                break;
+            }
+
+            numberRequestsSent += numberRequestsToSend;
+        }
+
+        status = ReadResponse(
+            *connection,
+            p_Requests[numberResponsesReceived].m_PacketTag,
+            p_Responses[numberResponsesReceived]);
+
+        if (Status::Failed(status))
+        {
+            break;
+        }
+
+        ++numberResponsesReceived;
+    }
+
+    ReleaseConnection(std::move(connection), Status::Succeeded(status));
+
+    if (Status::Failed(status))
+    {
+        //
+        // Requests without a response are reported with the transmission failure.
+        //
+        for (size_t responseIndex = numberResponsesReceived; responseIndex < p_Responses.size(); ++responseIndex)
+        {
+            p_Responses[responseIndex].m_Status = status;
+        }
+    }
+
+    return status;
+}
+
+StatusCode
+DataTransmissionClient::AcquireConnection(
+    std::unique_ptr<Connection>& p_Connection)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_PoolLock);
+
+        m_PoolCondition.wait(lock,
+            [this]
+            {
+                return !this->m_IdleConnections.empty() || this->m_NumberOpenConnections < this->m_MaxNumberConnections;
+            });
+
+        while (!m_IdleConnections.empty())
+        {
+            //
+            // Reuse the most recently released connection, which is the most likely to still be warm.
+            //
+            p_Connection = std::move(m_IdleConnections.back());
+            m_IdleConnections.pop_back();
+
+            if (IsConnectionOpen(*p_Connection))
+            {
+                return Status::Success;
+            }
+
+            //
+            // The server closed the connection while pooled; replace it with a new one.
+            //
+            p_Connection.reset();
+            --m_NumberOpenConnections;
+        }
+
+        //
+        // Reserve the slot before connecting outside the lock.
+        //
+        ++m_NumberOpenConnections;
+    }
+
+    const StatusCode status = Connect(p_Connection);
+
+    if (Status::Failed(status))
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_PoolLock);
+            --m_NumberOpenConnections;
+        }
+
+        m_PoolCondition.notify_one();
+    }
+
+    return status;
+}
+
+void
+DataTransmissionClient::ReleaseConnection(
+    std::unique_ptr<Connection>&& p_Connection,
+    const bool p_IsReusable)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_PoolLock);
+
+        if (p_IsReusable)
+        {
+            p_Connection->m_ReleaseTime = std::chrono::steady_clock::now();
+            m_IdleConnections.emplace_back(std::move(p_Connection));
+        }
+        else
+        {
+            //
+            // The connection may hold unread response data; it cannot be reused.
+            //
+            p_Connection.reset();
+            --m_NumberOpenConnections;
+        }
+    }
+
+    m_PoolCondition.notify_one();
+}
+
+bool
+DataTransmissionClient::IsConnectionOpen(
+    const Connection& p_Connection)
+{
+    if (std::chrono::steady_clock::now() - p_Connection.m_ReleaseTime < std::chrono::milliseconds(c_ConnectionCheckIntervalMilliseconds))
+    {
+        return true;
+    }
+
+    //
+    // The server never sends unprompted, so a pooled connection only becomes readable once closed.
+    //
+    Byte data;
+    const ssize_t readResult = recv(p_Connection.m_Handle, &data, sizeof(data), MSG_PEEK | MSG_DONTWAIT);
+
+    return readResult < 0 &&
+        (errno == EAGAIN || errno == EWOULDBLOCK);
+}
+
+StatusCode
+DataTransmissionClient::Connect(
+    std::unique_ptr<Connection>& p_Connection)
+{
+    const FileDescriptor handle = socket(m_Address.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+    if (handle < 0)
+    {
+        return Status::SocketCreationFailed;
+    }
+
+    try
+    {
+        p_Connection = std::make_unique<Connection>(handle, m_ReceiveBufferSize);
+    }
+    catch (const std::bad_alloc& e)
+    {
+        close(handle);
+
+        return Status::OutOfMemory;
+    }
+
+    //
+    // Requests are small and latency bound; disable Nagle's algorithm.
+    //
+    int32_t opt = 1;
+
+    if (m_Address.ss_family == AF_INET &&
+        setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt)))
+    {
+        p_Connection.reset();
+
+        return Status::SocketConfigurationFailed;
+    }
+
+    if (m_TimeoutMilliseconds != 0)
+    {
+        timeval timeout {};
+        timeout.tv_sec = m_TimeoutMilliseconds / 1000u;
+        timeout.tv_usec = (m_TimeoutMilliseconds % 1000u) * 1000u;
+
+        if (setsockopt(handle, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) ||
+            setsockopt(handle, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)))
+        {
+            p_Connection.reset();
+
+            return Status::SocketConfigurationFailed;
+        }
+    }
+
+    while (connect(handle, reinterpret_cast<const sockaddr*>(&m_Address), m_AddressLength) < 0)
+    {
+        if (errno != EINTR)
+        {
+            p_Connection.reset();
+
+            return Status::ConnectionFailed;
+        }
+    }
+
+    if (m_EnableSharedMemory)
+    {
+        const StatusCode status = OpenSharedMemoryChannel(*p_Connection);
+
+        if (Status::Failed(status))
+        {
+            p_Connection.reset();
+
+            return status;
+        }
+    }
+
+    return Status::Success;
+}
+
+StatusCode
+DataTransmissionClient::OpenSharedMemoryChannel(
+    Connection& p_Connection)
+{
+    Byte header[DataTransmissionProtocol::c_MaxHeaderSize];
+    const uint32_t headerSize = SerializeRequestHeader(SharedMemoryChannel::c_SetupPacketTag, std::string(), header);
+    iovec vector { header, headerSize };
+
+    StatusCode status = SendVector(p_Connection, &vector, 1u);
+
+    if (Status::Failed(status))
+    {
+        return status;
+    }
+
+    //
+    // The handles come attached to the response header, which is read on its own so that they cannot be split from it.
+    //
+    Byte responseHeader[DataTransmissionProtocol::c_ResponseHeaderSize];
+    FileDescriptor handles[SharedMemoryChannel::c_NumberHandles];
+    alignas(cmsghdr) Byte control[CMSG_SPACE(sizeof(handles))];
+    iovec responseVector { responseHeader, sizeof(responseHeader) };
+    msghdr message {};
+    message.msg_iov = &responseVector;
+    message.msg_iovlen = 1u;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    ssize_t receiveResult;
+
+    do
+    {
+        receiveResult = recvmsg(p_Connection.m_Handle, &message, MSG_WAITALL | MSG_CMSG_CLOEXEC);
+    }
+    while (receiveResult < 0 && errno == EINTR);
+
+    const cmsghdr* controlHeader = receiveResult > 0 ?
+        CMSG_FIRSTHDR(&message) :
+        nullptr;
+    bool hasHandles = false;
+
+    if (controlHeader != nullptr &&
+        controlHeader->cmsg_level == SOL_SOCKET &&
+        controlHeader->cmsg_type == SCM_RIGHTS)
+    {
+        //
+        // Take ownership of whatever was passed, so that nothing leaks on a malformed response.
+        //
+        const size_t numberHandles = (controlHeader->cmsg_len - CMSG_LEN(0)) / sizeof(FileDescriptor);
+        std::vector<FileDescriptor> receivedHandles(numberHandles);
+        std::memcpy(receivedHandles.data(), CMSG_DATA(controlHeader), numberHandles * sizeof(FileDescriptor));
+
+        hasHandles = numberHandles == SharedMemoryChannel::c_NumberHandles;
+
+        if (hasHandles)
+        {
+            std::copy(receivedHandles.begin(), receivedHandles.end(), handles);
+        }
+        else
+        {
+            for (const FileDescriptor handle : receivedHandles)
+            {
+                close(handle);
+            }
+        }
+    }
+
+    if (receiveResult != static_cast<ssize_t>(sizeof(responseHeader)))
+    {
+        if (hasHandles)
+        {
+            for (const FileDescriptor handle : handles)
+            {
+                close(handle);
+            }
+        }
+
+        return Status::ConnectionLost;
+    }
+
+    DataTransmissionFrameHeader frameHeader;
+    StatusCode remoteStatus;
+    status = DataTransmissionProtocol::DeserializeResponseHeader(responseHeader, frameHeader, remoteStatus);
+
+    if (Status::Succeeded(status) &&
+        (frameHeader.m_PacketTag != SharedMemoryChannel::c_SetupPacketTag ||
+        frameHeader.m_PayloadSize != 0))
+    {
+        status = Status::InvalidFrame;
+    }
+
+    if (Status::Succeeded(status))
+    {
+        //
+        // The server refused the channel, for instance because it has them disabled.
+        //
+        status = remoteStatus;
+    }
+
+    if (Status::Succeeded(status) &&
+        !hasHandles)
+    {
+        status = Status::InvalidFrame;
+    }
+
+    if (Status::Failed(status))
+    {
+        if (hasHandles)
+        {
+            for (const FileDescriptor handle : handles)
+            {
+                close(handle);
+            }
+        }
+
+        return status;
+    }
+
+    try
+    {
+        p_Connection.m_Channel = std::make_unique<SharedMemoryChannel>();
+    }
+    catch (const std::bad_alloc& e)
+    {
+        for (const FileDescriptor handle : handles)
+        {
+            close(handle);
+        }
+
+        return Status::OutOfMemory;
+    }
+
+    status = p_Connection.m_Channel->Attach(handles[0], handles[1], handles[2]);
+
+    if (Status::Failed(status))
+    {
+        p_Connection.m_Channel.reset();
+    }
+
+    return status;
+}
+
+uint32_t
+DataTransmissionClient::SerializeRequestHeader(
+    const PacketTag p_PacketTag,
+    const std::string& p_Packet,
+    Byte* p_Buffer) const
+{
+    DataTransmissionFrameHeader header;
+    header.m_Magic = DataTransmissionFrameHeader::c_Magic;
+    header.m_Version = DataTransmissionFrameHeader::c_Version;
+    header.m_Flags = 0u;
+    header.m_PacketTag = p_PacketTag;
+    header.m_PayloadSize = static_cast<uint32_t>(p_Packet.size());
+    header.m_Checksum = 0;
+    header.m_DeadlineMicroseconds = 0;
+
+    if (m_EnableChecksums)
+    {
+        header.m_Flags |= DataTransmissionFrameHeader::c_FlagChecksum;
+        header.m_Checksum = Crc32c::Compute(reinterpret_cast<const Byte*>(p_Packet.data()), p_Packet.size());
+    }
+
+    if (m_EnableDeadlines &&
+        m_TimeoutMilliseconds != 0)
+    {
+        //
+        // The response is given up on once a receive times out, so the timeout is the budget of the request.
+        //
+        header.m_Flags |= DataTransmissionFrameHeader::c_FlagDeadline;
+        header.m_DeadlineMicroseconds = static_cast<uint32_t>(std::min<uint64_t>(m_TimeoutMilliseconds * 1000ull, UINT32_MAX));
+    }
+
+    DataTransmissionProtocol::SerializeFrameHeader(header, p_Buffer);
+
+    return DataTransmissionProtocol::GetHeaderSize(header.m_Flags);
+}
+
+StatusCode
+DataTransmissionClient::WriteRequests(
+    Connection& p_Connection,
+    const DataTransmissionRequest* p_Requests,
+    const size_t p_NumberRequests)
+{
+    std::vector<Byte> headers(p_NumberRequests * DataTransmissionProtocol::c_MaxHeaderSize);
+    std::vector<iovec> vector(p_NumberRequests * 2);
+
+    for (size_t requestIndex = 0; requestIndex < p_NumberRequests; ++requestIndex)
+    {
+        const DataTransmissionRequest& request = p_Requests[requestIndex];
+        Byte* header = headers.data() + requestIndex * DataTransmissionProtocol::c_MaxHeaderSize;
+        const uint32_t headerSize = SerializeRequestHeader(request.m_PacketTag, request.m_Packet, header);
+
+        vector[requestIndex * 2] = { header, headerSize };
+        vector[requestIndex * 2 + 1] = { const_cast<char*>(request.m_Packet.data()), request.m_Packet.size() };
+    }
+
+    return SendVector(p_Connection, vector.data(), vector.size());
+}
+
+StatusCode
+DataTransmissionClient::ReadResponse(
+    Connection& p_Connection,
+    const PacketTag p_PacketTag,
+    DataTransmissionResponse& p_Response)
+{
+    Byte responseHeader[DataTransmissionProtocol::c_ResponseHeaderSize];
+    StatusCode status = ReceiveExact(p_Connection, responseHeader, sizeof(responseHeader));
+
+    if (Status::Failed(status))
+    {
+        return status;
+    }
+
+    DataTransmissionFrameHeader header;
+    status = DataTransmissionProtocol::DeserializeResponseHeader(responseHeader, header, p_Response.m_Status);
+
+    if (Status::Failed(status))
+    {
+        return status;
+    }
+
+    if (header.m_PacketTag != p_PacketTag)
+    {
+        //
+        // Responses are written in request order; a mismatch means the stream is out of sync.
+        //
+        return Status::InvalidFrame;
+    }
+
+    if (header.m_PayloadSize > m_MaxPacketSize)
+    {
+        return Status::PacketTooLarge;
+    }
+
+    try
+    {
+        p_Response.m_Payload.resize(header.m_PayloadSize);
+    }
+    catch (const std::bad_alloc& e)
+    {
+        return Status::OutOfMemory;
+    }
+
+    return ReceiveExact(p_Connection, reinterpret_cast<Byte*>(p_Response.m_Payload.data()), header.m_PayloadSize);
+}
+
+StatusCode
+DataTransmissionClient::ReceiveExact(
+    Connection& p_Connection,
+    Byte* p_Buffer,
+    uint32_t p_Size)
+{
+    while (p_Size != 0)
+    {
+        if (p_Connection.m_ReceiveOffset == p_Connection.m_ReceiveSize)
+        {
+            if (p_Size >= m_ReceiveBufferSize)
+            {
+                //
+                // Large payload; read it directly into the destination.
+                //
+                uint32_t numberBytesReceived;
+                const StatusCode status = Receive(p_Connection, p_Buffer, p_Size, numberBytesReceived);
+
+                if (Status::Failed(status))
+                {
+                    return status;
+                }
+
+                p_Buffer += numberBytesReceived;
+                p_Size -= numberBytesReceived;
+
+                continue;
+            }
+
+            //
+            // Refill the connection buffer, which batches several small responses per system call.
+            //
+            const StatusCode status = Receive(p_Connection, p_Connection.m_ReceiveBuffer.get(), m_ReceiveBufferSize, p_Connection.m_ReceiveSize);
+
+            if (Status::Failed(status))
+            {
+                p_Connection.m_ReceiveSize = 0;
+
+                return status;
+            }
+
+            p_Connection.m_ReceiveOffset = 0;
+        }
+
+        const uint32_t numberBytesCopied = std::min(p_Size, p_Connection.m_ReceiveSize - p_Connection.m_ReceiveOffset);
+        std::memcpy(p_Buffer, p_Connection.m_ReceiveBuffer.get() + p_Connection.m_ReceiveOffset, numberBytesCopied);
+
+        p_Connection.m_ReceiveOffset += numberBytesCopied;
+        p_Buffer += numberBytesCopied;
+        p_Size -= numberBytesCopied;
+    }
+
+    return Status::Success;
+}
+
+StatusCode
+DataTransmissionClient::Receive(
+    Connection& p_Connection,
+    Byte* p_Buffer,
+    const uint32_t p_Size,
+    uint32_t& p_NumberBytesReceived)
+{
+    FOREVER
+    {
+        if (p_Connection.m_Channel)
+        {
+            SharedMemoryRing& ring = p_Connection.m_Channel->GetResponseRing();
+            p_NumberBytesReceived = static_cast<uint32_t>(ring.Read(p_Buffer, p_Size));
+
+            if (p_NumberBytesReceived == 0)
+            {
+                const StatusCode status = WaitForChannel(p_Connection, false);
+
+                if (Status::Failed(status))
+                {
+                    return status;
+                }
+
+                continue;
+            }
+
+            if (ring.ShouldWakeProducer())
+            {
+                SharedMemoryChannel::Notify(p_Connection.m_Channel->GetServerDoorbellHandle());
+            }
+
+            return Status::Success;
+        }
+
+        const ssize_t readResult = recv(p_Connection.m_Handle, p_Buffer, p_Size, 0);
+
+        if (readResult < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (readResult <= 0)
+        {
+            return Status::ConnectionLost;
+        }
+
+        p_NumberBytesReceived = static_cast<uint32_t>(readResult);
+
+        return Status::Success;
+    }
+}
+
+StatusCode
+DataTransmissionClient::SendVector(
+    Connection& p_Connection,
+    iovec* p_Vector,
+    size_t p_VectorSize)
+{
+    while (p_VectorSize != 0)
+    {
+        ssize_t sendResult;
+
+        if (p_Connection.m_Channel)
+        {
+            SharedMemoryRing& ring = p_Connection.m_Channel->GetRequestRing();
+            sendResult = static_cast<ssize_t>(ring.Write(p_Vector, p_VectorSize));
+
+            if (sendResult == 0)
+            {
+                const StatusCode status = WaitForChannel(p_Connection, true);
+
+                if (Status::Failed(status))
+                {
+                    return status;
+                }
+
+                continue;
+            }
+
+            if (ring.ShouldWakeConsumer())
+            {
+                SharedMemoryChannel::Notify(p_Connection.m_Channel->GetServerDoorbellHandle());
+            }
+        }
+        else
+        {
+            msghdr message {};
+            message.msg_iov = p_Vector;
+            message.msg_iovlen = std::min<size_t>(p_VectorSize, IOV_MAX);
+
+            sendResult = sendmsg(p_Connection.m_Handle, &message, MSG_NOSIGNAL);
+        }
+
+        if (sendResult < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            return Status::ConnectionLost;
+        }
+
+        //
+        // Skip the fully sent entries and adjust the partially sent one.
+        //
+        size_t numberBytesSent = static_cast<size_t>(sendResult);
+
+        while (p_VectorSize != 0 &&
+            numberBytesSent >= p_Vector->iov_len)
+        {
+            numberBytesSent -= p_Vector->iov_len;
+            ++p_Vector;
+            --p_VectorSize;
+        }
+
+        if (p_VectorSize != 0)
+        {
+            p_Vector->iov_base = static_cast<Byte*>(p_Vector->iov_base) + numberBytesSent;
+            p_Vector->iov_len -= numberBytesSent;
+        }
+    }
+
+    return Status::Success;
+}
+
+StatusCode
+DataTransmissionClient::WaitForChannel(
+    Connection& p_Connection,
+    const bool p_IsWriting)
+{
+    SharedMemoryChannel& channel = *p_Connection.m_Channel;
+    SharedMemoryRing& ring = p_IsWriting ?
+        channel.GetRequestRing() :
+        channel.GetResponseRing();
+
+    const auto isReady = [&ring, p_IsWriting]()
+    {
+        return p_IsWriting ?
+            ring.GetWritableSize() != 0 :
+            ring.GetReadableSize() != 0;
+    };
+
+    //
+    // The server usually answers within a few microseconds; yielding rather than pausing keeps
+    // the spin from starving it when both share a core.
+    //
+    for (uint32_t spinIndex = 0; spinIndex < c_NumberChannelSpinIterations; ++spinIndex)
+    {
+        if (isReady())
+        {
+            return Status::Success;
+        }
+
+        std::this_thread::yield();
+    }
+
+    const bool shouldSleep = p_IsWriting ?
+        ring.PrepareProducerWait() :
+        ring.PrepareConsumerWait();
+
+    if (!shouldSleep)
+    {
+        return Status::Success;
+    }
+
+    //
+    // Sleep on the doorbell. The socket carries nothing after the setup, so any event on it means the server is gone.
+    //
+    pollfd handles[2] =
+    {
+        { channel.GetClientDoorbellHandle(), POLLIN, 0 },
+        { p_Connection.m_Handle, POLLIN, 0 }
+    };
+
+    const int32_t pollResult = poll(handles, 2u, m_TimeoutMilliseconds != 0 ? static_cast<int32_t>(m_TimeoutMilliseconds) : -1);
+
+    if (pollResult < 0 && errno == EINTR)
+    {
+        return Status::Success;
+    }
+
+    if (pollResult <= 0 ||
+        handles[1].revents != 0)
+    {
+        return Status::ConnectionLost;
+    }
+
+    SharedMemoryChannel::ClearNotifications(channel.GetClientDoorbellHandle());
+
+    return Status::Success;
+}
+
+DataTransmissionClient::Connection::Connection(
+    const FileDescriptor p_Handle,
+    const uint32_t p_ReceiveBufferSize)
+    : m_Handle(p_Handle),
+      m_ReceiveBuffer(new Byte[p_ReceiveBufferSize]),
+      m_ReceiveOffset(0),
+      m_ReceiveSize(0),
+      m_ReleaseTime(std::chrono::steady_clock::now())
+{}
+
+DataTransmissionClient::Connection::~Connection()
+{
+    close(m_Handle);
+}
+
+} // namespace gX.
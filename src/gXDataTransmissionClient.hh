@@ -0,0 +1,516 @@
+// *************************************
+// Ganymede Xpedia
+// gXDTP (Data Transmission Protocol)
+// 'gXDataTransmissionClient.hh'
+// Author: jcjuarez
+// *************************************
+
+#ifndef GX_DATA_TRANSMISSION_CLIENT_
+#define GX_DATA_TRANSMISSION_CLIENT_
+
+#include <mutex>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <memory>
+#include <future>
+#include <cstdint>
+#include "gXStatus.hh"
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "gXThreadPool.hh"
+#include <condition_variable>
+#include "gXSharedMemoryChannel.hh"
+#include "gXDataTransmissionProtocol.hh"
+
+namespace gX
+{
+
+//
+// Request to be sent to a DTP server.
+//
+struct DataTransmissionRequest
+{
+
+    //
+    // Packet tag of the endpoint to execute.
+    //
+    PacketTag m_PacketTag;
+
+    //
+    // Request payload.
+    //
+    std::string m_Packet;
+
+};
+
+//
+// Response received from a DTP server.
+//
+struct DataTransmissionResponse
+{
+
+    //
+    // Status of the request. Either the status returned by the remote endpoint
+    // or a local failure if the request could not be transmitted.
+    //
+    StatusCode m_Status;
+
+    //
+    // Response payload.
+    //
+    std::string m_Payload;
+
+};
+
+//
+// Configurations for the DTP client.
+//
+struct DataTransmissionClientConfiguration
+{
+
+    //
+    // Constructor.
+    //
+    DataTransmissionClientConfiguration();
+
+    //
+    // Host name or address of the DTP server.
+    //
+    std::string m_Host;
+
+    //
+    // Port of the DTP server.
+    //
+    uint32_t m_Port;
+
+    //
+    // Path of the AF_UNIX socket of a server on the same host, connected to instead of the host and port.
+    // A leading '@' refers to the abstract namespace. Empty means TCP.
+    //
+    std::string m_UnixSocketPath;
+
+    //
+    // Whether each connection over the AF_UNIX socket sets up a shared memory channel with the server and
+    // exchanges its frames through it, bypassing the socket layer. Requires an AF_UNIX socket path.
+    //
+    bool m_EnableSharedMemory;
+
+    //
+    // Maximum number of connections kept open to the server.
+    // Callers block waiting for a connection when all of them are in use.
+    //
+    uint16_t m_MaxNumberConnections;
+
+    //
+    // Number of connections established upfront during initialization.
+    //
+    uint16_t m_NumberWarmConnections;
+
+    //
+    // Number of threads executing asynchronous requests.
+    //
+    uint16_t m_ThreadPoolSize;
+
+    //
+    // Maximum number of requests written ahead of their responses when pipelining a batch.
+    // Must not exceed the in-flight request limit of the server.
+    //
+    uint16_t m_MaxNumberInFlightRequests;
+
+    //
+    // Receive buffer size of each connection.
+    //
+    uint32_t m_ReceiveBufferSize;
+
+    //
+    // Maximum response payload size accepted from the server.
+    //
+    uint32_t m_MaxPacketSize;
+
+    //
+    // Send and receive timeout for each socket operation. Zero disables the timeout.
+    //
+    uint32_t m_TimeoutMilliseconds;
+
+    //
+    // Whether requests carry a CRC32C of their payload, which the server verifies before dispatching them.
+    //
+    bool m_EnableChecksums;
+
+    //
+    // Whether requests carry the timeout as their deadline, so that the server drops the requests the client
+    // stopped waiting for instead of executing them. Has no effect without a timeout.
+    //
+    bool m_EnableDeadlines;
+
+    //
+    // Default host.
+    //
+    static constexpr const char* c_DefaultHost = "127.0.0.1";
+
+    //
+    // Default port.
+    //
+    static constexpr uint32_t c_DefaultPortNumber = 9090u;
+
+    //
+    // Default maximum number of connections.
+    //
+    static constexpr uint16_t c_DefaultMaxNumberConnections = 8u;
+
+    //
+    // Default number of warm connections.
+    //
+    static constexpr uint16_t c_DefaultNumberWarmConnections = 1u;
+
+    //
+    // Default thread pool size.
+    //
+    static constexpr uint16_t c_DefaultThreadPoolSize = 8u;
+
+    //
+    // Default maximum number of in-flight requests per connection.
+    //
+    static constexpr uint16_t c_DefaultMaxNumberInFlightRequests = 32u;
+
+    //
+    // Default receive buffer size.
+    //
+    static constexpr uint32_t c_DefaultReceiveBufferSize = 4096u;
+
+    //
+    // Default maximum packet size.
+    //
+    static constexpr uint32_t c_DefaultMaxPacketSize = 1u << 20;
+
+    //
+    // Default socket operation timeout.
+    //
+    static constexpr uint32_t c_DefaultTimeoutMilliseconds = 5000u;
+
+    //
+    // Default checksum setting.
+    //
+    static constexpr bool c_DefaultEnableChecksums = false;
+
+    //
+    // Default deadline setting.
+    //
+    static constexpr bool c_DefaultEnableDeadlines = false;
+
+    //
+    // Default shared memory setting.
+    //
+    static constexpr bool c_DefaultEnableSharedMemory = false;
+
+};
+
+//
+// DTP client keeping a pool of persistent connections to a single server.
+// All methods are thread-safe.
+//
+class DataTransmissionClient
+{
+
+public:
+
+    //
+    // Constructor.
+    //
+    DataTransmissionClient();
+
+    //
+    // Destructor. Waits for asynchronous requests to finish and closes all connections.
+    //
+    ~DataTransmissionClient();
+
+    //
+    // Initializes the client and establishes the warm connections.
+    //
+    StatusCode
+    Init(
+        const DataTransmissionClientConfiguration* p_Configuration = nullptr);
+
+    //
+    // Sends a request and waits for its response.
+    // Returns the transmission status; the endpoint status is placed in the response.
+    //
+    StatusCode
+    Send(
+        const PacketTag p_PacketTag,
+        const std::string& p_Packet,
+        DataTransmissionResponse& p_Response);
+
+    //
+    // Sends a request asynchronously. Transmission failures are reported through the response status.
+    //
+    std::future<DataTransmissionResponse>
+    SendAsync(
+        const PacketTag p_PacketTag,
+        std::string p_Packet);
+
+    //
+    // Pipelines a batch of requests over a single connection and waits for all their responses,
+    // which are placed in the same order as the requests.
+    //
+    StatusCode
+    SendBatch(
+        const std::vector<DataTransmissionRequest>& p_Requests,
+        std::vector<DataTransmissionResponse>& p_Responses);
+
+private:
+
+    //
+    // Connection to the server.
+    //
+    struct Connection
+    {
+
+        //
+        // Constructor.
+        //
+        Connection(
+            const FileDescriptor p_Handle,
+            const uint32_t p_ReceiveBufferSize);
+
+        //
+        // Destructor. Closes the connection handle.
+        //
+        ~Connection();
+
+        //
+        // Connection socket handle.
+        //
+        FileDescriptor m_Handle;
+
+        //
+        // Shared memory channel frames are exchanged through instead of the socket. Null if not set up.
+        //
+        std::unique_ptr<SharedMemoryChannel> m_Channel;
+
+        //
+        // Buffer for incoming response data.
+        //
+        std::unique_ptr<Byte[]> m_ReceiveBuffer;
+
+        //
+        // Offset of the first unconsumed byte in the receive buffer.
+        //
+        uint32_t m_ReceiveOffset;
+
+        //
+        // Number of valid bytes in the receive buffer.
+        //
+        uint32_t m_ReceiveSize;
+
+        //
+        // Time the connection was last returned to the pool.
+        //
+        std::chrono::steady_clock::time_point m_ReleaseTime;
+
+    };
+
+    //
+    // Takes an idle connection from the pool, establishing a new one if none is available
+    // and the connection limit allows it. Otherwise waits for a connection to be released.
+    //
+    StatusCode
+    AcquireConnection(
+        std::unique_ptr<Connection>& p_Connection);
+
+    //
+    // Returns a connection to the pool. Connections in an unknown protocol state are closed instead.
+    //
+    void
+    ReleaseConnection(
+        std::unique_ptr<Connection>&& p_Connection,
+        const bool p_IsReusable);
+
+    //
+    // Determines whether a pooled connection is still open. Connections pooled for long are checked
+    // for having been closed by the server meanwhile, as it does with idle connections.
+    //
+    static
+    bool
+    IsConnectionOpen(
+        const Connection& p_Connection);
+
+    //
+    // Establishes a new connection to the server.
+    //
+    StatusCode
+    Connect(
+        std::unique_ptr<Connection>& p_Connection);
+
+    //
+    // Sets up a shared memory channel over a fresh AF_UNIX connection.
+    //
+    StatusCode
+    OpenSharedMemoryChannel(
+        Connection& p_Connection);
+
+    //
+    // Serializes the header of a request into the buffer, which must hold at least c_MaxHeaderSize bytes.
+    // Returns the size of the serialized header.
+    //
+    uint32_t
+    SerializeRequestHeader(
+        const PacketTag p_PacketTag,
+        const std::string& p_Packet,
+        Byte* p_Buffer) const;
+
+    //
+    // Writes a sequence of requests to the connection with vectored I/O.
+    //
+    StatusCode
+    WriteRequests(
+        Connection& p_Connection,
+        const DataTransmissionRequest* p_Requests,
+        const size_t p_NumberRequests);
+
+    //
+    // Reads the next response from the connection and validates it against the request tag.
+    //
+    StatusCode
+    ReadResponse(
+        Connection& p_Connection,
+        const PacketTag p_PacketTag,
+        DataTransmissionResponse& p_Response);
+
+    //
+    // Reads exactly the specified number of bytes from the connection.
+    //
+    StatusCode
+    ReceiveExact(
+        Connection& p_Connection,
+        Byte* p_Buffer,
+        uint32_t p_Size);
+
+    //
+    // Reads at least one and up to the specified number of bytes from the socket or channel of the connection.
+    //
+    StatusCode
+    Receive(
+        Connection& p_Connection,
+        Byte* p_Buffer,
+        const uint32_t p_Size,
+        uint32_t& p_NumberBytesReceived);
+
+    //
+    // Sends all the data described by the I/O vector, handling partial writes.
+    //
+    StatusCode
+    SendVector(
+        Connection& p_Connection,
+        iovec* p_Vector,
+        size_t p_VectorSize);
+
+    //
+    // Waits until the response ring of the channel has data or, for writers, the request ring has room.
+    // Spins briefly before sleeping on the client doorbell. Fails if the server closes the connection
+    // or the timeout expires.
+    //
+    StatusCode
+    WaitForChannel(
+        Connection& p_Connection,
+        const bool p_IsWriting);
+
+    //
+    // Determines if the client has already been initialized.
+    //
+    bool m_IsInitialized;
+
+    //
+    // Server address information, either IPv4 or AF_UNIX.
+    //
+    sockaddr_storage m_Address;
+
+    //
+    // Size of the server address information.
+    //
+    socklen_t m_AddressLength;
+
+    //
+    // Maximum number of connections kept open to the server.
+    //
+    uint16_t m_MaxNumberConnections;
+
+    //
+    // Maximum number of requests written ahead of their responses.
+    //
+    uint16_t m_MaxNumberInFlightRequests;
+
+    //
+    // Receive buffer size of each connection.
+    //
+    uint32_t m_ReceiveBufferSize;
+
+    //
+    // Maximum response payload size accepted from the server.
+    //
+    uint32_t m_MaxPacketSize;
+
+    //
+    // Socket operation timeout.
+    //
+    uint32_t m_TimeoutMilliseconds;
+
+    //
+    // Whether requests carry a checksum of their payload.
+    //
+    bool m_EnableChecksums;
+
+    //
+    // Whether requests carry the timeout as their deadline.
+    //
+    bool m_EnableDeadlines;
+
+    //
+    // Whether connections set up a shared memory channel.
+    //
+    bool m_EnableSharedMemory;
+
+    //
+    // Exclusive lock for synchronizing access to the connection pool.
+    //
+    std::mutex m_PoolLock;
+
+    //
+    // Condition for awakening callers waiting for a connection.
+    //
+    std::condition_variable m_PoolCondition;
+
+    //
+    // Idle connections ready to be reused.
+    //
+    std::vector<std::unique_ptr<Connection>> m_IdleConnections;
+
+    //
+    // Number of connections currently open, both idle and in use.
+    //
+    uint16_t m_NumberOpenConnections;
+
+    //
+    // Thread pool executing asynchronous requests.
+    // Declared last so that pending requests finish before the pool state is destroyed.
+    //
+    ThreadPool m_ThreadPool;
+
+    //
+    // Number of times a channel is polled, yielding in between, before sleeping on its doorbell.
+    // Covers the turnaround of short requests, which would otherwise pay for two wakeups.
+    //
+    static constexpr uint32_t c_NumberChannelSpinIterations = 256u;
+
+    //
+    // Time a connection may stay pooled before being checked for closure on reuse.
+    // Shorter idle periods are trusted, to keep the check off the path of busy clients.
+    //
+    static constexpr uint32_t c_ConnectionCheckIntervalMilliseconds = 1000u;
+
+};
+
+} // namespace gX.
+
+#endif
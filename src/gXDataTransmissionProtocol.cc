@@ -0,0 +1,167 @@
+// *************************************
+// Ganymede Xpedia
+// gXDTP (Data Transmission Protocol)
+// 'gXDataTransmissionProtocol.cc'
+// Author: jcjuarez
+// *************************************
+
+#include <cstring>
+#include <netinet/in.h>
+#include "gXDataTransmissionProtocol.hh"
+
+namespace gX
+{
+
+uint32_t
+DataTransmissionProtocol::GetHeaderSize(
+    const uint8_t p_Flags)
+{
+    uint32_t headerSize = DataTransmissionFrameHeader::c_SerializedSize;
+
+    if (p_Flags & DataTransmissionFrameHeader::c_FlagChecksum)
+    {
+        headerSize += DataTransmissionFrameHeader::c_ChecksumSize;
+    }
+
+    if (p_Flags & DataTransmissionFrameHeader::c_FlagDeadline)
+    {
+        headerSize += DataTransmissionFrameHeader::c_DeadlineSize;
+    }
+
+    return headerSize;
+}
+
+void
+DataTransmissionProtocol::SerializeFrameHeader(
+    const DataTransmissionFrameHeader& p_Header,
+    Byte* p_Buffer)
+{
+    const uint16_t magic = htons(p_Header.m_Magic);
+    const uint32_t packetTag = htonl(p_Header.m_PacketTag);
+    const uint32_t payloadSize = htonl(p_Header.m_PayloadSize);
+
+    std::memcpy(p_Buffer, &magic, sizeof(magic));
+    p_Buffer[2] = p_Header.m_Version;
+    p_Buffer[3] = p_Header.m_Flags;
+    std::memcpy(p_Buffer + 4, &packetTag, sizeof(packetTag));
+    std::memcpy(p_Buffer + 8, &payloadSize, sizeof(payloadSize));
+
+    Byte* extension = p_Buffer + DataTransmissionFrameHeader::c_SerializedSize;
+
+    if (p_Header.m_Flags & DataTransmissionFrameHeader::c_FlagChecksum)
+    {
+        const uint32_t checksum = htonl(p_Header.m_Checksum);
+        std::memcpy(extension, &checksum, sizeof(checksum));
+        extension += DataTransmissionFrameHeader::c_ChecksumSize;
+    }
+
+    if (p_Header.m_Flags & DataTransmissionFrameHeader::c_FlagDeadline)
+    {
+        const uint32_t deadline = htonl(p_Header.m_DeadlineMicroseconds);
+        std::memcpy(extension, &deadline, sizeof(deadline));
+    }
+}
+
+StatusCode
+DataTransmissionProtocol::DeserializeFrameHeader(
+    const Byte* p_Buffer,
+    DataTransmissionFrameHeader& p_Header)
+{
+    uint16_t magic;
+    uint32_t packetTag;
+    uint32_t payloadSize;
+
+    std::memcpy(&magic, p_Buffer, sizeof(magic));
+    std::memcpy(&packetTag, p_Buffer + 4, sizeof(packetTag));
+    std::memcpy(&payloadSize, p_Buffer + 8, sizeof(payloadSize));
+
+    p_Header.m_Magic = ntohs(magic);
+    p_Header.m_Version = p_Buffer[2];
+    p_Header.m_Flags = p_Buffer[3];
+    p_Header.m_PacketTag = ntohl(packetTag);
+    p_Header.m_PayloadSize = ntohl(payloadSize);
+
+    if (p_Header.m_Magic != DataTransmissionFrameHeader::c_Magic ||
+        p_Header.m_Version != DataTransmissionFrameHeader::c_Version)
+    {
+        return Status::InvalidFrame;
+    }
+
+    return Status::Success;
+}
+
+void
+DataTransmissionProtocol::DeserializeHeaderExtensions(
+    const Byte* p_Buffer,
+    DataTransmissionFrameHeader& p_Header)
+{
+    const Byte* extension = p_Buffer + DataTransmissionFrameHeader::c_SerializedSize;
+
+    p_Header.m_Checksum = 0;
+    p_Header.m_DeadlineMicroseconds = 0;
+
+    if (p_Header.m_Flags & DataTransmissionFrameHeader::c_FlagChecksum)
+    {
+        uint32_t checksum;
+        std::memcpy(&checksum, extension, sizeof(checksum));
+
+        p_Header.m_Checksum = ntohl(checksum);
+        extension += DataTransmissionFrameHeader::c_ChecksumSize;
+    }
+
+    if (p_Header.m_Flags & DataTransmissionFrameHeader::c_FlagDeadline)
+    {
+        uint32_t deadline;
+        std::memcpy(&deadline, extension, sizeof(deadline));
+
+        p_Header.m_DeadlineMicroseconds = ntohl(deadline);
+    }
+}
+
+void
+DataTransmissionProtocol::SerializeResponseHeader(
+    const PacketTag p_PacketTag,
+    const StatusCode p_Status,
+    const uint32_t p_PayloadSize,
+    Byte* p_Buffer)
+{
+    DataTransmissionFrameHeader header;
+    header.m_Magic = DataTransmissionFrameHeader::c_Magic;
+    header.m_Version = DataTransmissionFrameHeader::c_Version;
+    header.m_Flags = DataTransmissionFrameHeader::c_FlagResponse;
+    header.m_PacketTag = p_PacketTag;
+    header.m_PayloadSize = p_PayloadSize;
+    header.m_Checksum = 0;
+    header.m_DeadlineMicroseconds = 0;
+
+    SerializeFrameHeader(header, p_Buffer);
+
+    const StatusCode status = htonl(p_Status);
+    std::memcpy(p_Buffer + DataTransmissionFrameHeader::c_SerializedSize, &status, sizeof(status));
+}
+
+StatusCode
+DataTransmissionProtocol::DeserializeResponseHeader(
+    const Byte* p_Buffer,
+    DataTransmissionFrameHeader& p_Header,
+    StatusCode& p_Status)
+{
+    const StatusCode status = DeserializeFrameHeader(p_Buffer, p_Header);
+
+    if (Status::Failed(status))
+    {
+        return status;
+    }
+
+    if (!(p_Header.m_Flags & DataTransmissionFrameHeader::c_FlagResponse))
+    {
+        return Status::InvalidFrame;
+    }
+
+    std::memcpy(&p_Status, p_Buffer + DataTransmissionFrameHeader::c_SerializedSize, sizeof(p_Status));
+    p_Status = ntohl(p_Status);
+
+    return Status::Success;
+}
+
+} // namespace gX.
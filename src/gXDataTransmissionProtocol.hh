@@ -0,0 +1,207 @@
+// *************************************
+// Ganymede Xpedia
+// gXDTP (Data Transmission Protocol)
+// 'gXDataTransmissionProtocol.hh'
+// Author: jcjuarez
+// *************************************
+
+#ifndef GX_DATA_TRANSMISSION_PROTOCOL_
+#define GX_DATA_TRANSMISSION_PROTOCOL_
+
+#include <cstdint>
+#include "gXStatus.hh"
+
+namespace gX
+{
+
+//
+// DTP packet type alias.
+//
+using PacketTag = uint32_t;
+
+//
+// DTP frame header. Every request and response on the wire starts with this header,
+// serialized in network byte order and followed by exactly m_PayloadSize bytes of payload.
+//
+// Wire layout (12 bytes):
+//   [0..1]  Magic.
+//   [2]     Version.
+//   [3]     Flags.
+//   [4..7]  Packet tag.
+//   [8..11] Payload size.
+//
+// Request headers are followed by optional extension fields, present only when their flag is set
+// and laid out in ascending order of their flags:
+//   Checksum (4 bytes): CRC32C of the payload.
+//   Deadline (4 bytes): time budget of the request in microseconds, counted from when the server decodes it.
+//
+struct DataTransmissionFrameHeader
+{
+
+    //
+    // Frame magic; always c_Magic for valid frames.
+    //
+    uint16_t m_Magic;
+
+    //
+    // Protocol version of the frame.
+    //
+    uint8_t m_Version;
+
+    //
+    // Frame flags.
+    //
+    uint8_t m_Flags;
+
+    //
+    // Packet tag used for resolving the endpoint to execute.
+    //
+    PacketTag m_PacketTag;
+
+    //
+    // Size of the payload following the header.
+    //
+    uint32_t m_PayloadSize;
+
+    //
+    // CRC32C of the payload. Only meaningful if c_FlagChecksum is set.
+    //
+    uint32_t m_Checksum;
+
+    //
+    // Time budget of the request in microseconds. Only meaningful if c_FlagDeadline is set.
+    //
+    uint32_t m_DeadlineMicroseconds;
+
+    //
+    // Frame magic ('gX').
+    //
+    static constexpr uint16_t c_Magic = 0x6758u;
+
+    //
+    // Current protocol version.
+    //
+    static constexpr uint8_t c_Version = 1u;
+
+    //
+    // Set on frames sent from the server back to the client.
+    //
+    static constexpr uint8_t c_FlagResponse = 0x01u;
+
+    //
+    // Set on requests carrying the checksum extension; the payload is verified before being dispatched.
+    //
+    static constexpr uint8_t c_FlagChecksum = 0x02u;
+
+    //
+    // Set on requests carrying the deadline extension; the request is dropped if its budget runs out before it executes.
+    // The budget is relative so that the client and server clocks need not agree.
+    //
+    static constexpr uint8_t c_FlagDeadline = 0x04u;
+
+    //
+    // Size of the serialized header, without extensions.
+    //
+    static constexpr uint32_t c_SerializedSize = 12u;
+
+    //
+    // Size of the serialized checksum extension.
+    //
+    static constexpr uint32_t c_ChecksumSize = 4u;
+
+    //
+    // Size of the serialized deadline extension.
+    //
+    static constexpr uint32_t c_DeadlineSize = 4u;
+
+};
+
+//
+// Static class for serializing and deserializing DTP frames.
+//
+class DataTransmissionProtocol
+{
+
+    //
+    // Static class.
+    //
+    DataTransmissionProtocol() = delete;
+
+public:
+
+    //
+    // Returns the size of a serialized request header with the specified flags, extensions included.
+    //
+    static
+    uint32_t
+    GetHeaderSize(
+        const uint8_t p_Flags);
+
+    //
+    // Serializes a frame header along with the extensions its flags call for into the buffer,
+    // which must hold at least GetHeaderSize bytes.
+    //
+    static
+    void
+    SerializeFrameHeader(
+        const DataTransmissionFrameHeader& p_Header,
+        Byte* p_Buffer);
+
+    //
+    // Deserializes and validates a frame header from the buffer, which must hold at least c_SerializedSize bytes.
+    // Extensions are not read; see DeserializeHeaderExtensions.
+    //
+    static
+    StatusCode
+    DeserializeFrameHeader(
+        const Byte* p_Buffer,
+        DataTransmissionFrameHeader& p_Header);
+
+    //
+    // Deserializes the extensions flagged in an already deserialized header from the buffer,
+    // which must hold at least GetHeaderSize bytes.
+    //
+    static
+    void
+    DeserializeHeaderExtensions(
+        const Byte* p_Buffer,
+        DataTransmissionFrameHeader& p_Header);
+
+    //
+    // Serializes a response header: a frame header flagged as response followed by the status code.
+    // The buffer must hold at least c_ResponseHeaderSize bytes.
+    //
+    static
+    void
+    SerializeResponseHeader(
+        const PacketTag p_PacketTag,
+        const StatusCode p_Status,
+        const uint32_t p_PayloadSize,
+        Byte* p_Buffer);
+
+    //
+    // Deserializes and validates a response header from the buffer, which must hold at least c_ResponseHeaderSize bytes.
+    //
+    static
+    StatusCode
+    DeserializeResponseHeader(
+        const Byte* p_Buffer,
+        DataTransmissionFrameHeader& p_Header,
+        StatusCode& p_Status);
+
+    //
+    // Size of the largest serialized request header, with all extensions.
+    //
+    static constexpr uint32_t c_MaxHeaderSize =
+        DataTransmissionFrameHeader::c_SerializedSize + DataTransmissionFrameHeader::c_ChecksumSize + DataTransmissionFrameHeader::c_DeadlineSize;
+
+    //
+    // Size of the serialized response header.
+    //
+    static constexpr uint32_t c_ResponseHeaderSize = DataTransmissionFrameHeader::c_SerializedSize + sizeof(StatusCode);
+
+};
+
+} // namespace gX.
+
+#endif
@@ -5,24 +5,53 @@
 // Author: jcjuarez
 // *************************************
 
+#include <bit>
+#include <cmath>
 #include <thread>
+#include <cerrno>
+#include <algorithm>
 #include <cstring>
 #include <unistd.h>
 #include <iostream>
+#include <poll.h>
 #include <sys/types.h>
+#include <sys/un.h>
+#include <sys/stat.h>
 #include <sys/socket.h>
+#include <sys/eventfd.h>
 #include "gXDataTransmissionServer.hh"
+#include "gXCrc32c.hh"
+#include "gXCpuTopology.hh"
 
 namespace gX
 {
 
 DataTransmissionServerConfiguration::DataTransmissionServerConfiguration()
     : m_Port(c_DefaultPortNumber),
+      m_SharedMemoryRingSize(c_DefaultSharedMemoryRingSize),
       m_ReceiveBufferSize(c_DefaultReceiveBufferSize),
       m_ThreadPoolSize(c_DefaultThreadPoolSize),
+      m_ThreadPoolScheduler(c_DefaultThreadPoolScheduler),
+      m_PriorityPolicy(c_DefaultPriorityPolicy),
       m_MaxNumberAllowedConnections(c_DefaultMaxNumberAllowedConnections),
+      m_NumberIoShards(c_DefaultNumberIoShards),
+      m_IoBackend(c_DefaultIoBackend),
+      m_IoUringQueueDepth(c_DefaultIoUringQueueDepth),
+      m_MaxPacketSize(c_DefaultMaxPacketSize),
+      m_MaxNumberInFlightRequestsPerConnection(c_DefaultMaxNumberInFlightRequestsPerConnection),
+      m_MaxNumberQueuedRequests(c_DefaultMaxNumberQueuedRequests),
+      m_QueueDelayTargetMilliseconds(c_DefaultQueueDelayTargetMilliseconds),
+      m_QueueDelayIntervalMilliseconds(c_DefaultQueueDelayIntervalMilliseconds),
+      m_ReadTimeoutMilliseconds(c_DefaultReadTimeoutMilliseconds),
+      m_IdleTimeoutMilliseconds(c_DefaultIdleTimeoutMilliseconds),
       m_BlockingExecution(c_DefaultBlockingExecution),
-      m_CleanTermination(c_DefaultCleanTermination)
+      m_CleanTermination(c_DefaultCleanTermination),
+      m_EnableStatistics(c_DefaultEnableStatistics),
+      m_ReceiveBufferPoolSize(c_DefaultReceiveBufferPoolSize),
+      m_ResponseBufferSize(c_DefaultResponseBufferSize),
+      m_ResponseBufferPoolSize(c_DefaultResponseBufferPoolSize),
+      m_MaxMemorySize(c_DefaultMaxMemorySize),
+      m_EnableHugePages(c_DefaultEnableHugePages)
 {
     //
     // Default function for the default DTP packet tag. Possible to override it (and recommended for production scenarios).
@@ -34,7 +63,14 @@ DataTransmissionServer::DataTransmissionServer(
     const std::string& p_ServiceIdentifier)
     : m_IsInitialized(false),
       m_IsStopped(false),
-      m_ServiceIdentifier(p_ServiceIdentifier)
+      m_ServiceIdentifier(p_ServiceIdentifier),
+      m_UnixSocketHandle(-1),
+      m_SharedMemoryRingSize(0),
+      m_NumberRequestsInExecution(0),
+      m_IsQueueDelayAboveTarget(false),
+      m_IsSheddingRequests(false),
+      m_SheddingCount(0),
+      m_NumberShedRequests(0)
 {}
 
 DataTransmissionServer::~DataTransmissionServer()
@@ -44,25 +80,67 @@ DataTransmissionServer::~DataTransmissionServer()
     //
     m_IsStopped = true;
 
-    if (m_DispatchRequestsThreadHandle.joinable())
+    for (std::unique_ptr<IoShard>& shard : m_IoShards)
     {
-        try
+        if (shard->m_DispatchRequestsThreadHandle.joinable())
         {
-            //
-            // Wait for the server to complete its execution.
-            //
-            m_DispatchRequestsThreadHandle.join();
+            try
+            {
+                //
+                // Wait for the shard to complete its execution.
+                //
+                shard->m_DispatchRequestsThreadHandle.join();
+            }
+            catch (const std::system_error& p_Exception)
+            {
+                //
+                // This can happen in the rare situation in which the thread became non-joinable just
+                // after checking its state. This should not be considered an error at this point; continue.
+                //
+            }
         }
-        catch (const std::system_error& p_Exception)
+    }
+
+    //
+    // The AF_UNIX socket is shared by the shards, so it is only closed once all of them are done.
+    //
+    if (m_UnixSocketHandle >= 0)
+    {
+        close(m_UnixSocketHandle);
+
+        if (!m_UnixSocketPath.empty())
         {
-            //
-            // This can happen in the rare situation in which the thread became non-joinable just
-            // after checking its state. This should not be considered an error at this point; continue.
-            //
+            unlink(m_UnixSocketPath.c_str());
         }
     }
 }
 
+DataTransmissionServer::IoShard::IoShard(
+    SlabAllocator* p_SlabAllocator)
+    : m_ServerSocketHandle(-1),
+      m_WakeupHandle(-1),
+      m_TimerWheel(std::chrono::milliseconds(c_EventLoopWaitTimeoutMilliseconds), std::chrono::steady_clock::now()),
+      m_Connections(0, decltype(m_Connections)::allocator_type(p_SlabAllocator)),
+      m_IsAcceptArmed(false),
+      m_IsUnixAcceptArmed(false),
+      m_IsWakeupArmed(false),
+      m_NumberPendingIoOperations(0),
+      m_Statistics(nullptr)
+{}
+
+DataTransmissionServer::IoShard::~IoShard()
+{
+    if (m_ServerSocketHandle >= 0)
+    {
+        close(m_ServerSocketHandle);
+    }
+
+    if (m_WakeupHandle >= 0)
+    {
+        close(m_WakeupHandle);
+    }
+}
+
 StatusCode
 DataTransmissionServer::Init(
     const DataTransmissionServerConfiguration* p_Configuration)
@@ -88,79 +166,213 @@ DataTransmissionServer::Init(
     //
     m_BlockingExecution = p_Configuration->m_BlockingExecution;
     m_CleanTermination = p_Configuration->m_CleanTermination;
-    m_PacketTagResolverTable = std::move(p_Configuration->m_PacketTagResolverTable);
 
     //
-    // Initialize the thread pool.
+    // Freeze the resolver table into the flat dispatch table. The statistics and shared memory packet tags
+    // are reserved and always served by the shards, so an endpoint registered on them is never reachable.
     //
-    StatusCode status = m_ThreadPool.Init(p_Configuration->m_ThreadPoolSize);
+    std::unordered_map<PacketTag, Endpoint> endpoints = p_Configuration->m_PacketTagResolverTable;
+    endpoints.erase(c_StatisticsPacketTag);
+    endpoints.erase(c_SharedMemoryPacketTag);
+
+    bool hasCoroutineEndpoints = false;
+
+    for (const auto& [packetTag, endpoint] : endpoints)
+    {
+        //
+        // Every endpoint must map to a configured priority class; no classes means a single one.
+        //
+        if (endpoint.GetPriorityClass() >= std::max<size_t>(1u, p_Configuration->m_PriorityClasses.size()))
+        {
+            return Status::InvalidArgument;
+        }
+
+        hasCoroutineEndpoints = hasCoroutineEndpoints || endpoint.IsCoroutine();
+    }
+
+    StatusCode status = m_DispatchTable.Build(std::move(endpoints));
 
     if (Status::Failed(status))
     {
         return status;
     }
 
-    try
+    //
+    // Initialize the thread pool.
+    //
+    status = m_ThreadPool.Init(
+        p_Configuration->m_ThreadPoolSize,
+        p_Configuration->m_ThreadPoolScheduler,
+        p_Configuration->m_MaxNumberQueuedRequests,
+        p_Configuration->m_PriorityClasses,
+        p_Configuration->m_PriorityPolicy,
+        p_Configuration->m_WorkerThreadCpus);
+
+    if (Status::Failed(status))
     {
-        //
-        // Allocate memory for the dynamic-size receive buffer.
-        //
-        m_ReceiveBufferSize = p_Configuration->m_ReceiveBufferSize;
-        m_ReceiveBuffer = std::unique_ptr<Byte[]>(new Byte[m_ReceiveBufferSize]);
+        return status;
     }
-    catch (const std::bad_alloc& e)
+
+    if (hasCoroutineEndpoints)
     {
-        return Status::OutOfMemory;
+        status = m_AsyncEventLoop.Init(&m_ThreadPool);
+
+        if (Status::Failed(status))
+        {
+            return status;
+        }
     }
 
+    m_ReceiveBufferSize = p_Configuration->m_ReceiveBufferSize;
+    m_MaxPacketSize = p_Configuration->m_MaxPacketSize;
+    m_ReceiveBufferPoolSize = p_Configuration->m_ReceiveBufferPoolSize;
+    m_ResponseBufferSize = p_Configuration->m_ResponseBufferSize;
+    m_ResponseBufferPoolSize = p_Configuration->m_ResponseBufferPoolSize;
+    m_MaxNumberInFlightRequestsPerConnection = std::max<uint16_t>(1u, p_Configuration->m_MaxNumberInFlightRequestsPerConnection);
+    m_QueueDelayTarget = std::chrono::milliseconds(p_Configuration->m_QueueDelayTargetMilliseconds);
+    m_QueueDelayInterval = std::chrono::milliseconds(p_Configuration->m_QueueDelayIntervalMilliseconds);
+    m_ReadTimeout = std::chrono::milliseconds(p_Configuration->m_ReadTimeoutMilliseconds);
+    m_IdleTimeout = std::chrono::milliseconds(p_Configuration->m_IdleTimeoutMilliseconds);
+    m_IoBackend = p_Configuration->m_IoBackend;
+    m_IoUringQueueDepth = std::bit_ceil(std::clamp<uint32_t>(p_Configuration->m_IoUringQueueDepth, 1u, c_MaxIoUringQueueDepth));
+
     //
-    // Create socket handle for handling incoming requests.
+    // Set up the allocator the shards draw their connections and buffers from.
     //
-    if ((m_ServerSocketHandle = socket(AF_INET, SOCK_STREAM, 0)) == 0)
+    status = m_SlabAllocator.Init(p_Configuration->m_MaxMemorySize, p_Configuration->m_EnableHugePages);
+
+    if (Status::Failed(status))
     {
-        return Status::SocketCreationFailed;
+        return status;
     }
 
     //
-    // Configure socket handle.
+    // Resolve the number of I/O shards; zero means one shard per available core.
     //
-    int32_t opt = 1;
+    uint16_t numberIoShards = p_Configuration->m_NumberIoShards;
 
-    if (setsockopt(m_ServerSocketHandle, SOL_SOCKET, SO_REUSEADDR | SO_REUSEPORT, &opt, sizeof(opt)))
+    if (numberIoShards == 0)
     {
-        close(m_ServerSocketHandle);
-        
-        return Status::SocketConfigurationFailed;
+        numberIoShards = static_cast<uint16_t>(std::max(1u, std::thread::hardware_concurrency()));
     }
-    
+
     //
-    // Set up socket address configurations.
+    // Set up socket address configurations. All shards bind to the same address.
     //
     m_Address.sin_family = AF_INET;
     m_Address.sin_addr.s_addr = INADDR_ANY;
     m_Address.sin_port = htons(p_Configuration->m_Port);
     m_AddressLength = sizeof(m_Address);
 
-    //
-    // Bind the socket handle to the socket address information.
-    //
-    if (bind(m_ServerSocketHandle, reinterpret_cast<const sockaddr*>(&m_Address), sizeof(m_Address)) < 0)
+    if (!p_Configuration->m_UnixSocketPath.empty())
     {
-        close(m_ServerSocketHandle);
+        status = InitUnixSocket(
+            p_Configuration->m_UnixSocketPath,
+            p_Configuration->m_MaxNumberAllowedConnections);
 
-        return Status::SocketBindFailed;
+        if (Status::Failed(status))
+        {
+            return status;
+        }
+
+        m_SharedMemoryRingSize = p_Configuration->m_SharedMemoryRingSize;
     }
 
-    //
-    // Start listening for connections on the specified port.
-    //
-    if (listen(m_ServerSocketHandle, p_Configuration->m_MaxNumberAllowedConnections) < 0)
+    const std::vector<uint16_t>& ioThreadCpus = p_Configuration->m_IoThreadCpus;
+    std::vector<uint16_t> callerCpus;
+
+    for (const uint16_t cpu : ioThreadCpus)
     {
-        close(m_ServerSocketHandle);
+        if (!CpuTopology::IsCpuAvailable(cpu))
+        {
+            return Status::InvalidArgument;
+        }
+    }
 
-        return Status::SocketListenFailed;
+    if (!ioThreadCpus.empty())
+    {
+        status = CpuTopology::GetCurrentThreadCpus(callerCpus);
+
+        if (Status::Failed(status))
+        {
+            return status;
+        }
+    }
+
+    for (uint16_t shardIndex = 0; shardIndex < numberIoShards; ++shardIndex)
+    {
+        try
+        {
+            m_IoShards.emplace_back(std::make_unique<IoShard>(&m_SlabAllocator));
+
+            if (!ioThreadCpus.empty())
+            {
+                m_IoShards.back()->m_Cpus.push_back(ioThreadCpus[shardIndex % ioThreadCpus.size()]);
+            }
+        }
+        catch (const std::bad_alloc& e)
+        {
+            m_IoShards.clear();
+
+            return Status::OutOfMemory;
+        }
+
+        //
+        // Set the shard up from its own CPU, so that its buffers, event loop and rings are allocated on its node.
+        //
+        if (!m_IoShards.back()->m_Cpus.empty())
+        {
+            status = CpuTopology::PinCurrentThread(m_IoShards.back()->m_Cpus);
+        }
+
+        if (Status::Succeeded(status))
+        {
+            status = InitIoShard(
+                *m_IoShards.back(),
+                p_Configuration->m_MaxNumberAllowedConnections);
+        }
+
+        if (Status::Failed(status))
+        {
+            //
+            // Release the sockets of all the shards created so far.
+            //
+            m_IoShards.clear();
+        }
+
+        if (!callerCpus.empty())
+        {
+            CpuTopology::PinCurrentThread(callerCpus);
+        }
+
+        if (Status::Failed(status))
+        {
+            return status;
+        }
+    }
+
+    if (p_Configuration->m_EnableStatistics)
+    {
+        //
+        // Every worker and shard thread, and the async event loop, records into its own statistics; endpoints
+        // are listed by packet tag in the same order as the dispatch table indexes them.
+        //
+        status = m_Statistics.Init(m_DispatchTable.GetPacketTags(), m_ThreadPool.GetNumberThreads() + static_cast<uint32_t>(m_IoShards.size()) + 1u);
+
+        if (Status::Failed(status))
+        {
+            m_IoShards.clear();
+
+            return status;
+        }
+
+        for (size_t shardIndex = 0; shardIndex < m_IoShards.size(); ++shardIndex)
+        {
+            m_IoShards[shardIndex]->m_Statistics = m_Statistics.GetThreadStatistics(
+                m_ThreadPool.GetNumberThreads() + static_cast<uint32_t>(shardIndex));
+        }
     }
-    
+
     //
     // Set the fact that the server has been correctly initialized.
     //
@@ -183,170 +395,2623 @@ DataTransmissionServer::Run()
     }
 
     //
-    // Spawn a new background thread for running the server.
+    // Spawn a background thread running the event loop of each shard.
     //
-    m_DispatchRequestsThreadHandle = std::thread(&DataTransmissionServer::DispatchRequests, this);
+    for (std::unique_ptr<IoShard>& shard : m_IoShards)
+    {
+        shard->m_DispatchRequestsThreadHandle = std::thread(&DataTransmissionServer::DispatchRequests, this, shard.get());
+    }
 
     if (m_BlockingExecution)
     {
         //
-        // Blocking execution was specified; use the same caller thread for running the server.
+        // Blocking execution was specified; block the caller thread until all shards finish.
         //
-        m_DispatchRequestsThreadHandle.join();
+        for (std::unique_ptr<IoShard>& shard : m_IoShards)
+        {
+            shard->m_DispatchRequestsThreadHandle.join();
+        }
     }
 }
 
 StatusCode
-DataTransmissionServer::Stop()
+DataTransmissionServer::InitIoShard(
+    IoShard& p_Shard,
+    const uint16_t p_MaxNumberAllowedConnections)
 {
-    if (m_IsStopped)
+    //
+    // Set up the receive buffer pool of the shard and take its first receive buffer.
+    //
+    StatusCode status = p_Shard.m_BufferPool.Init(m_ReceiveBufferSize, m_ReceiveBufferPoolSize, &m_SlabAllocator);
+
+    if (Status::Failed(status))
     {
-        return Status::ServiceIsStopped;
+        return status;
     }
 
-    m_IsStopped = true;
+    p_Shard.m_ReceiveBuffer = p_Shard.m_BufferPool.Acquire(m_ReceiveBufferSize);
 
-    return Status::Success;
-}
+    if (!p_Shard.m_ReceiveBuffer)
+    {
+        return Status::OutOfMemory;
+    }
 
-StatusCode
-DataTransmissionServer::DefaultEndpoint(
-    std::string p_Packet)
-{
-    std::cout << p_Packet.c_str() << std::endl;
+    //
+    // Set up the pool response payloads are built in. Buffers are taken by worker threads and
+    // returned by the shard once the payload has been written.
+    //
+    status = p_Shard.m_ResponseBufferPool.Init(m_ResponseBufferSize, m_ResponseBufferPoolSize, &m_SlabAllocator);
 
-    return Status::Success;
-}
+    if (Status::Failed(status))
+    {
+        return status;
+    }
 
-void
-DataTransmissionServer::DispatchRequests()
-{
-    FOREVER
-    {   
-        if (m_IsStopped)
-        {
-            //
-            // The server has been instructed to be terminated; stop its execution.
-            //
-            break;
-        }
+    //
+    // Create non-blocking socket handle for handling incoming requests.
+    // Ownership is held by the shard, which closes it on destruction.
+    //
+    if ((p_Shard.m_ServerSocketHandle = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) < 0)
+    {
+        return Status::SocketCreationFailed;
+    }
 
-        FileDescriptor connection;
+    //
+    // Configure socket handle. SO_REUSEPORT lets every shard bind its own socket to the
+    // same port so that the kernel load balances incoming connections across shards.
+    //
+    int32_t opt = 1;
 
-        //
-        // Accept an incoming connection.
-        //
-        if ((connection = accept(m_ServerSocketHandle, (struct sockaddr *)&m_Address, (socklen_t *)&m_AddressLength)) < 0)
-        {
-            //
-            // Invalid connection; continue.
-            //
-            continue;
-        }
+    if (setsockopt(p_Shard.m_ServerSocketHandle, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) ||
+        setsockopt(p_Shard.m_ServerSocketHandle, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)))
+    {
+        return Status::SocketConfigurationFailed;
+    }
 
-        //
-        // Read data from the established connection.
-        //
-        uint32_t numberBytesRead = read(connection, m_ReceiveBuffer.get(), m_ReceiveBufferSize);
+    //
+    // Bind the socket handle to the socket address information.
+    //
+    if (bind(p_Shard.m_ServerSocketHandle, reinterpret_cast<const sockaddr*>(&m_Address), sizeof(m_Address)) < 0)
+    {
+        return Status::SocketBindFailed;
+    }
 
-        if (numberBytesRead <= 0)
-        {
-            //
-            // Invalid reading; continue.
-            //
-            continue;
-        }
-        
-        //
-        // Deserialize message.
-        //
-        std::string packet(reinterpret_cast<char*>(m_ReceiveBuffer.get()), numberBytesRead);
-        const PacketTag packetTag = c_DefaultEndpointPacketTag;
+    //
+    // Start listening for connections on the specified port.
+    //
+    if (listen(p_Shard.m_ServerSocketHandle, p_MaxNumberAllowedConnections) < 0)
+    {
+        return Status::SocketListenFailed;
+    }
 
-        //
-        // Resolve function to execute based on the lookup table.
-        //
-        if (m_PacketTagResolverTable.find(packetTag) == m_PacketTagResolverTable.end())
-        {
-            //
-            // Unknown packet tag.
-            // Do not enqueue the request and send the response back immediately.
-            //
-            SendResponseAndCloseConnection(Status::UnknownPacketTag, connection);
+    //
+    // Create the wakeup handle through which worker threads notify the shard of completed requests.
+    //
+    if ((p_Shard.m_WakeupHandle = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0)
+    {
+        return Status::EventLoopCreationFailed;
+    }
 
-            continue;
-        }
-        
-        const EndpointType boundFunction = m_PacketTagResolverTable.at(packetTag);
+    if (m_IoBackend == IoBackend::IoUring)
+    {
+        return InitIoRing(p_Shard);
+    }
 
-        //
-        // Enqueue task for async execution and increase the number of requests in execution.
-        //
-        auto enqueueResult = m_ThreadPool.EnqueueTask(
-            &DataTransmissionServer::DispatcherProxy,
-            this,
-            boundFunction,
-            connection,
-            packet);
+    //
+    // Set up the event loop and register the server socket for incoming connections.
+    //
+    status = p_Shard.m_EventLoop.Init();
 
-        if (enqueueResult != std::nullopt)
-        {
-            //
-            // It is better to increment the counter here as it guarantees change decoupled from the new thread execution.
-            //
-            ++m_NumberRequestsInExecution;
-        }
+    if (Status::Failed(status))
+    {
+        return status;
     }
 
-    if (m_CleanTermination)
+    status = p_Shard.m_EventLoop.Register(p_Shard.m_ServerSocketHandle, EPOLLIN | EPOLLET, &p_Shard);
+
+    if (Status::Failed(status))
+    {
+        return status;
+    }
+
+    if (m_UnixSocketHandle >= 0)
     {
         //
-        // Clean termination was specified; wait for all tasks to finish.
-        // At this point it is guaranteed that no more tasks will be enqueued.
+        // Every shard waits on the shared AF_UNIX socket; only one of them is woken up per incoming connection.
         //
-        while (m_NumberRequestsInExecution != 0)
-        {}
+        status = p_Shard.m_EventLoop.Register(m_UnixSocketHandle, EPOLLIN | EPOLLET | EPOLLEXCLUSIVE, &m_UnixSocketHandle);
+
+        if (Status::Failed(status))
+        {
+            return status;
+        }
     }
 
-    //
-    // Close the server socket after stopping execution.
-    // If clean termination was not specified, it is possible that the TCP socket is
-    // closed before sending responses back to requests that had already been acknowledged.
-    //
-    close(m_ServerSocketHandle);
+    return p_Shard.m_EventLoop.Register(p_Shard.m_WakeupHandle, EPOLLIN | EPOLLET, &p_Shard.m_WakeupHandle);
 }
 
-void
-DataTransmissionServer::DispatcherProxy(
-    DataTransmissionServer* p_DataTransmissionServer,
-    const EndpointType p_Endpoint,
-    const FileDescriptor p_Connection,
-    std::string p_Packet)
+StatusCode
+DataTransmissionServer::InitIoRing(
+    IoShard& p_Shard)
 {
-    //
-    // Execute endpoint in an async context.
-    //
-    SendResponseAndCloseConnection(p_Endpoint(p_Packet), p_Connection);
+    StatusCode status = p_Shard.m_IoRing.Init(m_IoUringQueueDepth);
 
-    //
-    // Decrement the counter once the response has been sent back to the client.
-    //
-    --(p_DataTransmissionServer->m_NumberRequestsInExecution);
-}
+    if (Status::Failed(status))
+    {
+        return status;
+    }
+
+    status = p_Shard.m_IoRing.RegisterBufferRing(m_IoUringQueueDepth);
+
+    if (Status::Failed(status))
+    {
+        return status;
+    }
+
+    //
+    // Hand the kernel one receive buffer per ring entry. Receives pick one of them when data arrives,
+    // so buffers are only committed to connections that actually have data to read.
+    //
+    try
+    {
+        p_Shard.m_ProvidedBuffers.resize(m_IoUringQueueDepth);
+    }
+    catch (const std::bad_alloc& e)
+    {
+        return Status::OutOfMemory;
+    }
+
+    for (uint32_t bufferId = 0; bufferId < m_IoUringQueueDepth; ++bufferId)
+    {
+        p_Shard.m_ProvidedBuffers[bufferId] = p_Shard.m_BufferPool.Acquire(m_ReceiveBufferSize);
+
+        if (!p_Shard.m_ProvidedBuffers[bufferId])
+        {
+            return Status::OutOfMemory;
+        }
+
+        ProvideIoRingBuffer(p_Shard, static_cast<uint16_t>(bufferId));
+    }
+
+    return Status::Success;
+}
+
+StatusCode
+DataTransmissionServer::InitUnixSocket(
+    const std::string& p_Path,
+    const uint16_t p_MaxNumberAllowedConnections)
+{
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+
+    if (p_Path.size() >= sizeof(address.sun_path))
+    {
+        return Status::InvalidArgument;
+    }
+
+    std::memcpy(address.sun_path, p_Path.data(), p_Path.size());
+
+    const bool isAbstract = p_Path.front() == '@';
+    const socklen_t addressLength = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + p_Path.size() + (isAbstract ? 0u : 1u));
+
+    if (isAbstract)
+    {
+        address.sun_path[0] = '\0';
+    }
+
+    if ((m_UnixSocketHandle = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) < 0)
+    {
+        return Status::SocketCreationFailed;
+    }
+
+    if (!isAbstract)
+    {
+        //
+        // A socket file left behind by a previous instance would make the bind fail; anything else is left alone.
+        //
+        struct stat pathStatus;
+
+        if (lstat(p_Path.c_str(), &pathStatus) == 0 &&
+            S_ISSOCK(pathStatus.st_mode))
+        {
+            //
+            // The file is only stale if nothing listens on it anymore, which a refused connection tells.
+            // A live listener, or any other outcome, must not be taken over.
+            //
+            const FileDescriptor probeHandle = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+            if (probeHandle < 0)
+            {
+                return Status::SocketCreationFailed;
+            }
+
+            const bool isStale = connect(probeHandle, reinterpret_cast<const sockaddr*>(&address), addressLength) < 0 &&
+                errno == ECONNREFUSED;
+
+            close(probeHandle);
+
+            if (!isStale)
+            {
+                return Status::SocketBindFailed;
+            }
+
+            unlink(p_Path.c_str());
+        }
+    }
+
+    if (bind(m_UnixSocketHandle, reinterpret_cast<const sockaddr*>(&address), addressLength) < 0)
+    {
+        return Status::SocketBindFailed;
+    }
+
+    if (!isAbstract)
+    {
+        m_UnixSocketPath = p_Path;
+    }
+
+    if (listen(m_UnixSocketHandle, p_MaxNumberAllowedConnections) < 0)
+    {
+        return Status::SocketListenFailed;
+    }
+
+    return Status::Success;
+}
+
+StatusCode
+DataTransmissionServer::Stop()
+{
+    if (m_IsStopped)
+    {
+        return Status::ServiceIsStopped;
+    }
+
+    m_IsStopped = true;
+
+    return Status::Success;
+}
+
+uint64_t
+DataTransmissionServer::GetNumberRejectedRequests() const
+{
+    return m_ThreadPool.GetNumberRejectedTasks();
+}
+
+uint64_t
+DataTransmissionServer::GetNumberShedRequests() const
+{
+    return m_NumberShedRequests.load(std::memory_order_relaxed);
+}
+
+StatusCode
+DataTransmissionServer::GetStatistics(
+    StatisticsSnapshot& p_Snapshot) const
+{
+    p_Snapshot = StatisticsSnapshot();
+
+    const StatusCode status = m_Statistics.TakeSnapshot(p_Snapshot);
+
+    if (Status::Failed(status))
+    {
+        return status;
+    }
+
+    p_Snapshot.m_NumberRejectedRequests = GetNumberRejectedRequests();
+    p_Snapshot.m_NumberShedRequests = GetNumberShedRequests();
+    p_Snapshot.m_NumberRequestsInExecution = m_NumberRequestsInExecution.load();
+
+    return Status::Success;
+}
+
+AsyncEventLoop&
+DataTransmissionServer::GetAsyncEventLoop()
+{
+    return m_AsyncEventLoop;
+}
+
+StatusCode
+DataTransmissionServer::DefaultEndpoint(
+    std::string p_Packet)
+{
+    std::cout << p_Packet.c_str() << std::endl;
+
+    return Status::Success;
+}
+
+void
+DataTransmissionServer::DispatchRequests(
+    IoShard* p_Shard)
+{
+    if (!p_Shard->m_Cpus.empty())
+    {
+        //
+        // The CPUs were validated on initialization.
+        //
+        CpuTopology::PinCurrentThread(p_Shard->m_Cpus);
+    }
+
+    FOREVER
+    {   
+        if (m_IsStopped)
+        {
+            //
+            // The server has been instructed to be terminated; stop its execution.
+            //
+            break;
+        }
+
+        if (m_IoBackend == IoBackend::IoUring)
+        {
+            ProcessIoRingCompletions(*p_Shard);
+        }
+        else
+        {
+            ProcessEvents(*p_Shard);
+        }
+    }
+
+    if (m_CleanTermination)
+    {
+        //
+        // Clean termination was specified; wait for all tasks to finish.
+        // At this point it is guaranteed that no more tasks will be enqueued.
+        //
+        for (uint64_t numberRequestsInExecution = m_NumberRequestsInExecution.load();
+            numberRequestsInExecution != 0;
+            numberRequestsInExecution = m_NumberRequestsInExecution.load())
+        {
+            m_NumberRequestsInExecution.wait(numberRequestsInExecution);
+        }
+
+        //
+        // Make a last attempt at writing back the responses of the finished tasks.
+        //
+        ProcessCompletions(*p_Shard);
+        WriteScheduledConnections(*p_Shard);
+
+        if (m_IoBackend == IoBackend::IoUring)
+        {
+            //
+            // Sends are only queued at this point; wait for them as long as they keep progressing.
+            //
+            const auto isSendInFlight = [p_Shard]()
+            {
+                return std::any_of(
+                    p_Shard->m_Connections.begin(),
+                    p_Shard->m_Connections.end(),
+                    [](const auto& p_Entry)
+                    {
+                        return p_Entry.second->m_IsSendInFlight;
+                    });
+            };
+
+            while (isSendInFlight() &&
+                ProcessIoRingCompletions(*p_Shard) != 0)
+            {}
+        }
+    }
+
+    if (m_IoBackend == IoBackend::IoUring)
+    {
+        //
+        // Shutting the sockets down completes the operations still queued on them, which must
+        // finish before the buffers and connections they point into are freed.
+        //
+        shutdown(p_Shard->m_ServerSocketHandle, SHUT_RDWR);
+
+        //
+        // The AF_UNIX socket is shared with the other shards, so only the accept of this one is cancelled.
+        //
+        if (p_Shard->m_IsUnixAcceptArmed)
+        {
+            p_Shard->m_IoRing.PrepareCancel(reinterpret_cast<uint64_t>(p_Shard) | static_cast<uint64_t>(IoRingOperation::UnixAccept));
+        }
+
+        while (!p_Shard->m_Connections.empty())
+        {
+            ReleaseConnection(*p_Shard, *p_Shard->m_Connections.begin()->second);
+        }
+
+        while (p_Shard->m_NumberPendingIoOperations != 0 &&
+            ProcessIoRingCompletions(*p_Shard) != 0)
+        {}
+    }
+
+    //
+    // Close the shard socket and all client connections after stopping execution.
+    // If clean termination was not specified, it is possible that the TCP socket is
+    // closed before sending responses back to requests that had already been acknowledged.
+    //
+    p_Shard->m_Connections.clear();
+    p_Shard->m_ReleasedConnections.clear();
+    close(p_Shard->m_ServerSocketHandle);
+    p_Shard->m_ServerSocketHandle = -1;
+}
+
+void
+DataTransmissionServer::ProcessEvents(
+    IoShard& p_Shard)
+{
+    //
+    // Wait for ready sockets. The timeout bounds how long a stop request can go unnoticed.
+    //
+    const int32_t numberEvents = p_Shard.m_EventLoop.Wait(c_EventLoopWaitTimeoutMilliseconds);
+
+    AdvanceConnectionTimers(p_Shard);
+
+    for (int32_t eventIndex = 0; eventIndex < numberEvents; ++eventIndex)
+    {
+        void* context = p_Shard.m_EventLoop.GetEventContext(eventIndex);
+
+        if (context == &p_Shard)
+        {
+            AcceptConnections(p_Shard, p_Shard.m_ServerSocketHandle, false);
+
+            continue;
+        }
+
+        if (context == &m_UnixSocketHandle)
+        {
+            AcceptConnections(p_Shard, m_UnixSocketHandle, true);
+
+            continue;
+        }
+
+        if (context == &p_Shard.m_WakeupHandle)
+        {
+            ProcessCompletions(p_Shard);
+
+            continue;
+        }
+
+        Connection& connection = *static_cast<Connection*>(context);
+        const uint32_t eventFlags = p_Shard.m_EventLoop.GetEventFlags(eventIndex);
+
+        if (connection.m_Channel)
+        {
+            ProcessChannelDoorbell(p_Shard, connection);
+
+            continue;
+        }
+
+        if (eventFlags & EPOLLOUT)
+        {
+            connection.m_IsWriteBlocked = false;
+            WriteConnection(p_Shard, connection);
+        }
+
+        if (eventFlags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR) ||
+            connection.m_IsReadSuspended)
+        {
+            ReadConnection(p_Shard, connection);
+        }
+    }
+
+    //
+    // Submit the requests decoded during this iteration as a single batch, write all the responses
+    // gathered meanwhile and drop the released connections, which are no longer referenced by any pending event.
+    //
+    WriteScheduledConnections(p_Shard);
+    DropReleasedConnections(p_Shard);
+}
+
+uint32_t
+DataTransmissionServer::ProcessIoRingCompletions(
+    IoShard& p_Shard)
+{
+    IoRing& ioRing = p_Shard.m_IoRing;
+
+    //
+    // Multishot operations stop on errors or when the kernel runs out of completion space; re-arm them
+    // here rather than on their last completion so that a persistent error backs off until the next iteration.
+    //
+    if (!p_Shard.m_IsAcceptArmed &&
+        !m_IsStopped &&
+        ioRing.PrepareMultishotAccept(p_Shard.m_ServerSocketHandle, reinterpret_cast<uint64_t>(&p_Shard) | static_cast<uint64_t>(IoRingOperation::Accept)))
+    {
+        p_Shard.m_IsAcceptArmed = true;
+        ++p_Shard.m_NumberPendingIoOperations;
+    }
+
+    if (!p_Shard.m_IsUnixAcceptArmed &&
+        !m_IsStopped &&
+        m_UnixSocketHandle >= 0 &&
+        ioRing.PrepareMultishotAccept(m_UnixSocketHandle, reinterpret_cast<uint64_t>(&p_Shard) | static_cast<uint64_t>(IoRingOperation::UnixAccept)))
+    {
+        p_Shard.m_IsUnixAcceptArmed = true;
+        ++p_Shard.m_NumberPendingIoOperations;
+    }
+
+    if (!p_Shard.m_IsWakeupArmed)
+    {
+        p_Shard.m_IsWakeupArmed = ioRing.PrepareMultishotPoll(
+            p_Shard.m_WakeupHandle,
+            POLLIN,
+            reinterpret_cast<uint64_t>(&p_Shard) | static_cast<uint64_t>(IoRingOperation::Wakeup));
+    }
+
+    //
+    // Hand all the operations queued during the previous iteration to the kernel and wait for completions,
+    // in a single system call. The timeout bounds how long a stop request can go unnoticed.
+    //
+    const uint32_t numberCompletions = ioRing.Wait(c_EventLoopWaitTimeoutMilliseconds);
+
+    AdvanceConnectionTimers(p_Shard);
+
+    for (uint32_t completionIndex = 0; completionIndex < numberCompletions; ++completionIndex)
+    {
+        const uint64_t userData = ioRing.GetCompletionUserData(completionIndex);
+        const int32_t result = ioRing.GetCompletionResult(completionIndex);
+        const uint32_t flags = ioRing.GetCompletionFlags(completionIndex);
+        void* context = reinterpret_cast<void*>(userData & ~c_IoRingOperationMask);
+
+        switch (static_cast<IoRingOperation>(userData & c_IoRingOperationMask))
+        {
+            case IoRingOperation::Accept:
+            {
+                if (!(flags & IORING_CQE_F_MORE))
+                {
+                    p_Shard.m_IsAcceptArmed = false;
+                    --p_Shard.m_NumberPendingIoOperations;
+                }
+
+                if (result >= 0)
+                {
+                    AcceptIoRingConnection(p_Shard, result, false);
+                }
+
+                break;
+            }
+
+            case IoRingOperation::UnixAccept:
+            {
+                if (!(flags & IORING_CQE_F_MORE))
+                {
+                    p_Shard.m_IsUnixAcceptArmed = false;
+                    --p_Shard.m_NumberPendingIoOperations;
+                }
+
+                if (result >= 0)
+                {
+                    AcceptIoRingConnection(p_Shard, result, true);
+                }
+
+                break;
+            }
+
+            case IoRingOperation::Wakeup:
+            {
+                if (!(flags & IORING_CQE_F_MORE))
+                {
+                    p_Shard.m_IsWakeupArmed = false;
+                }
+
+                ProcessCompletions(p_Shard);
+
+                break;
+            }
+
+            case IoRingOperation::Receive:
+            {
+                CompleteIoRingReceive(p_Shard, *static_cast<Connection*>(context), result, flags);
+
+                break;
+            }
+
+            case IoRingOperation::Send:
+            {
+                CompleteIoRingSend(p_Shard, *static_cast<Connection*>(context), result);
+
+                break;
+            }
+
+            case IoRingOperation::Doorbell:
+            {
+                Connection& connection = *static_cast<Connection*>(context);
+
+                if (!(flags & IORING_CQE_F_MORE))
+                {
+                    connection.m_IsReceiveArmed = false;
+                    --connection.m_NumberPendingIoOperations;
+                    --p_Shard.m_NumberPendingIoOperations;
+                }
+
+                if (connection.m_Handle >= 0)
+                {
+                    ArmIoRingReceive(p_Shard, connection);
+                    ProcessChannelDoorbell(p_Shard, connection);
+                }
+
+                break;
+            }
+        }
+    }
+
+    //
+    // Submit the requests decoded during this iteration as a single batch and queue the sends of all the
+    // responses gathered meanwhile; they are submitted along with the next wait. Drop the released
+    // connections no operation refers to anymore.
+    //
+    WriteScheduledConnections(p_Shard);
+    DropReleasedConnections(p_Shard);
+
+    return numberCompletions;
+}
+
+void
+DataTransmissionServer::AcceptConnections(
+    IoShard& p_Shard,
+    const FileDescriptor p_ListenerHandle,
+    const bool p_IsUnixDomain)
+{
+    //
+    // The listening socket is edge-triggered; accept until the pending queue is drained.
+    //
+    FOREVER
+    {
+        const FileDescriptor handle = accept4(p_ListenerHandle, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if (handle < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+
+            //
+            // Either no more pending connections (EAGAIN) or a resource limit was hit; retry on the next wakeup.
+            //
+            break;
+        }
+
+        std::shared_ptr<Connection> connection;
+
+        try
+        {
+            connection = std::allocate_shared<Connection>(SlabAllocatorAdapter<Connection>(&m_SlabAllocator), handle, m_MaxNumberInFlightRequestsPerConnection, &m_SlabAllocator);
+        }
+        catch (const std::bad_alloc& e)
+        {
+            close(handle);
+
+            continue;
+        }
+
+        connection->m_IsUnixDomain = p_IsUnixDomain;
+
+        if (Status::Failed(p_Shard.m_EventLoop.Register(handle, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, connection.get())))
+        {
+            //
+            // The connection destructor closes the handle.
+            //
+            continue;
+        }
+
+        Connection& acceptedConnection = *p_Shard.m_Connections.emplace(handle, std::move(connection)).first->second;
+        StartConnectionTimer(p_Shard, acceptedConnection);
+        AddShardCounter(p_Shard, &ThreadStatistics::m_NumberAcceptedConnections, 1u);
+    }
+}
+
+void
+DataTransmissionServer::ReadConnection(
+    IoShard& p_Shard,
+    Connection& p_Connection)
+{
+    //
+    // The connection is edge-triggered; read until the socket is drained.
+    //
+    FOREVER
+    {
+        if (p_Connection.m_Handle < 0 ||
+            p_Connection.m_IsReadShutdown)
+        {
+            return;
+        }
+
+        if (p_Connection.GetNumberInFlightRequests() >= m_MaxNumberInFlightRequestsPerConnection ||
+            p_Connection.m_IsWriteBlocked)
+        {
+            //
+            // Leave the data in the socket so that TCP flow control pushes back on the client.
+            // Reading resumes once responses are written back.
+            //
+            p_Connection.m_IsReadSuspended = true;
+
+            return;
+        }
+
+        if (p_Connection.m_IsReadSuspended)
+        {
+            //
+            // The frame being reassembled was held up by the server rather than the client; time it from here.
+            //
+            p_Connection.m_IsReadSuspended = false;
+            StartFrameTimer(p_Shard, p_Connection);
+        }
+
+        Byte* readBuffer;
+        uint32_t readSize;
+        const bool readingPendingData = p_Connection.m_PendingSize != 0;
+        const uint32_t pendingFrameSize = GetPendingFrameSize(p_Connection);
+
+        if (readingPendingData)
+        {
+            if (p_Connection.m_PendingSize >= pendingFrameSize)
+            {
+                //
+                // The reassembly buffer holds at least one complete frame; consume it before reading more.
+                //
+                uint32_t numberBytesConsumed;
+
+                if (!ConsumeFrames(p_Shard, p_Connection, p_Connection.m_PendingData, p_Connection.m_PendingData.GetData(), p_Connection.m_PendingSize, numberBytesConsumed))
+                {
+                    return;
+                }
+
+                p_Connection.m_PendingSize -= numberBytesConsumed;
+
+                if (p_Connection.m_PendingSize == 0)
+                {
+                    if (p_Connection.m_PendingData.IsShared() ||
+                        !p_Connection.m_PendingData.IsPooled())
+                    {
+                        //
+                        // Leave the buffer to the endpoints still using it and do not keep
+                        // memory of large frames around for the lifetime of the connection.
+                        //
+                        p_Connection.m_PendingData.Reset();
+                    }
+                }
+                else if (!CompactPendingData(p_Shard, p_Connection, numberBytesConsumed))
+                {
+                    return;
+                }
+                else if (numberBytesConsumed != 0)
+                {
+                    StartFrameTimer(p_Shard, p_Connection);
+                }
+
+                continue;
+            }
+        }
+
+        if (m_IoBackend == IoBackend::IoUring &&
+            !p_Connection.m_Channel)
+        {
+            //
+            // Receives complete asynchronously into provided buffers; the data is consumed on completion.
+            // Channels are read in place, as their doorbell rings.
+            //
+            ArmIoRingReceive(p_Shard, p_Connection);
+
+            return;
+        }
+
+        if (readingPendingData)
+        {
+            //
+            // A frame is partially received; read exactly the missing bytes into the connection buffer.
+            // Until the header is complete, only the rest of the header is requested.
+            //
+            if (!ReservePendingData(p_Shard, p_Connection, pendingFrameSize))
+            {
+                return;
+            }
+
+            readBuffer = p_Connection.m_PendingData.GetData() + p_Connection.m_PendingSize;
+            readSize = pendingFrameSize - p_Connection.m_PendingSize;
+        }
+        else
+        {
+            //
+            // No partial frame; read as much as possible into the shard buffer.
+            // If endpoints still reference the current one, continue on a fresh buffer from the pool.
+            //
+            if (p_Shard.m_ReceiveBuffer.IsShared())
+            {
+                p_Shard.m_ReceiveBuffer = p_Shard.m_BufferPool.Acquire(m_ReceiveBufferSize);
+
+                if (!p_Shard.m_ReceiveBuffer)
+                {
+                    ReleaseConnection(p_Shard, p_Connection);
+
+                    return;
+                }
+            }
+
+            readBuffer = p_Shard.m_ReceiveBuffer.GetData();
+            readSize = p_Shard.m_ReceiveBuffer.GetCapacity();
+        }
+
+        const ssize_t readResult = ReceiveInput(p_Connection, readBuffer, readSize);
+
+        if (readResult < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (readResult < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            //
+            // Socket drained; wait for the next readiness notification.
+            //
+            return;
+        }
+
+        if (readResult == 0)
+        {
+            //
+            // Peer shut its side down; answer the requests in flight and then close.
+            //
+            p_Connection.m_IsReadShutdown = true;
+            WriteConnection(p_Shard, p_Connection);
+
+            return;
+        }
+
+        if (readResult < 0)
+        {
+            ReleaseConnection(p_Shard, p_Connection);
+
+            return;
+        }
+
+        const uint32_t numberBytesRead = static_cast<uint32_t>(readResult);
+        AddShardCounter(p_Shard, &ThreadStatistics::m_NumberBytesRead, numberBytesRead);
+        p_Connection.m_LastActivityTime = p_Shard.m_TimerWheel.GetCurrentTime();
+
+        if (readingPendingData)
+        {
+            p_Connection.m_PendingSize += numberBytesRead;
+
+            continue;
+        }
+
+        if (!ConsumeReceivedData(p_Shard, p_Connection, p_Shard.m_ReceiveBuffer, numberBytesRead))
+        {
+            return;
+        }
+    }
+}
+
+ssize_t
+DataTransmissionServer::ReceiveInput(
+    Connection& p_Connection,
+    Byte* p_Data,
+    const uint32_t p_Size)
+{
+    if (!p_Connection.m_Channel)
+    {
+        return read(p_Connection.m_Handle, p_Data, p_Size);
+    }
+
+    SharedMemoryRing& ring = p_Connection.m_Channel->GetRequestRing();
+    size_t size = ring.Read(p_Data, p_Size);
+
+    if (size == 0)
+    {
+        if (ring.PrepareConsumerWait())
+        {
+            errno = EAGAIN;
+
+            return -1;
+        }
+
+        size = ring.Read(p_Data, p_Size);
+    }
+
+    if (ring.ShouldWakeProducer())
+    {
+        SharedMemoryChannel::Notify(p_Connection.m_Channel->GetClientDoorbellHandle());
+    }
+
+    return static_cast<ssize_t>(size);
+}
+
+bool
+DataTransmissionServer::ConsumeReceivedData(
+    IoShard& p_Shard,
+    Connection& p_Connection,
+    const BufferReference& p_Buffer,
+    const uint32_t p_Size)
+{
+    const Byte* data = p_Buffer.GetData();
+
+    if (p_Connection.m_PendingSize != 0)
+    {
+        //
+        // The data continues a partial frame; append it to the reassembly buffer, reserving the whole
+        // frame at once so that large frames arriving in many pieces are not reallocated repeatedly.
+        //
+        const uint32_t requiredSize = std::max(p_Connection.m_PendingSize + p_Size, GetPendingFrameSize(p_Connection));
+
+        if (!ReservePendingData(p_Shard, p_Connection, requiredSize))
+        {
+            return false;
+        }
+
+        std::memcpy(p_Connection.m_PendingData.GetData() + p_Connection.m_PendingSize, data, p_Size);
+        p_Connection.m_PendingSize += p_Size;
+
+        return true;
+    }
+
+    uint32_t numberBytesConsumed;
+
+    if (!ConsumeFrames(p_Shard, p_Connection, p_Buffer, data, p_Size, numberBytesConsumed))
+    {
+        return false;
+    }
+
+    if (numberBytesConsumed < p_Size)
+    {
+        //
+        // Keep the trailing incomplete frame (or the frames left after hitting the in-flight limit).
+        //
+        const uint32_t numberBytesLeft = p_Size - numberBytesConsumed;
+
+        if (!ReservePendingData(p_Shard, p_Connection, numberBytesLeft))
+        {
+            return false;
+        }
+
+        std::memcpy(p_Connection.m_PendingData.GetData(), data + numberBytesConsumed, numberBytesLeft);
+        p_Connection.m_PendingSize = numberBytesLeft;
+        StartFrameTimer(p_Shard, p_Connection);
+    }
+
+    return true;
+}
+
+bool
+DataTransmissionServer::ConsumeFrames(
+    IoShard& p_Shard,
+    Connection& p_Connection,
+    const BufferReference& p_Buffer,
+    const Byte* p_Data,
+    const uint32_t p_Size,
+    uint32_t& p_NumberBytesConsumed)
+{
+    p_NumberBytesConsumed = 0;
+
+    while (p_Size - p_NumberBytesConsumed >= DataTransmissionFrameHeader::c_SerializedSize)
+    {
+        if (p_Connection.GetNumberInFlightRequests() >= m_MaxNumberInFlightRequestsPerConnection)
+        {
+            //
+            // In-flight limit reached; the remaining frames are kept until responses are written back.
+            //
+            break;
+        }
+
+        const Byte* frame = p_Data + p_NumberBytesConsumed;
+        DataTransmissionFrameHeader header;
+        StatusCode status = DataTransmissionProtocol::DeserializeFrameHeader(frame, header);
+
+        if (Status::Succeeded(status) &&
+            header.m_PayloadSize > m_MaxPacketSize)
+        {
+            status = Status::PacketTooLarge;
+        }
+
+        if (Status::Failed(status))
+        {
+            //
+            // The stream cannot be resynchronized after a malformed or oversized header.
+            //
+            FailConnection(p_Shard, p_Connection, header.m_PacketTag, status);
+
+            return false;
+        }
+
+        const uint32_t headerSize = DataTransmissionProtocol::GetHeaderSize(header.m_Flags);
+        const uint32_t frameSize = headerSize + header.m_PayloadSize;
+
+        if (p_Size - p_NumberBytesConsumed < frameSize)
+        {
+            //
+            // Incomplete extensions or payload; wait for the rest of the frame.
+            //
+            break;
+        }
+
+        DataTransmissionProtocol::DeserializeHeaderExtensions(frame, header);
+
+        //
+        // The time budget of the request is made absolute on arrival; requests without one never expire.
+        //
+        const std::chrono::steady_clock::time_point deadline = (header.m_Flags & DataTransmissionFrameHeader::c_FlagDeadline) ?
+            std::chrono::steady_clock::now() + std::chrono::microseconds(header.m_DeadlineMicroseconds) :
+            std::chrono::steady_clock::time_point::max();
+
+        //
+        // The packet is handed over as a view into the receive buffer, which the dispatched task keeps alive.
+        //
+        const std::string_view packet(reinterpret_cast<const char*>(frame + headerSize), header.m_PayloadSize);
+        p_NumberBytesConsumed += frameSize;
+
+        if ((header.m_Flags & DataTransmissionFrameHeader::c_FlagChecksum) &&
+            Crc32c::Compute(frame + headerSize, header.m_PayloadSize) != header.m_Checksum)
+        {
+            //
+            // The payload was corrupted in transit; it never reaches the endpoint. The frame boundaries
+            // are still known, so the connection carries on with the next frame.
+            //
+            AddShardCounter(p_Shard, &ThreadStatistics::m_NumberChecksumFailures, 1u);
+            CompleteRequest(p_Shard, p_Connection, p_Connection.m_NextRequestSequence++, header.m_PacketTag, Status::ChecksumMismatch);
+
+            continue;
+        }
+
+        DispatchPacket(p_Shard, p_Connection, header.m_PacketTag, deadline, p_Buffer, packet);
+    }
+
+    return true;
+}
+
+uint32_t
+DataTransmissionServer::GetPendingFrameSize(
+    const Connection& p_Connection) const
+{
+    if (p_Connection.m_PendingSize < DataTransmissionFrameHeader::c_SerializedSize)
+    {
+        return DataTransmissionFrameHeader::c_SerializedSize;
+    }
+
+    DataTransmissionFrameHeader header;
+
+    if (Status::Failed(DataTransmissionProtocol::DeserializeFrameHeader(p_Connection.m_PendingData.GetData(), header)) ||
+        header.m_PayloadSize > m_MaxPacketSize)
+    {
+        //
+        // Report the frame as complete so that consuming it surfaces the failure.
+        //
+        return p_Connection.m_PendingSize;
+    }
+
+    return DataTransmissionProtocol::GetHeaderSize(header.m_Flags) + header.m_PayloadSize;
+}
+
+bool
+DataTransmissionServer::ReservePendingData(
+    IoShard& p_Shard,
+    Connection& p_Connection,
+    const uint32_t p_Size)
+{
+    if (p_Connection.m_PendingData &&
+        !p_Connection.m_PendingData.IsShared() &&
+        p_Connection.m_PendingData.GetCapacity() >= p_Size)
+    {
+        return true;
+    }
+
+    BufferReference buffer = p_Shard.m_BufferPool.Acquire(p_Size);
+
+    if (!buffer)
+    {
+        ReleaseConnection(p_Shard, p_Connection);
+
+        return false;
+    }
+
+    if (p_Connection.m_PendingSize != 0)
+    {
+        std::memcpy(buffer.GetData(), p_Connection.m_PendingData.GetData(), p_Connection.m_PendingSize);
+    }
+
+    p_Connection.m_PendingData = std::move(buffer);
+
+    return true;
+}
+
+bool
+DataTransmissionServer::CompactPendingData(
+    IoShard& p_Shard,
+    Connection& p_Connection,
+    const uint32_t p_Offset)
+{
+    const Byte* pendingData = p_Connection.m_PendingData.GetData() + p_Offset;
+
+    if (!p_Connection.m_PendingData.IsShared())
+    {
+        std::memmove(p_Connection.m_PendingData.GetData(), pendingData, p_Connection.m_PendingSize);
+
+        return true;
+    }
+
+    //
+    // Endpoints are reading the consumed frames; move the remaining bytes to a fresh buffer instead.
+    //
+    BufferReference buffer = p_Shard.m_BufferPool.Acquire(p_Connection.m_PendingSize);
+
+    if (!buffer)
+    {
+        ReleaseConnection(p_Shard, p_Connection);
+
+        return false;
+    }
+
+    std::memcpy(buffer.GetData(), pendingData, p_Connection.m_PendingSize);
+    p_Connection.m_PendingData = std::move(buffer);
+
+    return true;
+}
+
+void
+DataTransmissionServer::DispatchPacket(
+    IoShard& p_Shard,
+    Connection& p_Connection,
+    const PacketTag p_PacketTag,
+    const std::chrono::steady_clock::time_point p_Deadline,
+    const BufferReference& p_Buffer,
+    const std::string_view p_Packet)
+{
+    if (p_PacketTag == c_SharedMemoryPacketTag)
+    {
+        //
+        // Answered right away, since the channel handles travel along with the response header.
+        //
+        OpenSharedMemoryChannel(p_Shard, p_Connection);
+
+        return;
+    }
+
+    const uint64_t sequence = p_Connection.m_NextRequestSequence++;
+
+    if (p_PacketTag == c_StatisticsPacketTag)
+    {
+        //
+        // Served by the shard itself; it must keep answering while the workers are saturated.
+        //
+        ServeStatistics(p_Shard, p_Connection, sequence);
+
+        return;
+    }
+
+    //
+    // Resolve the endpoint to execute with a single probe into the dispatch table.
+    //
+    const DispatchTable::Entry* entry = m_DispatchTable.Find(p_PacketTag);
+
+    if (entry == nullptr)
+    {
+        //
+        // Unknown packet tag.
+        // Do not enqueue the request and complete it immediately.
+        //
+        AddShardCounter(p_Shard, &ThreadStatistics::m_NumberUnknownPacketTags, 1u);
+        CompleteRequest(p_Shard, p_Connection, sequence, p_PacketTag, Status::UnknownPacketTag);
+
+        return;
+    }
+
+    if (entry->m_Endpoint->GetExecutionMode() == EndpointExecutionMode::Inline &&
+        !entry->m_Endpoint->IsCoroutine())
+    {
+        ExecuteInline(p_Shard, p_Connection, sequence, *entry, p_Deadline, p_Packet);
+
+        return;
+    }
+
+    //
+    // Batch the task for execution; the batch is submitted to the pool once all the data available
+    // in this event loop iteration is decoded, so the pool is locked and woken up once per batch.
+    // The task is stored inline, so dispatching allocates no memory once the batch is warmed up; it
+    // holds a reference to the receive buffer so that the packet view stays valid.
+    // The dispatch time lets the worker measure how long the request waited in the queue, and the
+    // deadline lets it drop the request if nobody is waiting for the response anymore.
+    //
+    p_Shard.m_DispatchBatch.Add(
+        entry->m_Endpoint->GetPriorityClass(),
+        &DataTransmissionServer::DispatcherProxy,
+        this,
+        &p_Shard,
+        entry,
+        p_Connection.shared_from_this(),
+        sequence,
+        std::chrono::steady_clock::now(),
+        p_Deadline,
+        p_Buffer,
+        p_Packet);
+
+    p_Shard.m_BatchedRequests.push_back(BatchedRequest { &p_Connection, sequence, p_PacketTag });
+}
+
+void
+DataTransmissionServer::ExecuteInline(
+    IoShard& p_Shard,
+    Connection& p_Connection,
+    const uint64_t p_Sequence,
+    const DispatchTable::Entry& p_Entry,
+    const std::chrono::steady_clock::time_point p_Deadline,
+    const std::string_view p_Packet)
+{
+    //
+    // Run the endpoint right here on the shard thread; there is no queue to wait in or to shed from,
+    // and its statistics are recorded in the slot of the shard.
+    //
+    ResponseWriter response(&p_Shard.m_ResponseBufferPool, m_MaxPacketSize);
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    if (startTime >= p_Deadline)
+    {
+        //
+        // Only reachable with an empty time budget, since the request did not wait anywhere.
+        //
+        AddShardCounter(p_Shard, &ThreadStatistics::m_NumberExpiredRequests, 1u);
+        CompleteRequest(p_Shard, p_Connection, p_Sequence, p_Entry.m_PacketTag, Status::DeadlineExceeded);
+
+        return;
+    }
+
+    response.SetDeadline(p_Deadline);
+
+    //
+    // An exception from the endpoint is turned into a failed status there, so it cannot unwind
+    // through the event loop of the shard.
+    //
+    const StatusCode status = ExecuteEndpoint(
+        p_Entry,
+        p_Shard.m_Statistics,
+        startTime,
+        startTime,
+        p_Packet,
+        response);
+
+    if (p_Shard.m_Statistics != nullptr)
+    {
+        m_Statistics.GetEndpointStatistics(*p_Shard.m_Statistics, p_Entry.m_EndpointIndex)->m_EndToEndTime.Record(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count());
+    }
+
+    const uint32_t payloadSize = response.GetSize();
+
+    CompleteRequest(p_Shard, p_Connection, p_Sequence, p_Entry.m_PacketTag, status, response.TakeBuffer(), payloadSize);
+}
+
+void
+DataTransmissionServer::AddShardCounter(
+    IoShard& p_Shard,
+    std::atomic<uint64_t> ThreadStatistics::* p_Counter,
+    const uint64_t p_Value)
+{
+    if (p_Shard.m_Statistics != nullptr)
+    {
+        ThreadStatistics::Add(p_Shard.m_Statistics->*p_Counter, p_Value);
+    }
+}
+
+void
+DataTransmissionServer::ServeStatistics(
+    IoShard& p_Shard,
+    Connection& p_Connection,
+    const uint64_t p_Sequence)
+{
+    StatisticsSnapshot snapshot;
+    ResponseWriter response(&p_Shard.m_ResponseBufferPool, m_MaxPacketSize);
+
+    StatusCode status = GetStatistics(snapshot);
+
+    if (Status::Succeeded(status))
+    {
+        status = snapshot.Serialize(response);
+    }
+
+    const uint32_t payloadSize = Status::Succeeded(status) ? response.GetSize() : 0u;
+
+    CompleteRequest(p_Shard, p_Connection, p_Sequence, c_StatisticsPacketTag, status, response.TakeBuffer(), payloadSize);
+}
+
+void
+DataTransmissionServer::OpenSharedMemoryChannel(
+    IoShard& p_Shard,
+    Connection& p_Connection)
+{
+    const uint64_t sequence = p_Connection.m_NextRequestSequence++;
+
+    //
+    // The response skips the output queue, so the connection must have nothing else to answer or send.
+    //
+    if (!p_Connection.m_IsUnixDomain ||
+        m_SharedMemoryRingSize == 0 ||
+        !p_Connection.m_LinkedConnection.expired() ||
+        p_Connection.GetNumberInFlightRequests() != 1u ||
+        !p_Connection.m_OutputSegments.empty() ||
+        p_Connection.m_IsSendInFlight)
+    {
+        CompleteRequest(p_Shard, p_Connection, sequence, c_SharedMemoryPacketTag, Status::InvalidArgument);
+
+        return;
+    }
+
+    std::shared_ptr<Connection> channelConnection;
+    StatusCode status;
+
+    try
+    {
+        channelConnection = std::allocate_shared<Connection>(SlabAllocatorAdapter<Connection>(&m_SlabAllocator), -1, m_MaxNumberInFlightRequestsPerConnection, &m_SlabAllocator);
+        channelConnection->m_Channel = std::make_unique<SharedMemoryChannel>();
+
+        status = channelConnection->m_Channel->Create(m_SharedMemoryRingSize);
+    }
+    catch (const std::bad_alloc& e)
+    {
+        status = Status::OutOfMemory;
+    }
+
+    if (Status::Succeeded(status))
+    {
+        //
+        // The channel connection waits on the server doorbell and owns it from here on.
+        //
+        channelConnection->m_Handle = channelConnection->m_Channel->ReleaseServerDoorbellHandle();
+
+        if (m_IoBackend == IoBackend::Epoll)
+        {
+            status = p_Shard.m_EventLoop.Register(channelConnection->m_Handle, EPOLLIN | EPOLLET, channelConnection.get());
+        }
+    }
+
+    if (Status::Succeeded(status))
+    {
+        try
+        {
+            p_Shard.m_Connections.emplace(channelConnection->m_Handle, channelConnection);
+        }
+        catch (const std::bad_alloc& e)
+        {
+            status = Status::OutOfMemory;
+        }
+    }
+
+    if (Status::Failed(status))
+    {
+        if (channelConnection &&
+            channelConnection->m_Handle >= 0 &&
+            m_IoBackend == IoBackend::Epoll)
+        {
+            p_Shard.m_EventLoop.Unregister(channelConnection->m_Handle);
+        }
+
+        CompleteRequest(p_Shard, p_Connection, sequence, c_SharedMemoryPacketTag, status);
+
+        return;
+    }
+
+    channelConnection->m_LinkedConnection = p_Connection.shared_from_this();
+    p_Connection.m_LinkedConnection = channelConnection;
+
+    //
+    // Send the response header with the memory and doorbell handles attached. The socket is idle and
+    // the header small, so it is sent synchronously; a client not reading it is dropped.
+    //
+    Byte header[DataTransmissionProtocol::c_ResponseHeaderSize];
+    DataTransmissionProtocol::SerializeResponseHeader(c_SharedMemoryPacketTag, Status::Success, 0u, header);
+
+    const SharedMemoryChannel& channel = *channelConnection->m_Channel;
+    const FileDescriptor handles[SharedMemoryChannel::c_NumberHandles] =
+    {
+        channel.GetMemoryHandle(),
+        channelConnection->m_Handle,
+        channel.GetClientDoorbellHandle()
+    };
+
+    alignas(cmsghdr) Byte control[CMSG_SPACE(sizeof(handles))] = {};
+    iovec vector { header, sizeof(header) };
+    msghdr message {};
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1u;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    cmsghdr* controlHeader = CMSG_FIRSTHDR(&message);
+    controlHeader->cmsg_level = SOL_SOCKET;
+    controlHeader->cmsg_type = SCM_RIGHTS;
+    controlHeader->cmsg_len = CMSG_LEN(sizeof(handles));
+    std::memcpy(CMSG_DATA(controlHeader), handles, sizeof(handles));
+
+    ++p_Connection.m_NextResponseSequence;
+
+    if (sendmsg(p_Connection.m_Handle, &message, MSG_DONTWAIT | MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(header)))
+    {
+        ReleaseConnection(p_Shard, p_Connection);
+
+        return;
+    }
+
+    AddShardCounter(p_Shard, &ThreadStatistics::m_NumberBytesWritten, sizeof(header));
+
+    StartConnectionTimer(p_Shard, *channelConnection);
+
+    if (m_IoBackend == IoBackend::IoUring)
+    {
+        ArmIoRingReceive(p_Shard, *channelConnection);
+    }
+
+    //
+    // Reading the empty ring announces that the server waits on its doorbell, so that the first request rings it.
+    //
+    ReadConnection(p_Shard, *channelConnection);
+}
+
+void
+DataTransmissionServer::ProcessChannelDoorbell(
+    IoShard& p_Shard,
+    Connection& p_Connection)
+{
+    SharedMemoryChannel::ClearNotifications(p_Connection.m_Handle);
+
+    //
+    // The client rings either after writing requests into an empty ring or after making room in a full one.
+    //
+    if (p_Connection.m_IsWriteBlocked)
+    {
+        p_Connection.m_IsWriteBlocked = false;
+        WriteConnection(p_Shard, p_Connection);
+    }
+
+    ReadConnection(p_Shard, p_Connection);
+}
+
+void
+DataTransmissionServer::CompleteRequest(
+    IoShard& p_Shard,
+    Connection& p_Connection,
+    const uint64_t p_Sequence,
+    const PacketTag p_PacketTag,
+    const StatusCode p_Status,
+    BufferReference&& p_Payload,
+    const uint32_t p_PayloadSize)
+{
+    if (p_Connection.m_Handle < 0)
+    {
+        //
+        // The connection was released while the request was in execution; drop the response.
+        //
+        return;
+    }
+
+    PendingResponse& response = p_Connection.m_Responses[p_Sequence % p_Connection.m_Responses.size()];
+    response.m_IsReady = true;
+    response.m_PacketTag = p_PacketTag;
+    response.m_Status = p_Status;
+    response.m_Payload = std::move(p_Payload);
+    response.m_PayloadSize = p_PayloadSize;
+
+    if (!p_Connection.m_IsWriteScheduled)
+    {
+        p_Connection.m_IsWriteScheduled = true;
+        p_Shard.m_ScheduledConnections.push_back(&p_Connection);
+    }
+}
+
+void
+DataTransmissionServer::FailConnection(
+    IoShard& p_Shard,
+    Connection& p_Connection,
+    const PacketTag p_PacketTag,
+    const StatusCode p_Status)
+{
+    const uint64_t sequence = p_Connection.m_NextRequestSequence++;
+    p_Connection.m_IsReadShutdown = true;
+
+    CompleteRequest(p_Shard, p_Connection, sequence, p_PacketTag, p_Status);
+}
+
+void
+DataTransmissionServer::PostCompletion(
+    IoShard& p_Shard,
+    Completion&& p_Completion)
+{
+    bool wakeupRequired;
+
+    {
+        std::unique_lock<std::mutex> lock(p_Shard.m_CompletionLock);
+
+        //
+        // Only the first completion of a batch needs to wake the shard up; the rest are picked up along with it.
+        //
+        wakeupRequired = p_Shard.m_Completions.empty();
+        p_Shard.m_Completions.emplace_back(std::move(p_Completion));
+    }
+
+    if (wakeupRequired)
+    {
+        const uint64_t wakeup = 1u;
+        write(p_Shard.m_WakeupHandle, &wakeup, sizeof(wakeup));
+    }
+}
+
+void
+DataTransmissionServer::ProcessCompletions(
+    IoShard& p_Shard)
+{
+    uint64_t wakeups;
+    read(p_Shard.m_WakeupHandle, &wakeups, sizeof(wakeups));
+
+    {
+        std::unique_lock<std::mutex> lock(p_Shard.m_CompletionLock);
+        std::swap(p_Shard.m_Completions, p_Shard.m_CompletionsInProcess);
+    }
+
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    for (Completion& completion : p_Shard.m_CompletionsInProcess)
+    {
+        if (p_Shard.m_Statistics != nullptr)
+        {
+            const DispatchTable::Entry* entry = m_DispatchTable.Find(completion.m_PacketTag);
+
+            if (entry != nullptr)
+            {
+                EndpointStatistics* endpointStatistics = m_Statistics.GetEndpointStatistics(*p_Shard.m_Statistics, entry->m_EndpointIndex);
+
+                endpointStatistics->m_EndToEndTime.Record(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(now - completion.m_DispatchTime).count());
+            }
+        }
+
+        CompleteRequest(
+            p_Shard,
+            *completion.m_Connection,
+            completion.m_Sequence,
+            completion.m_PacketTag,
+            completion.m_Status,
+            std::move(completion.m_Payload),
+            completion.m_PayloadSize);
+    }
+
+    //
+    // Write the responses while the completions still keep their connections alive.
+    //
+    WriteScheduledConnections(p_Shard);
+    p_Shard.m_CompletionsInProcess.clear();
+}
+
+void
+DataTransmissionServer::SubmitDispatchBatch(
+    IoShard& p_Shard)
+{
+    if (p_Shard.m_DispatchBatch.IsEmpty())
+    {
+        return;
+    }
+
+    //
+    // Count the requests as in execution before any of them can finish, and take the rejected ones back.
+    //
+    const size_t numberRequests = p_Shard.m_DispatchBatch.GetSize();
+    size_t numberEnqueuedRequests;
+
+    m_NumberRequestsInExecution += numberRequests;
+
+    const StatusCode status = m_ThreadPool.EnqueueBatch(p_Shard.m_DispatchBatch, numberEnqueuedRequests);
+
+    EndRequestsInExecution(numberRequests - numberEnqueuedRequests);
+
+    //
+    // The pool is stopping or its queue is full; answer the rest right away without executing them.
+    // Their tasks are still in the batch and keep the connections alive meanwhile.
+    //
+    for (size_t requestIndex = numberEnqueuedRequests; requestIndex < numberRequests; ++requestIndex)
+    {
+        const BatchedRequest& request = p_Shard.m_BatchedRequests[requestIndex];
+
+        CompleteRequest(p_Shard, *request.m_Connection, request.m_Sequence, request.m_PacketTag, status);
+    }
+
+    p_Shard.m_DispatchBatch.Clear();
+    p_Shard.m_BatchedRequests.clear();
+}
+
+void
+DataTransmissionServer::WriteScheduledConnections(
+    IoShard& p_Shard)
+{
+    FOREVER
+    {
+        //
+        // Rejected requests schedule their connections, and resuming reads decodes further requests,
+        // so alternate between both until nothing is left.
+        //
+        SubmitDispatchBatch(p_Shard);
+
+        if (p_Shard.m_ScheduledConnections.empty())
+        {
+            return;
+        }
+
+        //
+        // Resuming reads can schedule further connections, so the list may grow while being traversed.
+        //
+        for (size_t connectionIndex = 0; connectionIndex < p_Shard.m_ScheduledConnections.size(); ++connectionIndex)
+        {
+            Connection& connection = *p_Shard.m_ScheduledConnections[connectionIndex];
+            connection.m_IsWriteScheduled = false;
+
+            WriteConnection(p_Shard, connection);
+
+            if (connection.m_IsReadSuspended)
+            {
+                ReadConnection(p_Shard, connection);
+            }
+        }
+
+        p_Shard.m_ScheduledConnections.clear();
+    }
+}
+
+void
+DataTransmissionServer::WriteConnection(
+    IoShard& p_Shard,
+    Connection& p_Connection)
+{
+    if (p_Connection.m_Handle < 0 ||
+        p_Connection.m_IsSendInFlight)
+    {
+        return;
+    }
+
+    //
+    // Serialize the responses that are ready in request order.
+    //
+    FOREVER
+    {
+        PendingResponse& response = p_Connection.m_Responses[p_Connection.m_NextResponseSequence % p_Connection.m_Responses.size()];
+
+        if (p_Connection.m_NextResponseSequence == p_Connection.m_NextRequestSequence ||
+            !response.m_IsReady)
+        {
+            break;
+        }
+
+        const size_t headersSize = p_Connection.m_OutputHeaders.size();
+
+        try
+        {
+            p_Connection.m_OutputHeaders.resize(headersSize + DataTransmissionProtocol::c_ResponseHeaderSize);
+
+            //
+            // Consecutive headers share a single segment; payloads get one of their own,
+            // referencing the buffer the endpoint filled.
+            //
+            if (!p_Connection.m_OutputSegments.empty() &&
+                !p_Connection.m_OutputSegments.back().m_Payload &&
+                p_Connection.m_OutputSegments.back().m_Offset + p_Connection.m_OutputSegments.back().m_Size == headersSize)
+            {
+                p_Connection.m_OutputSegments.back().m_Size += DataTransmissionProtocol::c_ResponseHeaderSize;
+            }
+            else
+            {
+                p_Connection.m_OutputSegments.push_back(
+                    OutputSegment { BufferReference(), static_cast<uint32_t>(headersSize), DataTransmissionProtocol::c_ResponseHeaderSize });
+            }
+
+            if (response.m_PayloadSize != 0)
+            {
+                p_Connection.m_OutputSegments.push_back(
+                    OutputSegment { std::move(response.m_Payload), 0u, response.m_PayloadSize });
+            }
+        }
+        catch (const std::bad_alloc& e)
+        {
+            ReleaseConnection(p_Shard, p_Connection);
+
+            return;
+        }
+
+        DataTransmissionProtocol::SerializeResponseHeader(
+            response.m_PacketTag,
+            response.m_Status,
+            response.m_PayloadSize,
+            p_Connection.m_OutputHeaders.data() + headersSize);
+
+        response.m_IsReady = false;
+        response.m_Payload.Reset();
+        ++p_Connection.m_NextResponseSequence;
+    }
+
+    if (m_IoBackend == IoBackend::IoUring &&
+        !p_Connection.m_Channel &&
+        p_Connection.m_OutputSegmentIndex < p_Connection.m_OutputSegments.size())
+    {
+        //
+        // Queue the send; it is batched with the rest of the iteration and continued on completion.
+        //
+        SubmitIoRingSend(p_Shard, p_Connection);
+
+        return;
+    }
+
+    //
+    // Send headers and payloads in a single call each time; the remainder is kept if the socket send buffer fills up.
+    //
+    while (p_Connection.m_OutputSegmentIndex < p_Connection.m_OutputSegments.size() &&
+        !p_Connection.m_IsWriteBlocked)
+    {
+        PrepareOutputVector(p_Connection);
+
+        const ssize_t sendResult = SendOutputVector(p_Connection);
+
+        if (sendResult >= 0)
+        {
+            AddShardCounter(p_Shard, &ThreadStatistics::m_NumberBytesWritten, static_cast<uint64_t>(sendResult));
+            AdvanceOutput(p_Connection, static_cast<size_t>(sendResult));
+            p_Connection.m_LastActivityTime = p_Shard.m_TimerWheel.GetCurrentTime();
+
+            continue;
+        }
+
+        if (errno == EINTR)
+        {
+            continue;
+        }
+
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            //
+            // Wait for the socket to become writable again, or for the channel doorbell.
+            //
+            p_Connection.m_IsWriteBlocked = true;
+
+            break;
+        }
+
+        ReleaseConnection(p_Shard, p_Connection);
+
+        return;
+    }
+
+    if (p_Connection.m_OutputSegmentIndex == p_Connection.m_OutputSegments.size() &&
+        p_Connection.m_IsReadShutdown &&
+        p_Connection.GetNumberInFlightRequests() == 0)
+    {
+        //
+        // No more requests will be received and all responses were written; close the connection.
+        //
+        ReleaseConnection(p_Shard, p_Connection);
+
+        return;
+    }
+
+    //
+    // The connection may have become idle.
+    //
+    ScheduleConnectionTimer(p_Shard, p_Connection);
+}
+
+void
+DataTransmissionServer::PrepareOutputVector(
+    Connection& p_Connection)
+{
+    const size_t numberVectors = std::min(
+        p_Connection.m_OutputSegments.size() - p_Connection.m_OutputSegmentIndex,
+        c_MaxNumberOutputVectors);
+
+    p_Connection.m_OutputVector.resize(numberVectors);
+
+    for (size_t vectorIndex = 0; vectorIndex < numberVectors; ++vectorIndex)
+    {
+        const OutputSegment& segment = p_Connection.m_OutputSegments[p_Connection.m_OutputSegmentIndex + vectorIndex];
+        const uint32_t offset = vectorIndex == 0 ? p_Connection.m_OutputOffset : 0u;
+
+        Byte* data = segment.m_Payload ?
+            segment.m_Payload.GetData() :
+            p_Connection.m_OutputHeaders.data();
+
+        p_Connection.m_OutputVector[vectorIndex].iov_base = data + segment.m_Offset + offset;
+        p_Connection.m_OutputVector[vectorIndex].iov_len = segment.m_Size - offset;
+    }
+
+    p_Connection.m_OutputMessage.msg_iov = p_Connection.m_OutputVector.data();
+    p_Connection.m_OutputMessage.msg_iovlen = numberVectors;
+}
+
+ssize_t
+DataTransmissionServer::SendOutputVector(
+    Connection& p_Connection)
+{
+    if (!p_Connection.m_Channel)
+    {
+        return sendmsg(p_Connection.m_Handle, &p_Connection.m_OutputMessage, MSG_NOSIGNAL);
+    }
+
+    SharedMemoryRing& ring = p_Connection.m_Channel->GetResponseRing();
+    size_t size = ring.Write(p_Connection.m_OutputMessage.msg_iov, p_Connection.m_OutputMessage.msg_iovlen);
+
+    if (size == 0)
+    {
+        if (ring.PrepareProducerWait())
+        {
+            errno = EAGAIN;
+
+            return -1;
+        }
+
+        size = ring.Write(p_Connection.m_OutputMessage.msg_iov, p_Connection.m_OutputMessage.msg_iovlen);
+    }
+
+    if (ring.ShouldWakeConsumer())
+    {
+        SharedMemoryChannel::Notify(p_Connection.m_Channel->GetClientDoorbellHandle());
+    }
+
+    return static_cast<ssize_t>(size);
+}
+
+void
+DataTransmissionServer::AdvanceOutput(
+    Connection& p_Connection,
+    size_t p_NumberBytesSent)
+{
+    while (p_NumberBytesSent != 0)
+    {
+        OutputSegment& segment = p_Connection.m_OutputSegments[p_Connection.m_OutputSegmentIndex];
+        const uint32_t remainingSize = segment.m_Size - p_Connection.m_OutputOffset;
+
+        if (p_NumberBytesSent < remainingSize)
+        {
+            p_Connection.m_OutputOffset += static_cast<uint32_t>(p_NumberBytesSent);
+
+            return;
+        }
+
+        //
+        // Return the payload buffer to its pool as soon as it has been sent.
+        //
+        segment.m_Payload.Reset();
+        p_NumberBytesSent -= remainingSize;
+        p_Connection.m_OutputOffset = 0;
+        ++p_Connection.m_OutputSegmentIndex;
+    }
+
+    if (p_Connection.m_OutputSegmentIndex == p_Connection.m_OutputSegments.size())
+    {
+        p_Connection.m_OutputSegments.clear();
+        p_Connection.m_OutputHeaders.clear();
+        p_Connection.m_OutputSegmentIndex = 0;
+    }
+}
+
+void
+DataTransmissionServer::ReleaseConnection(
+    IoShard& p_Shard,
+    Connection& p_Connection)
+{
+    if (p_Connection.m_Handle < 0)
+    {
+        return;
+    }
+
+    p_Shard.m_TimerWheel.Cancel(p_Connection.m_Timer);
+
+    const auto connectionIterator = p_Shard.m_Connections.find(p_Connection.m_Handle);
+
+    if (p_Connection.m_NumberPendingIoOperations != 0)
+    {
+        //
+        // io_uring operations keep their own reference to the socket; shutting it down completes them.
+        // The doorbell poll of a channel is cancelled instead.
+        //
+        if (p_Connection.m_Channel)
+        {
+            p_Shard.m_IoRing.PrepareCancel(reinterpret_cast<uint64_t>(&p_Connection) | static_cast<uint64_t>(IoRingOperation::Doorbell));
+        }
+        else
+        {
+            shutdown(p_Connection.m_Handle, SHUT_RDWR);
+        }
+    }
+
+    if (p_Connection.m_Channel &&
+        m_IoBackend == IoBackend::Epoll)
+    {
+        //
+        // The client holds a copy of the doorbell, so closing it would not remove it from the event loop.
+        //
+        p_Shard.m_EventLoop.Unregister(p_Connection.m_Handle);
+    }
+
+    //
+    // Closing the handle also removes it from the event loop. The state itself is destroyed once
+    // the current event loop iteration ends and no in-flight request or io_uring operation references it anymore.
+    //
+    close(p_Connection.m_Handle);
+    p_Connection.m_Handle = -1;
+
+    if (connectionIterator != p_Shard.m_Connections.end())
+    {
+        p_Shard.m_ReleasedConnections.emplace_back(std::move(connectionIterator->second));
+        p_Shard.m_Connections.erase(connectionIterator);
+    }
+
+    //
+    // A channel is only usable along with the AF_UNIX connection it was set up over, and the other way around.
+    //
+    if (const std::shared_ptr<Connection> linkedConnection = p_Connection.m_LinkedConnection.lock())
+    {
+        ReleaseConnection(p_Shard, *linkedConnection);
+    }
+}
+
+void
+DataTransmissionServer::StartConnectionTimer(
+    IoShard& p_Shard,
+    Connection& p_Connection)
+{
+    p_Connection.m_LastActivityTime = p_Shard.m_TimerWheel.GetCurrentTime();
+    ScheduleConnectionTimer(p_Shard, p_Connection);
+}
+
+void
+DataTransmissionServer::StartFrameTimer(
+    IoShard& p_Shard,
+    Connection& p_Connection)
+{
+    p_Connection.m_FrameStartTime = p_Shard.m_TimerWheel.GetCurrentTime();
+    ScheduleConnectionTimer(p_Shard, p_Connection);
+}
+
+void
+DataTransmissionServer::ScheduleConnectionTimer(
+    IoShard& p_Shard,
+    Connection& p_Connection)
+{
+    if (p_Connection.m_Handle < 0)
+    {
+        return;
+    }
+
+    const std::chrono::steady_clock::time_point deadline = GetConnectionDeadline(p_Connection);
+
+    if (deadline != std::chrono::steady_clock::time_point::max() &&
+        (!p_Connection.m_Timer.IsScheduled() || p_Shard.m_TimerWheel.GetExpiryTime(p_Connection.m_Timer) > deadline))
+    {
+        p_Shard.m_TimerWheel.Schedule(p_Connection.m_Timer, deadline);
+    }
+}
+
+std::chrono::steady_clock::time_point
+DataTransmissionServer::GetConnectionDeadline(
+    const Connection& p_Connection) const
+{
+    if (!p_Connection.m_Channel &&
+        !p_Connection.m_LinkedConnection.expired())
+    {
+        //
+        // The AF_UNIX connection a channel was set up over carries no traffic of its own; the channel is timed instead.
+        //
+        return std::chrono::steady_clock::time_point::max();
+    }
+
+    if (p_Connection.m_PendingSize != 0)
+    {
+        //
+        // Frames held back by the server, complete ones or partial ones while reading is suspended, are not timed.
+        //
+        if (m_ReadTimeout != std::chrono::steady_clock::duration::zero() &&
+            !p_Connection.m_IsReadSuspended &&
+            p_Connection.m_PendingSize < GetPendingFrameSize(p_Connection))
+        {
+            return p_Connection.m_FrameStartTime + m_ReadTimeout;
+        }
+
+        return std::chrono::steady_clock::time_point::max();
+    }
+
+    //
+    // Responses still being sent do not keep the connection busy; a client not reading them goes idle.
+    //
+    if (m_IdleTimeout != std::chrono::steady_clock::duration::zero() &&
+        p_Connection.GetNumberInFlightRequests() == 0)
+    {
+        return p_Connection.m_LastActivityTime + m_IdleTimeout;
+    }
+
+    return std::chrono::steady_clock::time_point::max();
+}
+
+void
+DataTransmissionServer::AdvanceConnectionTimers(
+    IoShard& p_Shard)
+{
+    p_Shard.m_TimerWheel.Advance(
+        std::chrono::steady_clock::now(),
+        [this, &p_Shard](TimerWheel::Timer& p_Timer)
+        {
+            ExpireConnectionTimer(p_Shard, *static_cast<Connection*>(p_Timer.m_Context));
+        });
+}
+
+void
+DataTransmissionServer::ExpireConnectionTimer(
+    IoShard& p_Shard,
+    Connection& p_Connection)
+{
+    const std::chrono::steady_clock::time_point deadline = GetConnectionDeadline(p_Connection);
+
+    if (deadline == std::chrono::steady_clock::time_point::max())
+    {
+        //
+        // Not timed in its current state; the timer is scheduled again once it is.
+        //
+        return;
+    }
+
+    if (deadline > p_Shard.m_TimerWheel.GetCurrentTime())
+    {
+        p_Shard.m_TimerWheel.Schedule(p_Connection.m_Timer, deadline);
+
+        return;
+    }
+
+    AddShardCounter(p_Shard, &ThreadStatistics::m_NumberTimedOutConnections, 1u);
+    ReleaseConnection(p_Shard, p_Connection);
+}
+
+void
+DataTransmissionServer::AcceptIoRingConnection(
+    IoShard& p_Shard,
+    const FileDescriptor p_Handle,
+    const bool p_IsUnixDomain)
+{
+    std::shared_ptr<Connection> connection;
+
+    try
+    {
+        connection = std::allocate_shared<Connection>(SlabAllocatorAdapter<Connection>(&m_SlabAllocator), p_Handle, m_MaxNumberInFlightRequestsPerConnection, &m_SlabAllocator);
+        p_Shard.m_Connections.emplace(p_Handle, connection);
+    }
+    catch (const std::bad_alloc& e)
+    {
+        if (!connection)
+        {
+            close(p_Handle);
+        }
+
+        return;
+    }
+
+    connection->m_IsUnixDomain = p_IsUnixDomain;
+    StartConnectionTimer(p_Shard, *connection);
+    AddShardCounter(p_Shard, &ThreadStatistics::m_NumberAcceptedConnections, 1u);
+    ReadConnection(p_Shard, *connection);
+}
+
+void
+DataTransmissionServer::ArmIoRingReceive(
+    IoShard& p_Shard,
+    Connection& p_Connection)
+{
+    if (p_Connection.m_IsReceiveArmed)
+    {
+        return;
+    }
+
+    const bool isArmed = p_Connection.m_Channel ?
+        p_Shard.m_IoRing.PrepareMultishotPoll(
+            p_Connection.m_Handle,
+            POLLIN,
+            reinterpret_cast<uint64_t>(&p_Connection) | static_cast<uint64_t>(IoRingOperation::Doorbell)) :
+        p_Shard.m_IoRing.PrepareReceive(
+            p_Connection.m_Handle,
+            reinterpret_cast<uint64_t>(&p_Connection) | static_cast<uint64_t>(IoRingOperation::Receive));
+
+    if (!isArmed)
+    {
+        ReleaseConnection(p_Shard, p_Connection);
+
+        return;
+    }
+
+    p_Connection.m_IsReceiveArmed = true;
+    ++p_Connection.m_NumberPendingIoOperations;
+    ++p_Shard.m_NumberPendingIoOperations;
+}
+
+void
+DataTransmissionServer::CompleteIoRingReceive(
+    IoShard& p_Shard,
+    Connection& p_Connection,
+    const int32_t p_Result,
+    const uint32_t p_Flags)
+{
+    p_Connection.m_IsReceiveArmed = false;
+    --p_Connection.m_NumberPendingIoOperations;
+    --p_Shard.m_NumberPendingIoOperations;
+
+    //
+    // Take the buffer the kernel picked out of the provided buffer ring.
+    //
+    BufferReference buffer;
+    const uint16_t bufferId = static_cast<uint16_t>(p_Flags >> IORING_CQE_BUFFER_SHIFT);
+
+    if (p_Flags & IORING_CQE_F_BUFFER)
+    {
+        buffer = std::move(p_Shard.m_ProvidedBuffers[bufferId]);
+    }
+
+    if (p_Connection.m_Handle >= 0)
+    {
+        if (p_Result > 0 &&
+            buffer)
+        {
+            AddShardCounter(p_Shard, &ThreadStatistics::m_NumberBytesRead, static_cast<uint64_t>(p_Result));
+            p_Connection.m_LastActivityTime = p_Shard.m_TimerWheel.GetCurrentTime();
+
+            if (ConsumeReceivedData(p_Shard, p_Connection, buffer, static_cast<uint32_t>(p_Result)))
+            {
+                ReadConnection(p_Shard, p_Connection);
+            }
+        }
+        else if (p_Result == 0)
+        {
+            //
+            // Peer shut its side down; answer the requests in flight and then close.
+            //
+            p_Connection.m_IsReadShutdown = true;
+            WriteConnection(p_Shard, p_Connection);
+        }
+        else if (p_Result == -EINTR ||
+            p_Result == -EAGAIN)
+        {
+            ReadConnection(p_Shard, p_Connection);
+        }
+        else
+        {
+            //
+            // Socket error, or no provided buffer left because buffers could not be replenished.
+            //
+            ReleaseConnection(p_Shard, p_Connection);
+        }
+    }
+
+    if (p_Flags & IORING_CQE_F_BUFFER)
+    {
+        //
+        // Hand the slot back to the kernel. The buffer itself is reused unless endpoints still reference it.
+        //
+        if (!buffer.IsShared())
+        {
+            p_Shard.m_ProvidedBuffers[bufferId] = std::move(buffer);
+        }
+        else
+        {
+            p_Shard.m_ProvidedBuffers[bufferId] = p_Shard.m_BufferPool.Acquire(m_ReceiveBufferSize);
+        }
+
+        if (p_Shard.m_ProvidedBuffers[bufferId])
+        {
+            ProvideIoRingBuffer(p_Shard, bufferId);
+        }
+    }
+}
+
+void
+DataTransmissionServer::SubmitIoRingSend(
+    IoShard& p_Shard,
+    Connection& p_Connection)
+{
+    PrepareOutputVector(p_Connection);
+
+    if (!p_Shard.m_IoRing.PrepareSendMessage(
+        p_Connection.m_Handle,
+        &p_Connection.m_OutputMessage,
+        reinterpret_cast<uint64_t>(&p_Connection) | static_cast<uint64_t>(IoRingOperation::Send)))
+    {
+        ReleaseConnection(p_Shard, p_Connection);
+
+        return;
+    }
+
+    p_Connection.m_IsSendInFlight = true;
+    ++p_Connection.m_NumberPendingIoOperations;
+    ++p_Shard.m_NumberPendingIoOperations;
+}
+
+void
+DataTransmissionServer::CompleteIoRingSend(
+    IoShard& p_Shard,
+    Connection& p_Connection,
+    const int32_t p_Result)
+{
+    p_Connection.m_IsSendInFlight = false;
+    --p_Connection.m_NumberPendingIoOperations;
+    --p_Shard.m_NumberPendingIoOperations;
+
+    if (p_Connection.m_Handle < 0)
+    {
+        return;
+    }
+
+    if (p_Result < 0 &&
+        p_Result != -EINTR &&
+        p_Result != -EAGAIN)
+    {
+        ReleaseConnection(p_Shard, p_Connection);
+
+        return;
+    }
+
+    if (p_Result > 0)
+    {
+        AddShardCounter(p_Shard, &ThreadStatistics::m_NumberBytesWritten, static_cast<uint64_t>(p_Result));
+        AdvanceOutput(p_Connection, static_cast<size_t>(p_Result));
+        p_Connection.m_LastActivityTime = p_Shard.m_TimerWheel.GetCurrentTime();
+    }
+
+    //
+    // Continue with the rest of the output, including the responses that became ready meanwhile,
+    // and resume reading if it was waiting for them to be written.
+    //
+    WriteConnection(p_Shard, p_Connection);
+
+    if (p_Connection.m_IsReadSuspended)
+    {
+        ReadConnection(p_Shard, p_Connection);
+    }
+}
+
+void
+DataTransmissionServer::ProvideIoRingBuffer(
+    IoShard& p_Shard,
+    const uint16_t p_BufferId)
+{
+    const BufferReference& buffer = p_Shard.m_ProvidedBuffers[p_BufferId];
+
+    p_Shard.m_IoRing.ProvideBuffer(buffer.GetData(), buffer.GetCapacity(), p_BufferId);
+}
+
+void
+DataTransmissionServer::DropReleasedConnections(
+    IoShard& p_Shard)
+{
+    std::erase_if(
+        p_Shard.m_ReleasedConnections,
+        [](const std::shared_ptr<Connection>& p_Connection)
+        {
+            return p_Connection->m_NumberPendingIoOperations == 0;
+        });
+}
+
+bool
+DataTransmissionServer::ShouldShedRequest(
+    const std::chrono::steady_clock::time_point p_DispatchTime,
+    const std::chrono::steady_clock::time_point p_StartTime)
+{
+    if (m_QueueDelayTarget == std::chrono::steady_clock::duration::zero())
+    {
+        return false;
+    }
+
+    if (p_StartTime - p_DispatchTime < m_QueueDelayTarget)
+    {
+        //
+        // The queue drained below the target; leave the shedding state and start counting afresh.
+        //
+        if (m_IsQueueDelayAboveTarget.load(std::memory_order_relaxed))
+        {
+            std::unique_lock<std::mutex> lock(m_QueueDelayLock);
+
+            m_IsQueueDelayAboveTarget.store(false, std::memory_order_relaxed);
+            m_IsSheddingRequests = false;
+            m_SheddingCount = 0;
+        }
+
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(m_QueueDelayLock);
+
+    if (!m_IsQueueDelayAboveTarget.load(std::memory_order_relaxed))
+    {
+        //
+        // First request above the target; give the queue an interval to drain on its own.
+        //
+        m_IsQueueDelayAboveTarget.store(true, std::memory_order_relaxed);
+        m_QueueDelayIntervalEnd = p_StartTime + m_QueueDelayInterval;
+
+        return false;
+    }
+
+    if (m_IsSheddingRequests)
+    {
+        if (p_StartTime < m_NextShedTime)
+        {
+            return false;
+        }
+    }
+    else
+    {
+        if (p_StartTime < m_QueueDelayIntervalEnd)
+        {
+            return false;
+        }
+
+        m_IsSheddingRequests = true;
+        m_NextShedTime = p_StartTime;
+    }
+
+    //
+    // Space the next shed request by the interval divided by the square root of the number shed so far,
+    // so that shedding speeds up for as long as the standing queue persists.
+    //
+    ++m_SheddingCount;
+    m_NextShedTime += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double, std::chrono::steady_clock::period>(m_QueueDelayInterval.count() / std::sqrt(m_SheddingCount)));
+
+    m_NumberShedRequests.fetch_add(1, std::memory_order_relaxed);
+
+    return true;
+}
+
+void
+DataTransmissionServer::DispatcherProxy(
+    DataTransmissionServer* p_DataTransmissionServer,
+    IoShard* p_Shard,
+    const DispatchTable::Entry* p_Entry,
+    const std::shared_ptr<Connection>& p_Connection,
+    const uint64_t p_Sequence,
+    const std::chrono::steady_clock::time_point p_DispatchTime,
+    const std::chrono::steady_clock::time_point p_Deadline,
+    const BufferReference& p_Buffer,
+    const std::string_view p_Packet)
+{
+    StatusCode status = Status::Overloaded;
+    ResponseWriter response(&p_Shard->m_ResponseBufferPool, p_DataTransmissionServer->m_MaxPacketSize);
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    if (startTime >= p_Deadline)
+    {
+        //
+        // The client gave up on the request while it was queued; executing it would only take the worker
+        // away from requests that can still be answered in time.
+        //
+        ThreadStatistics* threadStatistics = p_DataTransmissionServer->GetCurrentThreadStatistics();
+
+        if (threadStatistics != nullptr)
+        {
+            ThreadStatistics::Add(threadStatistics->m_NumberExpiredRequests, 1u);
+        }
+
+        status = Status::DeadlineExceeded;
+    }
+    else if (!p_DataTransmissionServer->ShouldShedRequest(p_DispatchTime, startTime))
+    {
+        response.SetDeadline(p_Deadline);
+
+        if (p_Entry->m_Endpoint->IsCoroutine())
+        {
+            //
+            // The coroutine finishes the request on its own, possibly after releasing this worker.
+            //
+            RunCoroutineEndpoint(
+                p_DataTransmissionServer,
+                p_Shard,
+                p_Entry,
+                p_Connection,
+                p_Sequence,
+                p_DispatchTime,
+                startTime,
+                p_Deadline,
+                p_Buffer,
+                p_Packet);
+
+            return;
+        }
+
+        //
+        // Execute endpoint in an async context.
+        //
+        status = p_DataTransmissionServer->ExecuteEndpoint(
+            *p_Entry,
+            p_DataTransmissionServer->GetCurrentThreadStatistics(),
+            p_DispatchTime,
+            startTime,
+            p_Packet,
+            response);
+    }
+
+    p_DataTransmissionServer->FinishRequest(*p_Shard, *p_Entry, p_Connection, p_Sequence, p_DispatchTime, status, response);
+}
+
+DetachedTask
+DataTransmissionServer::RunCoroutineEndpoint(
+    DataTransmissionServer* p_DataTransmissionServer,
+    IoShard* p_Shard,
+    const DispatchTable::Entry* p_Entry,
+    std::shared_ptr<Connection> p_Connection,
+    const uint64_t p_Sequence,
+    const std::chrono::steady_clock::time_point p_DispatchTime,
+    const std::chrono::steady_clock::time_point p_StartTime,
+    const std::chrono::steady_clock::time_point p_Deadline,
+    [[maybe_unused]] BufferReference p_Buffer,
+    const std::string_view p_Packet)
+{
+    //
+    // The connection and the receive buffer are copied into the coroutine frame, keeping the packet view
+    // valid across suspensions; the response is built in the frame as well. The buffer is never read
+    // directly, hence maybe unused: it is only held for the packet view.
+    //
+    ResponseWriter response(&p_Shard->m_ResponseBufferPool, p_DataTransmissionServer->m_MaxPacketSize);
+    response.SetDeadline(p_Deadline);
+
+    StatusCode status;
+
+    try
+    {
+        status = co_await p_Entry->m_Endpoint->ExecuteAsync(p_Packet, response);
+    }
+    catch (...)
+    {
+        //
+        // The task rethrows what the endpoint threw. Escaping this detached coroutine would terminate
+        // the process, so fail the request as ExecuteEndpoint does.
+        //
+        static_cast<void>(response.TakeBuffer());
+        status = Status::Fail;
+    }
+
+    //
+    // Statistics go to whichever thread the coroutine finished on, a worker or the async event loop;
+    // the execution time spans its suspensions.
+    //
+    p_DataTransmissionServer->RecordExecution(
+        *p_Entry,
+        p_DataTransmissionServer->GetCurrentThreadStatistics(),
+        p_DispatchTime,
+        p_StartTime,
+        status);
+
+    p_DataTransmissionServer->FinishRequest(*p_Shard, *p_Entry, p_Connection, p_Sequence, p_DispatchTime, status, response);
+}
 
 void
-DataTransmissionServer::SendResponseAndCloseConnection(
+DataTransmissionServer::FinishRequest(
+    IoShard& p_Shard,
+    const DispatchTable::Entry& p_Entry,
+    const std::shared_ptr<Connection>& p_Connection,
+    const uint64_t p_Sequence,
+    const std::chrono::steady_clock::time_point p_DispatchTime,
     const StatusCode p_Status,
-    const FileDescriptor p_Connection)
+    ResponseWriter& p_Response)
+{
+    //
+    // Hand the response back to the shard owning the connection, which writes it in request order.
+    // The payload buffer travels along with it and is written straight from the pool.
+    //
+    const uint32_t payloadSize = p_Response.GetSize();
+
+    PostCompletion(
+        p_Shard,
+        Completion { p_Connection, p_Sequence, p_Entry.m_PacketTag, p_Status, p_DispatchTime, p_Response.TakeBuffer(), payloadSize });
+
+    //
+    // Decrement the counter once the response has been handed back.
+    //
+    EndRequestsInExecution(1u);
+}
+
+void
+DataTransmissionServer::EndRequestsInExecution(
+    const uint64_t p_NumberRequests)
+{
+    //
+    // The stop flag is set before any shard starts waiting, so checking it after the decrement never
+    // misses a waiter, while keeping the wakeup off the path of a running server.
+    //
+    if (m_NumberRequestsInExecution.fetch_sub(p_NumberRequests) == p_NumberRequests &&
+        m_IsStopped)
+    {
+        m_NumberRequestsInExecution.notify_all();
+    }
+}
+
+StatusCode
+DataTransmissionServer::ExecuteEndpoint(
+    const DispatchTable::Entry& p_Entry,
+    ThreadStatistics* p_ThreadStatistics,
+    const std::chrono::steady_clock::time_point p_DispatchTime,
+    const std::chrono::steady_clock::time_point p_StartTime,
+    const std::string_view p_Packet,
+    ResponseWriter& p_Response)
+{
+    StatusCode status;
+
+    try
+    {
+        status = p_Entry.m_Endpoint->Execute(p_Packet, p_Response);
+    }
+    catch (...)
+    {
+        //
+        // An exception escaping the endpoint would terminate the worker running it. Count it as a failed
+        // execution instead and drop whatever the endpoint wrote, so that the response still goes out in order.
+        //
+        static_cast<void>(p_Response.TakeBuffer());
+        status = Status::Fail;
+    }
+
+    RecordExecution(p_Entry, p_ThreadStatistics, p_DispatchTime, p_StartTime, status);
+
+    return status;
+}
+
+ThreadStatistics*
+DataTransmissionServer::GetCurrentThreadStatistics()
 {
-    StatusCode standardizedStatusCode = htonl(p_Status);
+    const uint32_t workerIndex = m_ThreadPool.GetCurrentWorkerIndex();
+
+    if (workerIndex < m_ThreadPool.GetNumberThreads())
+    {
+        return m_Statistics.GetThreadStatistics(workerIndex);
+    }
 
     //
-    // Send the response back to the client and close the connection.
-    // This expects that the server socket handle is still open and active.
+    // Coroutines only run outside the pool on the async event loop thread, or on the thread stopping it
+    // once that thread is gone, so the reserved statistics keep a single writer at a time.
     //
-    send(p_Connection, &standardizedStatusCode, sizeof(standardizedStatusCode), 0);
-    close(p_Connection);
+    return m_Statistics.GetThreadStatistics(m_ThreadPool.GetNumberThreads() + static_cast<uint32_t>(m_IoShards.size()));
+}
+
+void
+DataTransmissionServer::RecordExecution(
+    const DispatchTable::Entry& p_Entry,
+    ThreadStatistics* p_ThreadStatistics,
+    const std::chrono::steady_clock::time_point p_DispatchTime,
+    const std::chrono::steady_clock::time_point p_StartTime,
+    const StatusCode p_Status)
+{
+    if (p_ThreadStatistics == nullptr)
+    {
+        return;
+    }
+
+    EndpointStatistics* endpointStatistics = m_Statistics.GetEndpointStatistics(*p_ThreadStatistics, p_Entry.m_EndpointIndex);
+    const std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
+
+    endpointStatistics->m_QueueWaitTime.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(p_StartTime - p_DispatchTime).count());
+    endpointStatistics->m_ExecutionTime.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - p_StartTime).count());
+
+    if (Status::Failed(p_Status))
+    {
+        ThreadStatistics::Add(endpointStatistics->m_NumberFailedRequests, 1u);
+    }
+}
+
+DataTransmissionServer::Connection::Connection(
+    const FileDescriptor p_Handle,
+    const uint16_t p_MaxNumberInFlightRequests,
+    SlabAllocator* p_SlabAllocator)
+    : m_Handle(p_Handle),
+      m_PendingSize(0),
+      m_Responses(p_MaxNumberInFlightRequests, PendingResponse {}, SlabAllocatorAdapter<PendingResponse>(p_SlabAllocator)),
+      m_NextRequestSequence(0),
+      m_NextResponseSequence(0),
+      m_OutputHeaders(SlabAllocatorAdapter<Byte>(p_SlabAllocator)),
+      m_OutputSegments(SlabAllocatorAdapter<OutputSegment>(p_SlabAllocator)),
+      m_OutputSegmentIndex(0),
+      m_OutputOffset(0),
+      m_OutputVector(SlabAllocatorAdapter<iovec>(p_SlabAllocator)),
+      m_OutputMessage {},
+      m_IsReadSuspended(false),
+      m_IsReadShutdown(false),
+      m_IsWriteBlocked(false),
+      m_IsWriteScheduled(false),
+      m_IsReceiveArmed(false),
+      m_IsUnixDomain(false),
+      m_IsSendInFlight(false),
+      m_NumberPendingIoOperations(0)
+{
+    m_Timer.m_Context = this;
+}
+
+DataTransmissionServer::Connection::~Connection()
+{
+    if (m_Handle >= 0)
+    {
+        close(m_Handle);
+    }
 }
 
-} // namespace gX.
\ No newline at end of file
+} // namespace gX.
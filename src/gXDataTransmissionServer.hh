@@ -8,28 +8,53 @@
 #ifndef GX_DATA_TRANSMISSION_SERVER_
 #define GX_DATA_TRANSMISSION_SERVER_
 
+#include <mutex>
+#include <chrono>
 #include <string>
+#include <vector>
 #include <memory>
 #include <atomic>
 #include <cstdint>
 #include <functional>
 #include "gXStatus.hh"
+#include <sys/uio.h>
+#include <sys/socket.h>
 #include <netinet/in.h>
 #include <unordered_map>
+#include "gXEndpoint.hh"
+#include "gXDispatchTable.hh"
+#include "gXAsyncEventLoop.hh"
+#include "gXIoRing.hh"
+#include "gXEventLoop.hh"
+#include "gXBufferPool.hh"
+#include "gXSlabAllocator.hh"
 #include "gXThreadPool.hh"
+#include "gXTimerWheel.hh"
+#include "gXServerStatistics.hh"
+#include "gXSharedMemoryChannel.hh"
+#include "gXDataTransmissionProtocol.hh"
 
 namespace gX
 {
 
 //
-// Required signature for all server endpoints.
+// I/O backends supported by the DTP server.
 //
-using EndpointType = std::function<StatusCode(std::string)>;
+enum class IoBackend : uint8_t
+{
 
-//
-// DTP packet type alias.
-//
-using PacketTag = uint32_t;
+    //
+    // Edge-triggered epoll readiness notifications followed by non-blocking socket calls.
+    //
+    Epoll,
+
+    //
+    // io_uring completions: multishot accept, receives into provided buffers and batched sends,
+    // all handed to the kernel with a single system call per event loop iteration.
+    //
+    IoUring
+
+};
 
 //
 // Configurations for the DTP server.
@@ -47,6 +72,19 @@ struct DataTransmissionServerConfiguration
     //
     uint32_t m_Port;
 
+    //
+    // Path of an AF_UNIX socket the server also listens on, for clients on the same host.
+    // A leading '@' places it in the abstract namespace. Empty means no AF_UNIX socket.
+    // A socket file left by a server that is gone is replaced; Init fails if another server still listens on it.
+    //
+    std::string m_UnixSocketPath;
+
+    //
+    // Capacity of each ring of the shared memory channels clients connected over the AF_UNIX socket
+    // can set up, rounded up to a power of two. Zero disables shared memory channels.
+    //
+    uint32_t m_SharedMemoryRingSize;
+
     //
     // Receive buffer size for the DTP server.
     //
@@ -57,11 +95,101 @@ struct DataTransmissionServerConfiguration
     //
     uint16_t m_ThreadPoolSize;
 
+    //
+    // Scheduling policy of the thread pool for the DTP server.
+    //
+    ThreadPoolScheduler m_ThreadPoolScheduler;
+
+    //
+    // Priority classes of the thread pool, each with its own queue, weight and concurrency limit.
+    // Endpoints pick their class through Endpoint::SetPriorityClass. Empty means a single class.
+    //
+    std::vector<ThreadPoolPriorityClass> m_PriorityClasses;
+
+    //
+    // Policy for choosing which priority class the workers serve next.
+    //
+    ThreadPoolPriorityPolicy m_PriorityPolicy;
+
     //
     // Maximum number of TCP connections allowed on the internal queue.
     //
     uint16_t m_MaxNumberAllowedConnections;
 
+    //
+    // Number of I/O shards. Each shard owns a listening socket bound to the same port
+    // through SO_REUSEPORT, its own event loop thread and its own receive buffer.
+    // Zero means one shard per available core.
+    //
+    uint16_t m_NumberIoShards;
+
+    //
+    // CPUs the I/O shard threads are pinned to, one per shard in order, wrapping around if there are
+    // fewer CPUs than shards. Each shard sets up its buffers and rings while pinned, so that they are
+    // allocated on the node of its CPU. Empty means unpinned shards.
+    //
+    std::vector<uint16_t> m_IoThreadCpus;
+
+    //
+    // CPUs the thread pool workers are pinned to, grouped per NUMA node. Requests decoded by a shard are
+    // handed to workers on the node of the shard CPU whenever there are any. Empty means unpinned workers.
+    //
+    std::vector<uint16_t> m_WorkerThreadCpus;
+
+    //
+    // I/O backend used by the shards.
+    //
+    IoBackend m_IoBackend;
+
+    //
+    // Number of submission entries of each shard io_uring instance, rounded up to a power of two.
+    // Also the number of receive buffers each shard provides to the kernel. Only used by the io_uring backend.
+    //
+    uint32_t m_IoUringQueueDepth;
+
+    //
+    // Maximum payload size accepted for a single DTP frame.
+    // Frames announcing a larger payload are rejected and their connection is closed.
+    //
+    uint32_t m_MaxPacketSize;
+
+    //
+    // Maximum number of pipelined requests in flight per connection. Once reached, the server
+    // stops reading from the connection until responses are written back.
+    //
+    uint16_t m_MaxNumberInFlightRequestsPerConnection;
+
+    //
+    // Maximum number of requests queued for execution across the server. Once reached, new requests are
+    // answered right away with ServerBusy so that clients can back off. Zero means unbounded.
+    //
+    uint32_t m_MaxNumberQueuedRequests;
+
+    //
+    // Target queueing delay for load shedding. Once the time requests wait in the queue before a worker
+    // picks them up stays above the target for a whole interval, one queued request is shed with
+    // Overloaded instead of being executed, and further ones at shrinking intervals while the delay
+    // stays above the target. Zero, the default, disables load shedding.
+    //
+    uint32_t m_QueueDelayTargetMilliseconds;
+
+    //
+    // Time the queueing delay must stay above its target before requests are shed.
+    //
+    uint32_t m_QueueDelayIntervalMilliseconds;
+
+    //
+    // Time a frame may take to arrive once its first bytes were received. Connections trickling frames
+    // in slower than that, as slowloris clients do, are closed. Zero disables the read timeout.
+    //
+    uint32_t m_ReadTimeoutMilliseconds;
+
+    //
+    // Time a connection with no request in progress may go without traffic before being closed,
+    // including connections that never send anything. Zero keeps idle connections open indefinitely.
+    //
+    uint32_t m_IdleTimeoutMilliseconds;
+
     //
     // Flag for selecting blocking or non-blocking execution.
     //
@@ -73,17 +201,62 @@ struct DataTransmissionServerConfiguration
     //
     bool m_CleanTermination;
 
+    //
+    // Flag for collecting per-thread counters and per-endpoint latency histograms,
+    // served through the statistics packet tag.
+    //
+    bool m_EnableStatistics;
+
     //
     // DTP packet tag to function map. Maps a tag to the appropriate function binding to be executed.
-    // Establishes the signature needed to be used by all functions using the DTP protocol <StatusCode F(DataTransmissionPacket)>.
+    // Endpoints can either take their own copy of the packet <StatusCode F(std::string)>,
+    // a zero-copy view into the receive buffer <StatusCode F(std::string_view)> or a view along
+    // with a response payload to fill <StatusCode F(std::string_view, ResponseWriter&)>.
+    // Endpoint::Bind<F>() binds any of them without std::function type erasure.
+    // Cheap, non-blocking endpoints can be marked with EndpointExecutionMode::Inline to run on the
+    // I/O thread that decoded the packet instead of the thread pool.
+    //
+    std::unordered_map<PacketTag, Endpoint> m_PacketTagResolverTable;
+
+    //
+    // Number of unreferenced receive buffers each I/O shard keeps for reuse.
+    //
+    uint32_t m_ReceiveBufferPoolSize;
+
+    //
+    // Initial size of the buffers response payloads are built in. Larger payloads, up to the
+    // maximum packet size, are moved to dedicated buffers as they grow.
+    //
+    uint32_t m_ResponseBufferSize;
+
+    //
+    // Number of unreferenced response buffers each I/O shard keeps for reuse.
     //
-    std::unordered_map<PacketTag, EndpointType> m_PacketTagResolverTable;
+    uint32_t m_ResponseBufferPoolSize;
+
+    //
+    // Maximum amount of memory, in bytes, taken for connections and buffers; zero for no limit.
+    // Past it, new connections are dropped and requests that cannot get buffers fail with OutOfMemory,
+    // rather than the host running out of memory.
+    //
+    uint64_t m_MaxMemorySize;
+
+    //
+    // Flag for reserving the whole memory limit up front on pre-faulted huge pages. Requires a memory limit.
+    // Explicit huge pages are used if the host reserved enough of them, transparent huge pages otherwise.
+    //
+    bool m_EnableHugePages;
 
     //
     // Default port.
     //
     static constexpr uint32_t c_DefaultPortNumber = 9090u;
 
+    //
+    // Default shared memory channel ring capacity.
+    //
+    static constexpr uint32_t c_DefaultSharedMemoryRingSize = 1u << 20;
+
     //
     // Default receive buffer size.
     //
@@ -94,11 +267,71 @@ struct DataTransmissionServerConfiguration
     //
     static constexpr uint16_t c_DefaultThreadPoolSize = 20u;
 
+    //
+    // Default thread pool scheduling policy.
+    //
+    static constexpr ThreadPoolScheduler c_DefaultThreadPoolScheduler = ThreadPoolScheduler::WorkStealing;
+
+    //
+    // Default priority class policy.
+    //
+    static constexpr ThreadPoolPriorityPolicy c_DefaultPriorityPolicy = ThreadPoolPriorityPolicy::WeightedFair;
+
     //
     // Default maximum number of allowed connections.
     //
     static constexpr uint16_t c_DefaultMaxNumberAllowedConnections = 10u;
 
+    //
+    // Default number of I/O shards.
+    //
+    static constexpr uint16_t c_DefaultNumberIoShards = 1u;
+
+    //
+    // Default I/O backend.
+    //
+    static constexpr IoBackend c_DefaultIoBackend = IoBackend::Epoll;
+
+    //
+    // Default io_uring queue depth.
+    //
+    static constexpr uint32_t c_DefaultIoUringQueueDepth = 256u;
+
+    //
+    // Default maximum packet size.
+    //
+    static constexpr uint32_t c_DefaultMaxPacketSize = 1u << 20;
+
+    //
+    // Default maximum number of in-flight requests per connection.
+    //
+    static constexpr uint16_t c_DefaultMaxNumberInFlightRequestsPerConnection = 32u;
+
+    //
+    // Default maximum number of queued requests.
+    //
+    static constexpr uint32_t c_DefaultMaxNumberQueuedRequests = 1024u;
+
+    //
+    // Default target queueing delay; load shedding is disabled unless configured.
+    //
+    static constexpr uint32_t c_DefaultQueueDelayTargetMilliseconds = 0u;
+
+    //
+    // Default queueing delay interval.
+    //
+    static constexpr uint32_t c_DefaultQueueDelayIntervalMilliseconds = 100u;
+
+    //
+    // Default read timeout.
+    //
+    static constexpr uint32_t c_DefaultReadTimeoutMilliseconds = 10000u;
+
+    //
+    // Default idle timeout.
+    //
+    static constexpr uint32_t c_DefaultIdleTimeoutMilliseconds = 300000u;
+
     //
     // Default blocking execution model.
     //
@@ -109,6 +342,36 @@ struct DataTransmissionServerConfiguration
     //
     static constexpr bool c_DefaultCleanTermination = true;
 
+    //
+    // Default statistics collection.
+    //
+    static constexpr bool c_DefaultEnableStatistics = true;
+
+    //
+    // Default receive buffer pool size.
+    //
+    static constexpr uint32_t c_DefaultReceiveBufferPoolSize = 64u;
+
+    //
+    // Default response buffer size.
+    //
+    static constexpr uint32_t c_DefaultResponseBufferSize = 4096u;
+
+    //
+    // Default response buffer pool size.
+    //
+    static constexpr uint32_t c_DefaultResponseBufferPoolSize = 64u;
+
+    //
+    // Default memory limit.
+    //
+    static constexpr uint64_t c_DefaultMaxMemorySize = 0;
+
+    //
+    // Default huge pages flag.
+    //
+    static constexpr bool c_DefaultEnableHugePages = false;
+
 };
 
 //
@@ -153,118 +416,1242 @@ public:
     Stop();
 
     //
-    // Default server endpoint. Specifies the required signature for all endpoints.
-    // Only used for debugging purposes.
+    // Returns the number of requests rejected with ServerBusy because the request queue was full.
     //
-    static
-    StatusCode
-    DefaultEndpoint(
-        std::string p_Packet);
+    uint64_t
+    GetNumberRejectedRequests() const;
 
     //
-    // Default DTP packet tag for the default endpoint.
+    // Returns the number of requests shed with Overloaded because of a standing queueing delay.
     //
-    static constexpr PacketTag c_DefaultEndpointPacketTag = 0u;
-
-private:
+    uint64_t
+    GetNumberShedRequests() const;
 
     //
-    // Dispatches the incoming TCP requests.
-    // This can be executed on a sync or async context depending on the server configuration.
+    // Takes a snapshot of the server statistics, merged across all threads.
     //
-    void
-    DispatchRequests();
+    StatusCode
+    GetStatistics(
+        StatisticsSnapshot& p_Snapshot) const;
 
     //
-    // Dispatcher proxy. Executes the specified function and then closes the connection.
+    // Returns the event loop coroutine endpoints await socket readiness and timers on.
+    // Waits fail with ServiceIsStopped unless coroutine endpoints are registered.
     //
-    static
-    void
-    DispatcherProxy(
-        DataTransmissionServer* p_DataTransmissionServer,
-        const EndpointType p_Endpoint,
-        const FileDescriptor p_Connection,
-        std::string p_Packet);
+    AsyncEventLoop&
+    GetAsyncEventLoop();
 
     //
-    // Sends a response back to the client and closes the established connection.
+    // Default server endpoint. Specifies the required signature for all endpoints.
+    // Only used for debugging purposes.
     //
     static
-    void
-    SendResponseAndCloseConnection(
-        const StatusCode p_Status,
-        const FileDescriptor p_Connection);
+    StatusCode
+    DefaultEndpoint(
+        std::string p_Packet);
 
     //
-    // Handle for the DispatchRequests method execution.
+    // Default DTP packet tag for the default endpoint.
     //
-    std::thread m_DispatchRequestsThreadHandle;
+    static constexpr PacketTag c_DefaultEndpointPacketTag = 0u;
 
     //
-    // Determines if the server has already been initialized.
+    // Reserved DTP packet tag answered by the server itself with a serialized StatisticsSnapshot.
+    // Endpoints registered under it are never executed.
     //
-    std::atomic<bool> m_IsInitialized;
+    static constexpr PacketTag c_StatisticsPacketTag = 0xFFFFFFFFu;
 
     //
-    // Determines if the server has been stopped.
+    // Reserved DTP packet tag through which clients connected over the AF_UNIX socket set up a shared memory channel.
+    // Endpoints registered under it are never executed.
     //
-    std::atomic<bool> m_IsStopped;
+    static constexpr PacketTag c_SharedMemoryPacketTag = SharedMemoryChannel::c_SetupPacketTag;
 
-    //
-    // Service identifier for the server.
-    //
-    const std::string m_ServiceIdentifier;
+private:
 
     //
-    // Server internal socket handle.
+    // Response of a pipelined request waiting for its turn to be written back to the client.
     //
-    FileDescriptor m_ServerSocketHandle;
+    struct PendingResponse
+    {
 
-    //
-    // Holds the internal server socket address information.
-    //
-    sockaddr_in m_Address;
+        //
+        // Determines whether the request has completed and the response can be written.
+        //
+        bool m_IsReady;
 
-    //
-    // Size of the scoket address information field.
-    //
-    uint32_t m_AddressLength;
+        //
+        // Packet tag of the request.
+        //
+        PacketTag m_PacketTag;
 
-    //
-    // Internal data buffer for handling incoming TCP data flushes.
-    //
-    std::unique_ptr<Byte[]> m_ReceiveBuffer;
+        //
+        // Status returned for the request.
+        //
+        StatusCode m_Status;
 
-    //
-    // Size of the receive buffer.
-    //
-    uint32_t m_ReceiveBufferSize;
+        //
+        // Buffer holding the response payload, if any.
+        //
+        BufferReference m_Payload;
+
+        //
+        // Size of the response payload.
+        //
+        uint32_t m_PayloadSize;
+
+    };
 
     //
-    // Blocking execution model.
+    // Contiguous piece of the output of a connection: either a run of serialized response headers
+    // in the connection header buffer or a response payload in its own buffer.
     //
-    bool m_BlockingExecution;
+    struct OutputSegment
+    {
+
+        //
+        // Buffer holding the payload. Empty for segments in the connection header buffer.
+        //
+        BufferReference m_Payload;
+
+        //
+        // Offset of the segment in its buffer.
+        //
+        uint32_t m_Offset;
+
+        //
+        // Size of the segment.
+        //
+        uint32_t m_Size;
+
+    };
 
     //
-    // Clean termination model.
+    // Client connection state. Owned by the shard that accepted it; apart from the reference
+    // held by in-flight requests, it is only accessed from the shard dispatch thread.
     //
-    bool m_CleanTermination;
+    struct Connection : public std::enable_shared_from_this<Connection>
+    {
+
+        //
+        // Constructor. The connection containers draw from the specified allocator.
+        //
+        Connection(
+            const FileDescriptor p_Handle,
+            const uint16_t p_MaxNumberInFlightRequests,
+            SlabAllocator* p_SlabAllocator);
+
+        //
+        // Destructor. Closes the connection handle if still owned.
+        //
+        ~Connection();
+
+        //
+        // Returns the number of requests dispatched whose response has not been written yet.
+        //
+        inline
+        uint64_t
+        GetNumberInFlightRequests() const
+        {
+            return m_NextRequestSequence - m_NextResponseSequence;
+        }
+
+        //
+        // Connection socket handle, or doorbell handle for shared memory channels. Negative once the connection has been released.
+        //
+        FileDescriptor m_Handle;
+
+        //
+        // Shared memory channel the connection exchanges frames through instead of its handle. Null for sockets.
+        //
+        std::unique_ptr<SharedMemoryChannel> m_Channel;
+
+        //
+        // Connection released along with this one: the shared memory channel set up over an AF_UNIX
+        // connection, and the AF_UNIX connection a channel was set up over.
+        //
+        std::weak_ptr<Connection> m_LinkedConnection;
+
+        //
+        // Reassembly buffer for received bytes not yet consumed as complete frames.
+        // Frames completed in it are handed to endpoints by reference, so it is replaced rather
+        // than overwritten while shared.
+        //
+        BufferReference m_PendingData;
+
+        //
+        // Number of valid bytes in the reassembly buffer.
+        //
+        uint32_t m_PendingSize;
+
+        //
+        // Reorder ring for pipelined responses, indexed by request sequence modulo its size.
+        // Its size is the in-flight request limit, so slots are never reused before being written.
+        //
+        std::vector<PendingResponse, SlabAllocatorAdapter<PendingResponse>> m_Responses;
+
+        //
+        // Sequence number assigned to the next received request.
+        //
+        uint64_t m_NextRequestSequence;
+
+        //
+        // Sequence number of the next response to be written back to the client.
+        //
+        uint64_t m_NextResponseSequence;
+
+        //
+        // Serialized response headers not yet accepted by the socket.
+        //
+        std::vector<Byte, SlabAllocatorAdapter<Byte>> m_OutputHeaders;
+
+        //
+        // Output not yet accepted by the socket, in wire order. Headers and payloads are written
+        // together with scatter-gather I/O rather than being copied into a single buffer.
+        //
+        std::vector<OutputSegment, SlabAllocatorAdapter<OutputSegment>> m_OutputSegments;
+
+        //
+        // Index of the first output segment not completely sent.
+        //
+        size_t m_OutputSegmentIndex;
+
+        //
+        // Number of bytes of the first unsent output segment already sent.
+        //
+        uint32_t m_OutputOffset;
+
+        //
+        // I/O vector describing the unsent output, rebuilt before every send.
+        //
+        std::vector<iovec, SlabAllocatorAdapter<iovec>> m_OutputVector;
+
+        //
+        // Message referencing the I/O vector. Kept with the connection since io_uring reads it
+        // asynchronously.
+        //
+        msghdr m_OutputMessage;
+
+        //
+        // Set while reading is paused due to the in-flight limit or a full socket send buffer.
+        //
+        bool m_IsReadSuspended;
+
+        //
+        // Set once no more requests are accepted (peer shutdown or unrecoverable stream).
+        // The connection is released as soon as all its responses have been written.
+        //
+        bool m_IsReadShutdown;
+
+        //
+        // Set while the socket send buffer is full.
+        //
+        bool m_IsWriteBlocked;
+
+        //
+        // Set while the connection is queued for writing at the end of the event loop iteration.
+        //
+        bool m_IsWriteScheduled;
+
+        //
+        // Set while a receive, or the doorbell poll of a channel, is queued on the io_uring instance of the shard.
+        //
+        bool m_IsReceiveArmed;
+
+        //
+        // Set if the connection was accepted on the AF_UNIX socket, which allows it to set up a shared memory channel.
+        //
+        bool m_IsUnixDomain;
+
+        //
+        // Set while a send is queued on the io_uring instance of the shard. The output buffer
+        // is neither modified nor extended until it completes.
+        //
+        bool m_IsSendInFlight;
+
+        //
+        // Number of io_uring operations referencing the connection. A released connection
+        // is kept alive until all of them have completed.
+        //
+        uint32_t m_NumberPendingIoOperations;
+
+        //
+        // Timer of the read and idle timeouts, scheduled no later than the earliest of them. Traffic only
+        // records its time; the timeouts are worked out again when the timer expires.
+        //
+        TimerWheel::Timer m_Timer;
+
+        //
+        // Time bytes were last received or sent.
+        //
+        std::chrono::steady_clock::time_point m_LastActivityTime;
+
+        //
+        // Time the first bytes of the frame being reassembled were received.
+        //
+        std::chrono::steady_clock::time_point m_FrameStartTime;
+
+    };
 
     //
-    // Thread pool for handling concurrent requests.
+    // Request completed by a worker thread and handed back to the shard of its connection.
     //
-    ThreadPool m_ThreadPool;
+    struct Completion
+    {
+
+        //
+        // Connection the request was received on.
+        //
+        std::shared_ptr<Connection> m_Connection;
+
+        //
+        // Sequence number of the request in its connection.
+        //
+        uint64_t m_Sequence;
+
+        //
+        // Packet tag of the request.
+        //
+        PacketTag m_PacketTag;
+
+        //
+        // Status returned by the endpoint.
+        //
+        StatusCode m_Status;
+
+        //
+        // Time the request was dispatched, for measuring its end-to-end latency.
+        //
+        std::chrono::steady_clock::time_point m_DispatchTime;
+
+        //
+        // Buffer holding the response payload, if any.
+        //
+        BufferReference m_Payload;
+
+        //
+        // Size of the response payload.
+        //
+        uint32_t m_PayloadSize;
+
+    };
 
     //
-    // DTP packet tag to function map. Maps a tag to the appropriate function binding to be executed.
-    // Establishes the signature needed to be used by all functions using the DTP protocol <StatusCode F(DataTransmissionPacket)>.
+    // Request decoded by a shard and batched for submission to the thread pool.
     //
-    std::unordered_map<PacketTag, EndpointType> m_PacketTagResolverTable;
+    struct BatchedRequest
+    {
+
+        //
+        // Connection the request was received on. Kept alive by the batched task.
+        //
+        Connection* m_Connection;
+
+        //
+        // Sequence number of the request in its connection.
+        //
+        uint64_t m_Sequence;
+
+        //
+        // Packet tag of the request.
+        //
+        PacketTag m_PacketTag;
+
+    };
 
     //
-    // Number of requests currently in execution.
+    // I/O shard. Owns a listening socket, an event loop and a receive buffer, all of which
+    // are only accessed from the shard dispatch thread.
     //
-    std::atomic<uint64_t> m_NumberRequestsInExecution;
+    struct IoShard
+    {
+
+        //
+        // Constructor. The connection table draws from the specified allocator.
+        //
+        IoShard(
+            SlabAllocator* p_SlabAllocator);
+
+        //
+        // Destructor. Closes the shard handles if still open.
+        //
+        ~IoShard();
+
+        //
+        // Handle for the DispatchRequests method execution of this shard.
+        //
+        std::thread m_DispatchRequestsThreadHandle;
+
+        //
+        // CPUs the shard thread is pinned to. Empty leaves it unpinned.
+        //
+        std::vector<uint16_t> m_Cpus;
+
+        //
+        // Shard listening socket handle.
+        //
+        FileDescriptor m_ServerSocketHandle;
+
+        //
+        // Event file descriptor used by worker threads to wake the shard up on new completions.
+        //
+        FileDescriptor m_WakeupHandle;
+
+        //
+        // Event loop multiplexing the shard socket and all of its client connections.
+        //
+        EventLoop m_EventLoop;
+
+        //
+        // Pool of receive buffers of the shard. Declared before any buffer reference so that it outlives them.
+        //
+        BufferPool m_BufferPool;
+
+        //
+        // Pool of response payload buffers of the shard. Declared before any buffer reference so that it outlives them.
+        //
+        BufferPool m_ResponseBufferPool;
+
+        //
+        // Internal data buffer for handling incoming TCP data flushes.
+        // Frames completed in it are handed to endpoints by reference, so it is replaced rather
+        // than overwritten while shared.
+        //
+        BufferReference m_ReceiveBuffer;
+
+        //
+        // Timers of the connection timeouts. Advanced once per event loop iteration, so that timing
+        // connections costs neither a system call nor an allocation.
+        //
+        TimerWheel m_TimerWheel;
+
+        //
+        // Open client connections of the shard, indexed by their handle.
+        //
+        std::unordered_map<
+            FileDescriptor,
+            std::shared_ptr<Connection>,
+            std::hash<FileDescriptor>,
+            std::equal_to<FileDescriptor>,
+            SlabAllocatorAdapter<std::pair<const FileDescriptor, std::shared_ptr<Connection>>>> m_Connections;
+
+        //
+        // Connections released during the current event loop iteration.
+        // Kept alive until the iteration ends since pending events may still reference them.
+        //
+        std::vector<std::shared_ptr<Connection>> m_ReleasedConnections;
+
+        //
+        // Connections with responses to be written at the end of the current event loop iteration.
+        //
+        std::vector<Connection*> m_ScheduledConnections;
+
+        //
+        // Requests decoded during the current event loop iteration, submitted to the thread pool together.
+        // Its tasks hold buffer references, so it is declared after the buffer pools.
+        //
+        ThreadPoolBatch m_DispatchBatch;
+
+        //
+        // Requests of the dispatch batch, in the same order, for answering those the thread pool rejects.
+        //
+        std::vector<BatchedRequest> m_BatchedRequests;
+
+        //
+        // Exclusive lock for synchronizing access to the completion queue.
+        //
+        std::mutex m_CompletionLock;
+
+        //
+        // Requests completed by worker threads, pending to be written by the shard.
+        //
+        std::vector<Completion> m_Completions;
+
+        //
+        // Completions being processed by the shard thread. Swapped with the completion queue to reuse its storage.
+        //
+        std::vector<Completion> m_CompletionsInProcess;
+
+        //
+        // Receive buffers handed to the kernel through the io_uring provided buffer ring, indexed by buffer identifier.
+        //
+        std::vector<BufferReference> m_ProvidedBuffers;
+
+        //
+        // Set while the multishot accept is active on the io_uring instance.
+        //
+        bool m_IsAcceptArmed;
+
+        //
+        // Set while the multishot accept on the AF_UNIX socket is active on the io_uring instance.
+        //
+        bool m_IsUnixAcceptArmed;
+
+        //
+        // Set while the multishot poll on the wakeup handle is active on the io_uring instance.
+        //
+        bool m_IsWakeupArmed;
+
+        //
+        // Number of accept, receive, doorbell and send operations outstanding on the io_uring instance.
+        //
+        uint32_t m_NumberPendingIoOperations;
+
+        //
+        // Statistics recorded by the shard thread. Null if statistics are not collected.
+        //
+        ThreadStatistics* m_Statistics;
+
+        //
+        // io_uring instance of the shard. Declared last so that it is torn down before the
+        // buffers and connections its outstanding operations point into.
+        //
+        IoRing m_IoRing;
+
+    };
+
+    //
+    // Operations queued on the io_uring instance of a shard. Encoded in the low bits of the user data,
+    // next to the shard or connection they refer to.
+    //
+    enum class IoRingOperation : uint64_t
+    {
+
+        //
+        // Multishot accept on the shard listening socket.
+        //
+        Accept = 1u,
+
+        //
+        // Multishot poll on the shard wakeup handle.
+        //
+        Wakeup = 2u,
+
+        //
+        // Receive on a connection.
+        //
+        Receive = 3u,
+
+        //
+        // Send on a connection.
+        //
+        Send = 4u,
+
+        //
+        // Multishot accept on the AF_UNIX socket of the server.
+        //
+        UnixAccept = 5u,
+
+        //
+        // Multishot poll on the doorbell of a shared memory channel connection.
+        //
+        Doorbell = 6u
+
+    };
+
+    //
+    // Creates the listening socket, event loop and receive buffer of a shard.
+    //
+    StatusCode
+    InitIoShard(
+        IoShard& p_Shard,
+        const uint16_t p_MaxNumberAllowedConnections);
+
+    //
+    // Sets up the io_uring instance of a shard and fills its provided buffer ring.
+    //
+    StatusCode
+    InitIoRing(
+        IoShard& p_Shard);
+
+    //
+    // Dispatches the incoming TCP requests of a shard.
+    // This can be executed on a sync or async context depending on the server configuration.
+    //
+    void
+    DispatchRequests(
+        IoShard* p_Shard);
+
+    //
+    // Runs one epoll event loop iteration of a shard.
+    //
+    void
+    ProcessEvents(
+        IoShard& p_Shard);
+
+    //
+    // Runs one io_uring event loop iteration of a shard, re-arming its multishot operations first.
+    // Returns the number of completions processed.
+    //
+    uint32_t
+    ProcessIoRingCompletions(
+        IoShard& p_Shard);
+
+    //
+    // Registers a connection accepted through io_uring and starts receiving on it.
+    //
+    void
+    AcceptIoRingConnection(
+        IoShard& p_Shard,
+        const FileDescriptor p_Handle,
+        const bool p_IsUnixDomain);
+
+    //
+    // Queues a receive into a provided buffer for a connection, unless one is already queued.
+    // Shared memory channels get a multishot poll on their doorbell instead.
+    //
+    void
+    ArmIoRingReceive(
+        IoShard& p_Shard,
+        Connection& p_Connection);
+
+    //
+    // Handles the completion of a receive and returns its buffer to the provided buffer ring.
+    //
+    void
+    CompleteIoRingReceive(
+        IoShard& p_Shard,
+        Connection& p_Connection,
+        const int32_t p_Result,
+        const uint32_t p_Flags);
+
+    //
+    // Queues a send of the unsent part of the connection output buffer.
+    //
+    void
+    SubmitIoRingSend(
+        IoShard& p_Shard,
+        Connection& p_Connection);
+
+    //
+    // Handles the completion of a send, continuing with the rest of the output.
+    //
+    void
+    CompleteIoRingSend(
+        IoShard& p_Shard,
+        Connection& p_Connection,
+        const int32_t p_Result);
+
+    //
+    // Hands a receive buffer back to the provided buffer ring under the specified identifier.
+    //
+    void
+    ProvideIoRingBuffer(
+        IoShard& p_Shard,
+        const uint16_t p_BufferId);
+
+    //
+    // Drops the released connections no longer referenced by pending events or io_uring operations.
+    //
+    static
+    void
+    DropReleasedConnections(
+        IoShard& p_Shard);
+
+    //
+    // Accepts all pending connections on a listening socket and registers them into the shard event loop.
+    //
+    void
+    AcceptConnections(
+        IoShard& p_Shard,
+        const FileDescriptor p_ListenerHandle,
+        const bool p_IsUnixDomain);
+
+    //
+    // Creates the AF_UNIX listening socket shared by all shards.
+    //
+    StatusCode
+    InitUnixSocket(
+        const std::string& p_Path,
+        const uint16_t p_MaxNumberAllowedConnections);
+
+    //
+    // Sets up a shared memory channel for an AF_UNIX connection, registers it as a connection of its own
+    // and answers the request with its handles. Requests not eligible are answered with InvalidArgument.
+    //
+    void
+    OpenSharedMemoryChannel(
+        IoShard& p_Shard,
+        Connection& p_Connection);
+
+    //
+    // Handles a doorbell ring of a shared memory channel: continues a blocked write and reads the new requests.
+    //
+    void
+    ProcessChannelDoorbell(
+        IoShard& p_Shard,
+        Connection& p_Connection);
+
+    //
+    // Reads from the socket of a connection, or from the request ring of its channel. Follows read(), failing
+    // with EAGAIN once drained; a drained channel asks for its doorbell to be rung on the next write.
+    //
+    static
+    ssize_t
+    ReceiveInput(
+        Connection& p_Connection,
+        Byte* p_Data,
+        const uint32_t p_Size);
+
+    //
+    // Sends the prepared output vector of a connection to its socket, or to the response ring of its channel.
+    // Follows sendmsg(), failing with EAGAIN once full; a full channel asks for its doorbell to be rung on the next read.
+    //
+    static
+    ssize_t
+    SendOutputVector(
+        Connection& p_Connection);
+
+    //
+    // Drains the readable data of a connection, reassembling DTP frames split across reads.
+    // Reading is suspended while the connection is at its in-flight request limit.
+    //
+    void
+    ReadConnection(
+        IoShard& p_Shard,
+        Connection& p_Connection);
+
+    //
+    // Consumes data received into a buffer: appends it to the partial frame of the connection, if any,
+    // or otherwise dispatches its complete frames in place and keeps the trailing bytes.
+    // Returns false if the connection no longer accepts requests.
+    //
+    bool
+    ConsumeReceivedData(
+        IoShard& p_Shard,
+        Connection& p_Connection,
+        const BufferReference& p_Buffer,
+        const uint32_t p_Size);
+
+    //
+    // Decodes and dispatches the complete frames contained in the data, stopping at the first
+    // incomplete frame or when the in-flight request limit is reached.
+    // Returns false if the connection no longer accepts requests.
+    //
+    bool
+    ConsumeFrames(
+        IoShard& p_Shard,
+        Connection& p_Connection,
+        const BufferReference& p_Buffer,
+        const Byte* p_Data,
+        const uint32_t p_Size,
+        uint32_t& p_NumberBytesConsumed);
+
+    //
+    // Returns the number of bytes required in the reassembly buffer to hold its first frame.
+    //
+    uint32_t
+    GetPendingFrameSize(
+        const Connection& p_Connection) const;
+
+    //
+    // Makes the connection reassembly buffer exclusive and able to hold at least the specified
+    // number of bytes, preserving its pending data.
+    // Returns false if the connection was released.
+    //
+    bool
+    ReservePendingData(
+        IoShard& p_Shard,
+        Connection& p_Connection,
+        const uint32_t p_Size);
+
+    //
+    // Moves the pending data found at the offset to the start of an exclusive reassembly buffer.
+    // Returns false if the connection was released.
+    //
+    bool
+    CompactPendingData(
+        IoShard& p_Shard,
+        Connection& p_Connection,
+        const uint32_t p_Offset);
+
+    //
+    // Resolves the endpoint for a packet and adds it to the dispatch batch of the shard, or executes it right away for inline endpoints.
+    // The request is dropped with DeadlineExceeded instead of being executed once the deadline has passed.
+    //
+    void
+    DispatchPacket(
+        IoShard& p_Shard,
+        Connection& p_Connection,
+        const PacketTag p_PacketTag,
+        const std::chrono::steady_clock::time_point p_Deadline,
+        const BufferReference& p_Buffer,
+        const std::string_view p_Packet);
+
+    //
+    // Executes an inline endpoint on the shard thread and completes the request right away.
+    //
+    void
+    ExecuteInline(
+        IoShard& p_Shard,
+        Connection& p_Connection,
+        const uint64_t p_Sequence,
+        const DispatchTable::Entry& p_Entry,
+        const std::chrono::steady_clock::time_point p_Deadline,
+        const std::string_view p_Packet);
+
+    //
+    // Adds to a counter of the shard statistics, if statistics are collected.
+    //
+    static
+    void
+    AddShardCounter(
+        IoShard& p_Shard,
+        std::atomic<uint64_t> ThreadStatistics::* p_Counter,
+        const uint64_t p_Value);
+
+    //
+    // Answers a statistics request with a snapshot of the server statistics.
+    //
+    void
+    ServeStatistics(
+        IoShard& p_Shard,
+        Connection& p_Connection,
+        const uint64_t p_Sequence);
+
+    //
+    // Stores the response of a request and schedules the connection for writing.
+    //
+    void
+    CompleteRequest(
+        IoShard& p_Shard,
+        Connection& p_Connection,
+        const uint64_t p_Sequence,
+        const PacketTag p_PacketTag,
+        const StatusCode p_Status,
+        BufferReference&& p_Payload = BufferReference(),
+        const uint32_t p_PayloadSize = 0u);
+
+    //
+    // Answers with a failure status after all previous responses and stops accepting requests on the connection.
+    //
+    void
+    FailConnection(
+        IoShard& p_Shard,
+        Connection& p_Connection,
+        const PacketTag p_PacketTag,
+        const StatusCode p_Status);
+
+    //
+    // Hands a completed request over to the shard of its connection. Called from worker threads.
+    //
+    void
+    PostCompletion(
+        IoShard& p_Shard,
+        Completion&& p_Completion);
+
+    //
+    // Processes the requests completed by worker threads.
+    //
+    void
+    ProcessCompletions(
+        IoShard& p_Shard);
+
+    //
+    // Submits the dispatch batch of the shard to the thread pool, answering right away the requests it rejects.
+    //
+    void
+    SubmitDispatchBatch(
+        IoShard& p_Shard);
+
+    //
+    // Submits the dispatch batch and writes the responses of all the scheduled connections, resuming
+    // suspended reads when possible, until neither has anything left.
+    //
+    void
+    WriteScheduledConnections(
+        IoShard& p_Shard);
+
+    //
+    // Serializes the in-order ready responses and writes the output buffer to the socket.
+    //
+    void
+    WriteConnection(
+        IoShard& p_Shard,
+        Connection& p_Connection);
+
+    //
+    // Fills the connection I/O vector with the unsent output segments.
+    //
+    static
+    void
+    PrepareOutputVector(
+        Connection& p_Connection);
+
+    //
+    // Advances the output past the specified number of sent bytes, dropping the segments sent completely.
+    //
+    static
+    void
+    AdvanceOutput(
+        Connection& p_Connection,
+        size_t p_NumberBytesSent);
+
+    //
+    // Removes a connection from the shard and closes it.
+    //
+    void
+    ReleaseConnection(
+        IoShard& p_Shard,
+        Connection& p_Connection);
+
+    //
+    // Starts timing a new connection, as idle from now on.
+    //
+    void
+    StartConnectionTimer(
+        IoShard& p_Shard,
+        Connection& p_Connection);
+
+    //
+    // Starts timing the frame being reassembled on a connection from now on.
+    //
+    void
+    StartFrameTimer(
+        IoShard& p_Shard,
+        Connection& p_Connection);
+
+    //
+    // Brings the connection timer forward to its current deadline, if any and earlier than the timer.
+    // Later deadlines are left for the timer to find when it expires, so that traffic does not move it.
+    //
+    void
+    ScheduleConnectionTimer(
+        IoShard& p_Shard,
+        Connection& p_Connection);
+
+    //
+    // Returns the time by which the connection must make progress, given the read and idle timeouts;
+    // time_point::max() if it is not timed in its current state.
+    //
+    std::chrono::steady_clock::time_point
+    GetConnectionDeadline(
+        const Connection& p_Connection) const;
+
+    //
+    // Advances the shard timer wheel to the current time, expiring the connection timers due.
+    //
+    void
+    AdvanceConnectionTimers(
+        IoShard& p_Shard);
+
+    //
+    // Handles an expired connection timer: closes the connection if its deadline passed,
+    // or schedules the timer again for a deadline that moved since.
+    //
+    void
+    ExpireConnectionTimer(
+        IoShard& p_Shard,
+        Connection& p_Connection);
+
+    //
+    // Determines whether a request dequeued by a worker must be shed, based on how long it waited
+    // in the queue. Follows the CoDel control law: a delay above the target is tolerated until it has
+    // persisted for a whole interval, which tells a standing queue apart from a short burst. Then one
+    // request is shed, and the following ones at the interval divided by the square root of the number
+    // shed so far, until a request is dequeued below the target.
+    //
+    bool
+    ShouldShedRequest(
+        const std::chrono::steady_clock::time_point p_DispatchTime,
+        const std::chrono::steady_clock::time_point p_StartTime);
+
+    //
+    // Runs a coroutine endpoint to completion and hands its response back to the connection shard.
+    // An exception thrown by the endpoint fails the request.
+    //
+    static
+    DetachedTask
+    RunCoroutineEndpoint(
+        DataTransmissionServer* p_DataTransmissionServer,
+        IoShard* p_Shard,
+        const DispatchTable::Entry* p_Entry,
+        std::shared_ptr<Connection> p_Connection,
+        const uint64_t p_Sequence,
+        const std::chrono::steady_clock::time_point p_DispatchTime,
+        const std::chrono::steady_clock::time_point p_StartTime,
+        const std::chrono::steady_clock::time_point p_Deadline,
+        [[maybe_unused]] BufferReference p_Buffer,
+        const std::string_view p_Packet);
+
+    //
+    // Hands the response of an executed request back to the connection shard.
+    //
+    void
+    FinishRequest(
+        IoShard& p_Shard,
+        const DispatchTable::Entry& p_Entry,
+        const std::shared_ptr<Connection>& p_Connection,
+        const uint64_t p_Sequence,
+        const std::chrono::steady_clock::time_point p_DispatchTime,
+        const StatusCode p_Status,
+        ResponseWriter& p_Response);
+
+    //
+    // Returns the statistics the calling thread records executions into: its own if it is a worker, or
+    // the ones reserved for the async event loop, which resumes coroutines itself when the pool rejects them.
+    // Null if statistics are not collected.
+    //
+    ThreadStatistics*
+    GetCurrentThreadStatistics();
+
+    //
+    // Records the queue wait and execution time of a request in the statistics of a thread, if statistics are collected.
+    //
+    void
+    RecordExecution(
+        const DispatchTable::Entry& p_Entry,
+        ThreadStatistics* p_ThreadStatistics,
+        const std::chrono::steady_clock::time_point p_DispatchTime,
+        const std::chrono::steady_clock::time_point p_StartTime,
+        const StatusCode p_Status);
+
+    //
+    // Executes the endpoint of the entry and records its queue wait and execution time in the
+    // statistics of the calling thread, if statistics are collected.
+    // An exception thrown by the endpoint fails the request.
+    //
+    StatusCode
+    ExecuteEndpoint(
+        const DispatchTable::Entry& p_Entry,
+        ThreadStatistics* p_ThreadStatistics,
+        const std::chrono::steady_clock::time_point p_DispatchTime,
+        const std::chrono::steady_clock::time_point p_StartTime,
+        const std::string_view p_Packet,
+        ResponseWriter& p_Response);
+
+    //
+    // Dispatcher proxy. Executes the endpoint of the entry and hands the result back to the connection shard.
+    // Requests whose deadline passed while they were queued are answered with DeadlineExceeded without being executed.
+    //
+    static
+    void
+    DispatcherProxy(
+        DataTransmissionServer* p_DataTransmissionServer,
+        IoShard* p_Shard,
+        const DispatchTable::Entry* p_Entry,
+        const std::shared_ptr<Connection>& p_Connection,
+        const uint64_t p_Sequence,
+        const std::chrono::steady_clock::time_point p_DispatchTime,
+        const std::chrono::steady_clock::time_point p_Deadline,
+        const BufferReference& p_Buffer,
+        const std::string_view p_Packet);
+
+    //
+    // Takes requests out of the count of requests in execution, waking up the shards waiting
+    // for it to drain on clean termination.
+    //
+    void
+    EndRequestsInExecution(
+        const uint64_t p_NumberRequests);
+
+    //
+    // Determines if the server has already been initialized.
+    //
+    std::atomic<bool> m_IsInitialized;
+
+    //
+    // Determines if the server has been stopped.
+    //
+    std::atomic<bool> m_IsStopped;
+
+    //
+    // Service identifier for the server.
+    //
+    const std::string m_ServiceIdentifier;
+
+    //
+    // Holds the internal server socket address information.
+    //
+    sockaddr_in m_Address;
+
+    //
+    // Size of the scoket address information field.
+    //
+    uint32_t m_AddressLength;
+
+    //
+    // AF_UNIX listening socket shared by all shards. Negative if not configured.
+    //
+    FileDescriptor m_UnixSocketHandle;
+
+    //
+    // Filesystem path of the AF_UNIX socket, removed on destruction. Empty for abstract sockets.
+    //
+    std::string m_UnixSocketPath;
+
+    //
+    // Capacity of each ring of the shared memory channels. Zero if channels are disabled.
+    //
+    uint32_t m_SharedMemoryRingSize;
+
+    //
+    // Size of the receive buffer.
+    //
+    uint32_t m_ReceiveBufferSize;
+
+    //
+    // Maximum payload size accepted for a single DTP frame.
+    //
+    uint32_t m_MaxPacketSize;
+
+    //
+    // Number of unreferenced receive buffers each I/O shard keeps for reuse.
+    //
+    uint32_t m_ReceiveBufferPoolSize;
+
+    //
+    // Initial size of the response payload buffers.
+    //
+    uint32_t m_ResponseBufferSize;
+
+    //
+    // Number of unreferenced response buffers each I/O shard keeps for reuse.
+    //
+    uint32_t m_ResponseBufferPoolSize;
+
+    //
+    // Maximum number of pipelined requests in flight per connection.
+    //
+    uint16_t m_MaxNumberInFlightRequestsPerConnection;
+
+    //
+    // I/O backend used by the shards.
+    //
+    IoBackend m_IoBackend;
+
+    //
+    // Number of submission entries and provided receive buffers of each shard io_uring instance.
+    //
+    uint32_t m_IoUringQueueDepth;
+
+    //
+    // Target queueing delay for load shedding. Zero disables load shedding.
+    //
+    std::chrono::steady_clock::duration m_QueueDelayTarget;
+
+    //
+    // Time the queueing delay must stay above its target before requests are shed.
+    //
+    std::chrono::steady_clock::duration m_QueueDelayInterval;
+
+    //
+    // Time a frame may take to arrive once started. Zero disables the read timeout.
+    //
+    std::chrono::steady_clock::duration m_ReadTimeout;
+
+    //
+    // Time a connection with no request in progress may go without traffic. Zero disables the idle timeout.
+    //
+    std::chrono::steady_clock::duration m_IdleTimeout;
+
+    //
+    // Blocking execution model.
+    //
+    bool m_BlockingExecution;
+
+    //
+    // Clean termination model.
+    //
+    bool m_CleanTermination;
+
+    //
+    // Counters and latency histograms of the worker threads followed by those of the shards and of the async event loop.
+    // Declared before the shards and the thread pool so that it outlives every thread recording into it.
+    //
+    ServerStatistics m_Statistics;
+
+    //
+    // Allocator of the connections and buffers, bounding the memory they take.
+    // Declared before the shards and the thread pool so that it outlives everything drawn from it.
+    //
+    SlabAllocator m_SlabAllocator;
+
+    //
+    // I/O shards serving the server port.
+    // Declared before the thread pool so that they outlive the tasks referencing them.
+    //
+    std::vector<std::unique_ptr<IoShard>> m_IoShards;
+
+    //
+    // DTP packet tag to endpoint table, frozen from the configured resolver table on initialization.
+    // Immutable afterwards, so endpoints can be referenced from tasks without copies. Declared before
+    // the thread pool so that it outlives the tasks left in its queue.
+    //
+    DispatchTable m_DispatchTable;
+
+    //
+    // Thread pool for handling concurrent requests.
+    //
+    ThreadPool m_ThreadPool;
+
+    //
+    // Event loop coroutine endpoints suspend on. Only started when coroutine endpoints are registered.
+    // Declared after the thread pool so that it stops, resuming its waiters on the pool, before the pool does.
+    //
+    AsyncEventLoop m_AsyncEventLoop;
+
+    //
+    // Number of requests currently in execution.
+    //
+    std::atomic<uint64_t> m_NumberRequestsInExecution;
+
+    //
+    // Exclusive lock for synchronizing access to the load shedding state.
+    //
+    std::mutex m_QueueDelayLock;
+
+    //
+    // Whether the queueing delay is above its target, so that workers dequeuing below the target
+    // only take the lock to leave that state.
+    //
+    std::atomic<bool> m_IsQueueDelayAboveTarget;
+
+    //
+    // Time from which the queueing delay has been above its target for a whole interval.
+    //
+    std::chrono::steady_clock::time_point m_QueueDelayIntervalEnd;
+
+    //
+    // Whether requests are being shed.
+    //
+    bool m_IsSheddingRequests;
+
+    //
+    // Number of requests shed since shedding started, which the spacing of the next one depends on.
+    //
+    uint32_t m_SheddingCount;
+
+    //
+    // Time at which the next request is shed.
+    //
+    std::chrono::steady_clock::time_point m_NextShedTime;
+
+    //
+    // Number of requests shed because of a standing queueing delay.
+    //
+    std::atomic<uint64_t> m_NumberShedRequests;
+
+    //
+    // Maximum time the dispatcher waits for socket events before re-checking the stop flag.
+    //
+    static constexpr int32_t c_EventLoopWaitTimeoutMilliseconds = 100;
+
+    //
+    // Mask of the io_uring user data bits holding the operation. Shards and connections are
+    // at least 8-byte aligned, which leaves these bits free.
+    //
+    static constexpr uint64_t c_IoRingOperationMask = 0x7u;
+
+    //
+    // Maximum number of entries of a shard io_uring instance, bound by the provided buffer ring limit.
+    //
+    static constexpr uint32_t c_MaxIoUringQueueDepth = 1u << 15;
+
+    //
+    // Maximum number of output segments handed to a single send.
+    //
+    static constexpr size_t c_MaxNumberOutputVectors = 64u;
 
 };
 
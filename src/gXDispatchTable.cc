@@ -0,0 +1,247 @@
+// *************************************
+// Ganymede Xpedia
+// gXDTP (Data Transmission Protocol)
+// 'gXDispatchTable.cc'
+// Author: jcjuarez
+// *************************************
+
+#include <bit>
+#include <algorithm>
+#include "gXDispatchTable.hh"
+
+namespace gX
+{
+
+DispatchTable::DispatchTable()
+    : m_BasePacketTag(0),
+      m_SlotMask(0),
+      m_BucketMask(0),
+      m_IsDirectlyIndexed(true)
+{}
+
+StatusCode
+DispatchTable::Build(
+    std::unordered_map<PacketTag, Endpoint>&& p_Endpoints)
+{
+    try
+    {
+        m_PacketTags.clear();
+        m_Endpoints.clear();
+        m_Slots.clear();
+        m_Seeds.clear();
+
+        for (const auto& [packetTag, endpoint] : p_Endpoints)
+        {
+            m_PacketTags.push_back(packetTag);
+        }
+
+        std::sort(m_PacketTags.begin(), m_PacketTags.end());
+
+        //
+        // Endpoints are stored by position in the sorted tag list; the vector is never resized
+        // afterwards, so the entries can point straight into it.
+        //
+        m_Endpoints.reserve(m_PacketTags.size());
+
+        for (const PacketTag packetTag : m_PacketTags)
+        {
+            m_Endpoints.emplace_back(std::move(p_Endpoints.at(packetTag)));
+        }
+
+        p_Endpoints.clear();
+
+        if (m_PacketTags.empty())
+        {
+            m_IsDirectlyIndexed = true;
+
+            return Status::Success;
+        }
+
+        const uint64_t tagRange = static_cast<uint64_t>(m_PacketTags.back()) - m_PacketTags.front() + 1u;
+
+        m_IsDirectlyIndexed = tagRange <= std::max<uint64_t>(c_MinDirectTableSize, c_MaxDirectTableSparsity * m_PacketTags.size());
+
+        if (m_IsDirectlyIndexed)
+        {
+            m_BasePacketTag = m_PacketTags.front();
+            m_Slots.assign(tagRange, Entry { 0u, 0u, nullptr });
+
+            for (uint32_t endpointIndex = 0; endpointIndex < m_PacketTags.size(); ++endpointIndex)
+            {
+                m_Slots[m_PacketTags[endpointIndex] - m_BasePacketTag] = Entry { m_PacketTags[endpointIndex], endpointIndex, &m_Endpoints[endpointIndex] };
+            }
+
+            return Status::Success;
+        }
+
+        //
+        // Sparse tags; start at a load factor of at most one half and grow until every bucket finds a seed.
+        //
+        uint32_t numberSlots = std::bit_ceil(static_cast<uint32_t>(m_PacketTags.size()) * 2u);
+
+        for (uint32_t growthAttempt = 0; growthAttempt < c_MaxNumberGrowthAttempts; ++growthAttempt)
+        {
+            if (BuildPerfectHash(numberSlots))
+            {
+                return Status::Success;
+            }
+
+            numberSlots *= 2u;
+        }
+    }
+    catch (const std::bad_alloc& e)
+    {
+        return Status::OutOfMemory;
+    }
+
+    return Status::Fail;
+}
+
+const DispatchTable::Entry*
+DispatchTable::Find(
+    const PacketTag p_PacketTag) const
+{
+    const Entry* entry;
+
+    if (m_IsDirectlyIndexed)
+    {
+        //
+        // Tags below the base wrap around to large offsets and fail the range check as well.
+        //
+        const PacketTag offset = p_PacketTag - m_BasePacketTag;
+
+        if (offset >= m_Slots.size())
+        {
+            return nullptr;
+        }
+
+        entry = &m_Slots[offset];
+    }
+    else
+    {
+        const uint32_t seed = m_Seeds[Hash(p_PacketTag, 0u) & m_BucketMask];
+        entry = &m_Slots[Hash(p_PacketTag, seed) & m_SlotMask];
+    }
+
+    return entry->m_Endpoint != nullptr && entry->m_PacketTag == p_PacketTag ?
+        entry :
+        nullptr;
+}
+
+const std::vector<PacketTag>&
+DispatchTable::GetPacketTags() const
+{
+    return m_PacketTags;
+}
+
+uint32_t
+DispatchTable::Hash(
+    const PacketTag p_PacketTag,
+    const uint32_t p_Seed)
+{
+    //
+    // Finalizer of MurmurHash3 over the seeded tag; a bijection, so distinct seeds displace a tag to different slots.
+    //
+    uint32_t hash = p_PacketTag ^ (p_Seed * 0x9E3779B9u);
+
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35u;
+    hash ^= hash >> 16;
+
+    return hash;
+}
+
+bool
+DispatchTable::BuildPerfectHash(
+    const uint32_t p_NumberSlots)
+{
+    //
+    // Hash and displace: tags are split into buckets, and buckets are placed from the largest to the
+    // smallest by searching a seed that moves all of their tags into free slots.
+    //
+    const uint32_t numberBuckets = std::max(1u, p_NumberSlots / 4u);
+
+    m_SlotMask = p_NumberSlots - 1u;
+    m_BucketMask = numberBuckets - 1u;
+    m_Slots.assign(p_NumberSlots, Entry { 0u, 0u, nullptr });
+    m_Seeds.assign(numberBuckets, 0u);
+
+    std::vector<std::vector<uint32_t>> buckets(numberBuckets);
+
+    for (uint32_t endpointIndex = 0; endpointIndex < m_PacketTags.size(); ++endpointIndex)
+    {
+        buckets[Hash(m_PacketTags[endpointIndex], 0u) & m_BucketMask].push_back(endpointIndex);
+    }
+
+    std::vector<uint32_t> bucketOrder(numberBuckets);
+
+    for (uint32_t bucketIndex = 0; bucketIndex < numberBuckets; ++bucketIndex)
+    {
+        bucketOrder[bucketIndex] = bucketIndex;
+    }
+
+    std::stable_sort(
+        bucketOrder.begin(),
+        bucketOrder.end(),
+        [&buckets](const uint32_t p_Left, const uint32_t p_Right)
+        {
+            return buckets[p_Left].size() > buckets[p_Right].size();
+        });
+
+    std::vector<uint32_t> candidateSlots;
+
+    for (const uint32_t bucketIndex : bucketOrder)
+    {
+        const std::vector<uint32_t>& bucket = buckets[bucketIndex];
+
+        if (bucket.empty())
+        {
+            break;
+        }
+
+        bool isPlaced = false;
+
+        for (uint32_t seed = 1u; seed <= c_MaxNumberSeedAttempts && !isPlaced; ++seed)
+        {
+            candidateSlots.clear();
+            isPlaced = true;
+
+            for (const uint32_t endpointIndex : bucket)
+            {
+                const uint32_t slotIndex = Hash(m_PacketTags[endpointIndex], seed) & m_SlotMask;
+
+                if (m_Slots[slotIndex].m_Endpoint != nullptr ||
+                    std::find(candidateSlots.begin(), candidateSlots.end(), slotIndex) != candidateSlots.end())
+                {
+                    isPlaced = false;
+
+                    break;
+                }
+
+                candidateSlots.push_back(slotIndex);
+            }
+
+            if (isPlaced)
+            {
+                m_Seeds[bucketIndex] = seed;
+
+                for (size_t tagIndex = 0; tagIndex < bucket.size(); ++tagIndex)
+                {
+                    const uint32_t endpointIndex = bucket[tagIndex];
+                    m_Slots[candidateSlots[tagIndex]] = Entry { m_PacketTags[endpointIndex], endpointIndex, &m_Endpoints[endpointIndex] };
+                }
+            }
+        }
+
+        if (!isPlaced)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace gX.
@@ -0,0 +1,162 @@
+// *************************************
+// Ganymede Xpedia
+// gXDTP (Data Transmission Protocol)
+// 'gXDispatchTable.hh'
+// Author: jcjuarez
+// *************************************
+
+#ifndef GX_DISPATCH_TABLE_
+#define GX_DISPATCH_TABLE_
+
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include "gXStatus.hh"
+#include "gXEndpoint.hh"
+#include "gXDataTransmissionProtocol.hh"
+
+namespace gX
+{
+
+//
+// Immutable packet tag to endpoint table, built once from the registered endpoints.
+// Dense tag ranges are indexed directly; sparse ones go through a perfect hash.
+// Either way a lookup is a single probe into a flat array, and the returned entries
+// stay valid for the lifetime of the table.
+//
+class DispatchTable
+{
+
+public:
+
+    //
+    // Resolved endpoint of a packet tag.
+    //
+    struct Entry
+    {
+
+        //
+        // Packet tag of the endpoint.
+        //
+        PacketTag m_PacketTag;
+
+        //
+        // Position of the endpoint in the list of packet tags sorted in ascending order.
+        //
+        uint32_t m_EndpointIndex;
+
+        //
+        // Endpoint to execute. Null for unused slots.
+        //
+        const Endpoint* m_Endpoint;
+
+    };
+
+    //
+    // Constructor.
+    //
+    DispatchTable();
+
+    //
+    // Builds the table from the registered endpoints, which it takes ownership of.
+    //
+    StatusCode
+    Build(
+        std::unordered_map<PacketTag, Endpoint>&& p_Endpoints);
+
+    //
+    // Returns the entry of a packet tag, or null if the packet tag has no endpoint.
+    //
+    const Entry*
+    Find(
+        const PacketTag p_PacketTag) const;
+
+    //
+    // Returns the packet tags of all endpoints in ascending order.
+    //
+    const std::vector<PacketTag>&
+    GetPacketTags() const;
+
+private:
+
+    //
+    // Hashes a packet tag with the specified seed.
+    //
+    static uint32_t
+    Hash(
+        const PacketTag p_PacketTag,
+        const uint32_t p_Seed);
+
+    //
+    // Lays out the perfect hash over the specified number of slots.
+    // Returns false if no seed could be found for some bucket.
+    //
+    bool
+    BuildPerfectHash(
+        const uint32_t p_NumberSlots);
+
+    //
+    // Endpoints, sorted by packet tag.
+    //
+    std::vector<Endpoint> m_Endpoints;
+
+    //
+    // Packet tags of the endpoints in ascending order.
+    //
+    std::vector<PacketTag> m_PacketTags;
+
+    //
+    // Slots of the table; the number of slots is a power of two for the perfect hash.
+    //
+    std::vector<Entry> m_Slots;
+
+    //
+    // Displacement seed of each perfect hash bucket. Empty for directly indexed tables.
+    //
+    std::vector<uint32_t> m_Seeds;
+
+    //
+    // Lowest packet tag of a directly indexed table.
+    //
+    PacketTag m_BasePacketTag;
+
+    //
+    // Index mask of the slots of the perfect hash.
+    //
+    uint32_t m_SlotMask;
+
+    //
+    // Index mask of the buckets of the perfect hash.
+    //
+    uint32_t m_BucketMask;
+
+    //
+    // Whether slots are indexed directly by packet tag.
+    //
+    bool m_IsDirectlyIndexed;
+
+    //
+    // Minimum number of slots of a directly indexed table, regardless of how sparse it is.
+    //
+    static constexpr uint32_t c_MinDirectTableSize = 256u;
+
+    //
+    // Maximum ratio of slots to endpoints for directly indexed tables.
+    //
+    static constexpr uint32_t c_MaxDirectTableSparsity = 4u;
+
+    //
+    // Number of seeds tried for a bucket before the perfect hash is retried with more slots.
+    //
+    static constexpr uint32_t c_MaxNumberSeedAttempts = 1u << 16;
+
+    //
+    // Number of times the number of slots of the perfect hash is doubled before giving up.
+    //
+    static constexpr uint32_t c_MaxNumberGrowthAttempts = 4u;
+
+};
+
+} // namespace gX.
+
+#endif
@@ -0,0 +1,211 @@
+// *************************************
+// Ganymede Xpedia
+// gXDTP (Data Transmission Protocol)
+// 'gXEndpoint.cc'
+// Author: jcjuarez
+// *************************************
+
+#include <cstring>
+#include <algorithm>
+#include "gXEndpoint.hh"
+
+namespace gX
+{
+
+ResponseWriter::ResponseWriter(
+    BufferPool* p_BufferPool,
+    const uint32_t p_MaxSize)
+    : m_BufferPool(p_BufferPool),
+      m_Size(0),
+      m_MaxSize(p_MaxSize),
+      m_Deadline(std::chrono::steady_clock::time_point::max())
+{}
+
+StatusCode
+ResponseWriter::Append(
+    const std::string_view p_Data)
+{
+    if (p_Data.size() > m_MaxSize - m_Size)
+    {
+        return Status::PacketTooLarge;
+    }
+
+    Byte* destination = Extend(static_cast<uint32_t>(p_Data.size()));
+
+    if (destination == nullptr)
+    {
+        return Status::OutOfMemory;
+    }
+
+    std::memcpy(destination, p_Data.data(), p_Data.size());
+
+    return Status::Success;
+}
+
+Byte*
+ResponseWriter::Extend(
+    const uint32_t p_Size)
+{
+    if (p_Size > m_MaxSize - m_Size)
+    {
+        return nullptr;
+    }
+
+    const uint32_t size = m_Size + p_Size;
+
+    if (!m_Buffer ||
+        size > m_Buffer.GetCapacity())
+    {
+        //
+        // Grow geometrically; the pool serves sizes beyond its buffer size with dedicated buffers.
+        //
+        const uint32_t capacity = m_Buffer ?
+            static_cast<uint32_t>(std::clamp<uint64_t>(2u * static_cast<uint64_t>(m_Buffer.GetCapacity()), size, m_MaxSize)) :
+            std::max(size, m_BufferPool->GetBufferSize());
+
+        BufferReference buffer = m_BufferPool->Acquire(capacity);
+
+        if (!buffer)
+        {
+            return nullptr;
+        }
+
+        if (m_Size != 0)
+        {
+            std::memcpy(buffer.GetData(), m_Buffer.GetData(), m_Size);
+        }
+
+        m_Buffer = std::move(buffer);
+    }
+
+    Byte* destination = m_Buffer.GetData() + m_Size;
+    m_Size = size;
+
+    return destination;
+}
+
+const Byte*
+ResponseWriter::GetData() const
+{
+    return m_Buffer ? m_Buffer.GetData() : nullptr;
+}
+
+uint32_t
+ResponseWriter::GetSize() const
+{
+    return m_Size;
+}
+
+BufferReference
+ResponseWriter::TakeBuffer()
+{
+    m_Size = 0;
+
+    return std::move(m_Buffer);
+}
+
+void
+ResponseWriter::SetDeadline(
+    const std::chrono::steady_clock::time_point p_Deadline)
+{
+    m_Deadline = p_Deadline;
+}
+
+std::chrono::steady_clock::time_point
+ResponseWriter::GetDeadline() const
+{
+    return m_Deadline;
+}
+
+std::chrono::steady_clock::duration
+ResponseWriter::GetRemainingTime() const
+{
+    if (m_Deadline == std::chrono::steady_clock::time_point::max())
+    {
+        return std::chrono::steady_clock::duration::max();
+    }
+
+    return std::max(m_Deadline - std::chrono::steady_clock::now(), std::chrono::steady_clock::duration::zero());
+}
+
+Endpoint::Endpoint()
+    : m_Invoker(nullptr),
+      m_CoroutineInvoker(nullptr),
+      m_ExecutionMode(EndpointExecutionMode::Pooled),
+      m_PriorityClass(0)
+{}
+
+Endpoint&
+Endpoint::SetExecutionMode(
+    const EndpointExecutionMode p_ExecutionMode)
+{
+    m_ExecutionMode = p_ExecutionMode;
+
+    return *this;
+}
+
+EndpointExecutionMode
+Endpoint::GetExecutionMode() const
+{
+    return m_ExecutionMode;
+}
+
+Endpoint&
+Endpoint::SetPriorityClass(
+    const uint8_t p_PriorityClass)
+{
+    m_PriorityClass = p_PriorityClass;
+
+    return *this;
+}
+
+uint8_t
+Endpoint::GetPriorityClass() const
+{
+    return m_PriorityClass;
+}
+
+bool
+Endpoint::IsCoroutine() const
+{
+    return m_CoroutineInvoker != nullptr ||
+        static_cast<bool>(m_CoroutineEndpoint);
+}
+
+Task<StatusCode>
+Endpoint::ExecuteAsync(
+    const std::string_view p_Packet,
+    ResponseWriter& p_Response) const
+{
+    if (m_CoroutineInvoker != nullptr)
+    {
+        return m_CoroutineInvoker(p_Packet, p_Response);
+    }
+
+    return m_CoroutineEndpoint(p_Packet, p_Response);
+}
+
+StatusCode
+Endpoint::Execute(
+    const std::string_view p_Packet,
+    ResponseWriter& p_Response) const
+{
+    if (m_Invoker != nullptr)
+    {
+        return m_Invoker(p_Packet, p_Response);
+    }
+
+    if (m_ResponseEndpoint)
+    {
+        return m_ResponseEndpoint(p_Packet, p_Response);
+    }
+
+    if (m_ViewEndpoint)
+    {
+        return m_ViewEndpoint(p_Packet);
+    }
+
+    return m_Endpoint(std::string(p_Packet));
+}
+
+} // namespace gX.
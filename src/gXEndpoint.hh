@@ -0,0 +1,407 @@
+// *************************************
+// Ganymede Xpedia
+// gXDTP (Data Transmission Protocol)
+// 'gXEndpoint.hh'
+// Author: jcjuarez
+// *************************************
+
+#ifndef GX_ENDPOINT_
+#define GX_ENDPOINT_
+
+#include <chrono>
+#include <string>
+#include <functional>
+#include <type_traits>
+#include <string_view>
+#include "gXTask.hh"
+#include "gXStatus.hh"
+#include "gXBufferPool.hh"
+
+namespace gX
+{
+
+//
+// Required signature for all server endpoints receiving their own copy of the packet.
+//
+using EndpointType = std::function<StatusCode(std::string)>;
+
+//
+// Signature for zero-copy server endpoints. The view points straight into the pooled receive
+// buffer and is only valid until the endpoint returns.
+//
+using ViewEndpointType = std::function<StatusCode(std::string_view)>;
+
+//
+// Response payload filled by an endpoint. The payload is built in a buffer taken from a pool
+// and written to the socket right after the response header, without being copied again.
+// The writer also carries the deadline of the request, so that long-running endpoints can stop early.
+//
+class ResponseWriter
+{
+
+public:
+
+    //
+    // Constructor. Buffers are taken from the specified pool; the payload can grow up to the maximum size.
+    //
+    ResponseWriter(
+        BufferPool* p_BufferPool,
+        const uint32_t p_MaxSize);
+
+    //
+    // Appends data to the payload.
+    //
+    StatusCode
+    Append(
+        const std::string_view p_Data);
+
+    //
+    // Extends the payload by the specified number of bytes and returns where they start,
+    // so that endpoints can serialize straight into the buffer.
+    // Returns null if the payload would exceed its maximum size or memory could not be allocated.
+    // The returned memory is only valid until the payload is extended again.
+    //
+    Byte*
+    Extend(
+        const uint32_t p_Size);
+
+    //
+    // Returns the start of the payload.
+    //
+    const Byte*
+    GetData() const;
+
+    //
+    // Returns the size of the payload.
+    //
+    uint32_t
+    GetSize() const;
+
+    //
+    // Takes the payload buffer, leaving the writer empty.
+    //
+    BufferReference
+    TakeBuffer();
+
+    //
+    // Sets the deadline of the request being answered.
+    //
+    void
+    SetDeadline(
+        const std::chrono::steady_clock::time_point p_Deadline);
+
+    //
+    // Returns the deadline of the request being answered; the maximum time point if the client set none.
+    //
+    std::chrono::steady_clock::time_point
+    GetDeadline() const;
+
+    //
+    // Returns the time left until the deadline of the request: zero once it has passed, and the maximum
+    // duration if the client set none. Endpoints can check it between steps of long work and give up with DeadlineExceeded,
+    // since the client no longer waits for the response by then.
+    //
+    std::chrono::steady_clock::duration
+    GetRemainingTime() const;
+
+private:
+
+    //
+    // Pool the payload buffers are taken from.
+    //
+    BufferPool* m_BufferPool;
+
+    //
+    // Buffer holding the payload. Acquired on the first write.
+    //
+    BufferReference m_Buffer;
+
+    //
+    // Size of the payload.
+    //
+    uint32_t m_Size;
+
+    //
+    // Maximum size of the payload.
+    //
+    uint32_t m_MaxSize;
+
+    //
+    // Deadline of the request being answered.
+    //
+    std::chrono::steady_clock::time_point m_Deadline;
+
+};
+
+//
+// Signature for server endpoints returning a response payload. The request view points straight
+// into the pooled receive buffer and is only valid until the endpoint returns.
+//
+using ResponseEndpointType = std::function<StatusCode(std::string_view, ResponseWriter&)>;
+
+//
+// Signature for coroutine server endpoints. They can suspend on the server AsyncEventLoop without holding
+// a worker, and are resumed on the thread pool. The request view and the response stay valid until the
+// coroutine finishes.
+//
+using CoroutineEndpointType = std::function<Task<StatusCode>(std::string_view, ResponseWriter&)>;
+
+//
+// Where the server executes an endpoint.
+//
+enum class EndpointExecutionMode : uint8_t
+{
+
+    //
+    // On the server thread pool. Suited for blocking or expensive endpoints.
+    //
+    Pooled,
+
+    //
+    // Directly on the I/O thread that decoded the packet, skipping the thread pool hand-off.
+    // Only for cheap endpoints that never block, since the thread serves all connections of its shard.
+    // An exception thrown by the endpoint fails its request only, as in the pooled mode.
+    //
+    Inline
+
+};
+
+//
+// Server endpoint binding. Holds any of the supported endpoint signatures.
+//
+class Endpoint
+{
+
+public:
+
+    //
+    // Constructor. Creates an empty endpoint.
+    //
+    Endpoint();
+
+    //
+    // Constructor for endpoints receiving their own copy of the packet. Callables that also accept a
+    // std::string_view are taken as zero-copy endpoints instead, since a copy would be made for nothing.
+    //
+    template<typename Function>
+        requires std::is_invocable_r_v<StatusCode, Function, std::string> &&
+            (!std::is_invocable_r_v<StatusCode, Function, std::string_view>)
+    Endpoint(
+        Function p_Endpoint)
+        : m_Invoker(nullptr),
+          m_CoroutineInvoker(nullptr),
+          m_ExecutionMode(EndpointExecutionMode::Pooled),
+          m_PriorityClass(0),
+          m_Endpoint(std::move(p_Endpoint))
+    {}
+
+    //
+    // Constructor for zero-copy endpoints.
+    //
+    template<typename Function>
+        requires std::is_invocable_r_v<StatusCode, Function, std::string_view>
+    Endpoint(
+        Function p_Endpoint)
+        : m_Invoker(nullptr),
+          m_CoroutineInvoker(nullptr),
+          m_ExecutionMode(EndpointExecutionMode::Pooled),
+          m_PriorityClass(0),
+          m_ViewEndpoint(std::move(p_Endpoint))
+    {}
+
+    //
+    // Constructor for endpoints returning a response payload.
+    //
+    template<typename Function>
+        requires std::is_invocable_r_v<StatusCode, Function, std::string_view, ResponseWriter&>
+    Endpoint(
+        Function p_Endpoint)
+        : m_Invoker(nullptr),
+          m_CoroutineInvoker(nullptr),
+          m_ExecutionMode(EndpointExecutionMode::Pooled),
+          m_PriorityClass(0),
+          m_ResponseEndpoint(std::move(p_Endpoint))
+    {}
+
+    //
+    // Constructor for coroutine endpoints.
+    //
+    template<typename Function>
+        requires std::is_invocable_r_v<Task<StatusCode>, Function, std::string_view, ResponseWriter&>
+    Endpoint(
+        Function p_Endpoint)
+        : m_Invoker(nullptr),
+          m_CoroutineInvoker(nullptr),
+          m_ExecutionMode(EndpointExecutionMode::Pooled),
+          m_PriorityClass(0),
+          m_CoroutineEndpoint(std::move(p_Endpoint))
+    {}
+
+    //
+    // Creates an endpoint that calls the specified function (or captureless lambda) directly,
+    // without the std::function type erasure. Any of the supported signatures can be bound.
+    //
+    template<auto Function>
+    static Endpoint
+    Bind(
+        const EndpointExecutionMode p_ExecutionMode = EndpointExecutionMode::Pooled)
+    {
+        Endpoint endpoint;
+        endpoint.m_ExecutionMode = p_ExecutionMode;
+
+        if constexpr (std::is_invocable_r_v<Task<StatusCode>, decltype(Function), std::string_view, ResponseWriter&>)
+        {
+            endpoint.m_CoroutineInvoker = &Endpoint::InvokeCoroutine<Function>;
+        }
+        else
+        {
+            endpoint.m_Invoker = &Endpoint::Invoke<Function>;
+        }
+
+        return endpoint;
+    }
+
+    //
+    // Sets where the endpoint is executed. Endpoints run on the thread pool unless specified otherwise.
+    //
+    Endpoint&
+    SetExecutionMode(
+        const EndpointExecutionMode p_ExecutionMode);
+
+    //
+    // Returns where the endpoint is executed.
+    //
+    EndpointExecutionMode
+    GetExecutionMode() const;
+
+    //
+    // Sets the thread pool priority class the endpoint is queued in. Endpoints use class zero unless
+    // specified otherwise. Ignored for inline endpoints.
+    //
+    Endpoint&
+    SetPriorityClass(
+        const uint8_t p_PriorityClass);
+
+    //
+    // Returns the thread pool priority class the endpoint is queued in.
+    //
+    uint8_t
+    GetPriorityClass() const;
+
+    //
+    // Determines whether the endpoint is a coroutine, to be executed through ExecuteAsync.
+    //
+    bool
+    IsCoroutine() const;
+
+    //
+    // Starts a coroutine endpoint over the packet.
+    //
+    Task<StatusCode>
+    ExecuteAsync(
+        const std::string_view p_Packet,
+        ResponseWriter& p_Response) const;
+
+    //
+    // Executes the endpoint over the packet. The packet is only copied for copying endpoints.
+    // Only endpoints returning a response payload write into the response.
+    //
+    StatusCode
+    Execute(
+        const std::string_view p_Packet,
+        ResponseWriter& p_Response) const;
+
+private:
+
+    //
+    // Signature of the functions invoking endpoints bound at compile time.
+    //
+    using InvokerType = StatusCode (*)(std::string_view, ResponseWriter&);
+
+    //
+    // Invokes an endpoint bound at compile time with the arguments its signature takes.
+    //
+    template<auto Function>
+    static StatusCode
+    Invoke(
+        const std::string_view p_Packet,
+        ResponseWriter& p_Response)
+    {
+        if constexpr (std::is_invocable_r_v<StatusCode, decltype(Function), std::string_view, ResponseWriter&>)
+        {
+            return std::invoke(Function, p_Packet, p_Response);
+        }
+        else if constexpr (std::is_invocable_r_v<StatusCode, decltype(Function), std::string_view>)
+        {
+            return std::invoke(Function, p_Packet);
+        }
+        else
+        {
+            static_assert(std::is_invocable_r_v<StatusCode, decltype(Function), std::string>, "Unsupported endpoint signature.");
+
+            return std::invoke(Function, std::string(p_Packet));
+        }
+    }
+
+    //
+    // Signature of the functions invoking coroutine endpoints bound at compile time.
+    //
+    using CoroutineInvokerType = Task<StatusCode> (*)(std::string_view, ResponseWriter&);
+
+    //
+    // Invokes a coroutine endpoint bound at compile time.
+    //
+    template<auto Function>
+    static Task<StatusCode>
+    InvokeCoroutine(
+        const std::string_view p_Packet,
+        ResponseWriter& p_Response)
+    {
+        return std::invoke(Function, p_Packet, p_Response);
+    }
+
+    //
+    // Endpoint bound at compile time, if any.
+    //
+    InvokerType m_Invoker;
+
+    //
+    // Coroutine endpoint bound at compile time, if any.
+    //
+    CoroutineInvokerType m_CoroutineInvoker;
+
+    //
+    // Where the endpoint is executed.
+    //
+    EndpointExecutionMode m_ExecutionMode;
+
+    //
+    // Thread pool priority class of the endpoint.
+    //
+    uint8_t m_PriorityClass;
+
+    //
+    // Endpoint receiving its own copy of the packet.
+    //
+    EndpointType m_Endpoint;
+
+    //
+    // Zero-copy endpoint.
+    //
+    ViewEndpointType m_ViewEndpoint;
+
+    //
+    // Endpoint returning a response payload.
+    //
+    ResponseEndpointType m_ResponseEndpoint;
+
+    //
+    // Coroutine endpoint.
+    //
+    CoroutineEndpointType m_CoroutineEndpoint;
+
+};
+
+} // namespace gX.
+
+#endif
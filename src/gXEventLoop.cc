@@ -0,0 +1,102 @@
+// *************************************
+// Ganymede Xpedia
+// Common
+// 'gXEventLoop.cc'
+// Author: jcjuarez
+// *************************************
+
+#include <cerrno>
+#include <unistd.h>
+#include "gXEventLoop.hh"
+
+namespace gX
+{
+
+EventLoop::EventLoop()
+    : m_EventLoopHandle(-1)
+{}
+
+EventLoop::~EventLoop()
+{
+    if (m_EventLoopHandle >= 0)
+    {
+        close(m_EventLoopHandle);
+    }
+}
+
+StatusCode
+EventLoop::Init()
+{
+    if (m_EventLoopHandle >= 0)
+    {
+        return Status::AlreadyInitialized;
+    }
+
+    if ((m_EventLoopHandle = epoll_create1(EPOLL_CLOEXEC)) < 0)
+    {
+        return Status::EventLoopCreationFailed;
+    }
+
+    return Status::Success;
+}
+
+StatusCode
+EventLoop::Register(
+    const FileDescriptor p_Handle,
+    const uint32_t p_Events,
+    void* p_Context)
+{
+    epoll_event event {};
+    event.events = p_Events;
+    event.data.ptr = p_Context;
+
+    if (epoll_ctl(m_EventLoopHandle, EPOLL_CTL_ADD, p_Handle, &event) < 0)
+    {
+        return Status::EventLoopRegistrationFailed;
+    }
+
+    return Status::Success;
+}
+
+void
+EventLoop::Unregister(
+    const FileDescriptor p_Handle)
+{
+    //
+    // Failure here means the descriptor was not registered; nothing else to do.
+    //
+    epoll_ctl(m_EventLoopHandle, EPOLL_CTL_DEL, p_Handle, nullptr);
+}
+
+int32_t
+EventLoop::Wait(
+    const int32_t p_TimeoutMilliseconds)
+{
+    const int32_t numberEvents = epoll_wait(m_EventLoopHandle, m_Events.data(), c_MaxNumberEventsPerWait, p_TimeoutMilliseconds);
+
+    if (numberEvents < 0)
+    {
+        //
+        // Interrupted waits are treated as a wait with no ready events.
+        //
+        return 0;
+    }
+
+    return numberEvents;
+}
+
+void*
+EventLoop::GetEventContext(
+    const int32_t p_EventIndex) const
+{
+    return m_Events[p_EventIndex].data.ptr;
+}
+
+uint32_t
+EventLoop::GetEventFlags(
+    const int32_t p_EventIndex) const
+{
+    return m_Events[p_EventIndex].events;
+}
+
+} // namespace gX.
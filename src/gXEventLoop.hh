@@ -0,0 +1,103 @@
+// *************************************
+// Ganymede Xpedia
+// Common
+// 'gXEventLoop.hh'
+// Author: jcjuarez
+// *************************************
+
+#ifndef GX_EVENT_LOOP_
+#define GX_EVENT_LOOP_
+
+#include <array>
+#include <cstdint>
+#include "gXStatus.hh"
+#include <sys/epoll.h>
+
+namespace gX
+{
+
+//
+// Edge-triggered epoll reactor for multiplexing non-blocking file descriptors on a single thread.
+//
+class EventLoop
+{
+
+public:
+
+    //
+    // Constructor.
+    //
+    EventLoop();
+
+    //
+    // Destructor. Releases the underlying epoll instance.
+    //
+    ~EventLoop();
+
+    //
+    // Initializes the event loop.
+    //
+    StatusCode
+    Init();
+
+    //
+    // Registers a file descriptor for the specified event mask.
+    // The context is handed back on every ready event of the file descriptor.
+    //
+    StatusCode
+    Register(
+        const FileDescriptor p_Handle,
+        const uint32_t p_Events,
+        void* p_Context);
+
+    //
+    // Removes a file descriptor from the event loop.
+    //
+    void
+    Unregister(
+        const FileDescriptor p_Handle);
+
+    //
+    // Waits for ready file descriptors up to the specified timeout.
+    // Returns the number of ready events, which can be accessed through GetEvent* methods.
+    //
+    int32_t
+    Wait(
+        const int32_t p_TimeoutMilliseconds);
+
+    //
+    // Returns the context associated with a ready event.
+    //
+    void*
+    GetEventContext(
+        const int32_t p_EventIndex) const;
+
+    //
+    // Returns the event mask associated with a ready event.
+    //
+    uint32_t
+    GetEventFlags(
+        const int32_t p_EventIndex) const;
+
+    //
+    // Maximum number of events retrieved per wait.
+    //
+    static constexpr uint32_t c_MaxNumberEventsPerWait = 256u;
+
+private:
+
+    //
+    // Handle for the underlying epoll instance.
+    //
+    FileDescriptor m_EventLoopHandle;
+
+    //
+    // Ready events retrieved by the last wait.
+    //
+    std::array<epoll_event, c_MaxNumberEventsPerWait> m_Events;
+
+};
+
+} // namespace gX.
+
+#endif
@@ -0,0 +1,198 @@
+// *************************************
+// Ganymede Xpedia
+// Common
+// 'gXInlineTask.hh'
+// Author: jcjuarez
+// *************************************
+
+#ifndef GX_INLINE_TASK_
+#define GX_INLINE_TASK_
+
+#include <new>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+#include "gXStatus.hh"
+
+namespace gX
+{
+
+//
+// Move-only type-erased callable stored inline in a fixed-size buffer.
+// Unlike std::function it never allocates; callables that do not fit are rejected at compile time.
+//
+class InlineTask
+{
+
+public:
+
+    //
+    // Size of the inline storage for the callable.
+    //
+    static constexpr size_t c_Capacity = 128u;
+
+    //
+    // Constructor. Creates an empty task.
+    //
+    InlineTask()
+        : m_Invoke(nullptr),
+          m_Relocate(nullptr),
+          m_Destroy(nullptr)
+    {}
+
+    //
+    // Constructor. Stores the callable inline.
+    //
+    template<typename Function,
+        typename = std::enable_if_t<!std::is_same_v<std::decay_t<Function>, InlineTask>>>
+    InlineTask(
+        Function&& p_Function)
+    {
+        using CallableType = std::decay_t<Function>;
+
+        static_assert(sizeof(CallableType) <= c_Capacity, "Callable does not fit in the inline task storage.");
+        static_assert(alignof(CallableType) <= alignof(std::max_align_t), "Callable alignment is not supported by the inline task storage.");
+        static_assert(std::is_nothrow_move_constructible_v<CallableType>, "Callable must be nothrow move constructible.");
+
+        new (m_Storage) CallableType(std::forward<Function>(p_Function));
+
+        m_Invoke = [](void* p_Storage)
+        {
+            (*static_cast<CallableType*>(p_Storage))();
+        };
+
+        m_Relocate = [](void* p_Destination, void* p_Source)
+        {
+            CallableType* source = static_cast<CallableType*>(p_Source);
+            new (p_Destination) CallableType(std::move(*source));
+            source->~CallableType();
+        };
+
+        m_Destroy = [](void* p_Storage)
+        {
+            static_cast<CallableType*>(p_Storage)->~CallableType();
+        };
+    }
+
+    //
+    // Move constructor.
+    //
+    InlineTask(
+        InlineTask&& p_Other) noexcept
+        : m_Invoke(nullptr),
+          m_Relocate(nullptr),
+          m_Destroy(nullptr)
+    {
+        MoveFrom(p_Other);
+    }
+
+    //
+    // Move assignment operator.
+    //
+    InlineTask&
+    operator=(
+        InlineTask&& p_Other) noexcept
+    {
+        if (this != &p_Other)
+        {
+            Reset();
+            MoveFrom(p_Other);
+        }
+
+        return *this;
+    }
+
+    InlineTask(
+        const InlineTask&) = delete;
+
+    InlineTask&
+    operator=(
+        const InlineTask&) = delete;
+
+    //
+    // Destructor.
+    //
+    ~InlineTask()
+    {
+        Reset();
+    }
+
+    //
+    // Determines whether the task holds a callable.
+    //
+    explicit
+    operator bool() const
+    {
+        return m_Invoke != nullptr;
+    }
+
+    //
+    // Executes the callable.
+    //
+    void
+    operator()()
+    {
+        m_Invoke(m_Storage);
+    }
+
+private:
+
+    //
+    // Takes over the callable of another task, leaving it empty.
+    //
+    void
+    MoveFrom(
+        InlineTask& p_Other)
+    {
+        if (p_Other.m_Invoke == nullptr)
+        {
+            return;
+        }
+
+        p_Other.m_Relocate(m_Storage, p_Other.m_Storage);
+        m_Invoke = std::exchange(p_Other.m_Invoke, nullptr);
+        m_Relocate = std::exchange(p_Other.m_Relocate, nullptr);
+        m_Destroy = std::exchange(p_Other.m_Destroy, nullptr);
+    }
+
+    //
+    // Destroys the stored callable, if any.
+    //
+    void
+    Reset()
+    {
+        if (m_Destroy != nullptr)
+        {
+            m_Destroy(m_Storage);
+        }
+
+        m_Invoke = nullptr;
+        m_Relocate = nullptr;
+        m_Destroy = nullptr;
+    }
+
+    //
+    // Invokes the stored callable.
+    //
+    void (*m_Invoke)(void*);
+
+    //
+    // Move constructs the stored callable into another storage and destroys the original.
+    //
+    void (*m_Relocate)(void*, void*);
+
+    //
+    // Destroys the stored callable.
+    //
+    void (*m_Destroy)(void*);
+
+    //
+    // Inline storage for the callable.
+    //
+    alignas(std::max_align_t) Byte m_Storage[c_Capacity];
+
+};
+
+} // namespace gX.
+
+#endif
@@ -0,0 +1,453 @@
+// *************************************
+// Ganymede Xpedia
+// Common
+// 'gXIoRing.cc'
+// Author: jcjuarez
+// *************************************
+
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include "gXIoRing.hh"
+
+namespace gX
+{
+
+IoRing::IoRing()
+    : m_RingHandle(-1),
+      m_SubmissionRing(MAP_FAILED),
+      m_SubmissionRingSize(0),
+      m_CompletionRing(MAP_FAILED),
+      m_CompletionRingSize(0),
+      m_SubmissionEntries(nullptr),
+      m_NumberSubmissionEntries(0),
+      m_SubmissionHead(nullptr),
+      m_SubmissionTail(nullptr),
+      m_SubmissionMask(0),
+      m_LocalSubmissionTail(0),
+      m_CompletionHead(nullptr),
+      m_CompletionTail(nullptr),
+      m_CompletionMask(0),
+      m_CompletionEntries(nullptr),
+      m_NumberCompletions(0),
+      m_BufferRing(nullptr),
+      m_BufferRingSize(0),
+      m_BufferRingMask(0),
+      m_BufferRingTail(0)
+{}
+
+IoRing::~IoRing()
+{
+    //
+    // Closing the handle cancels the outstanding operations before the mappings go away.
+    //
+    if (m_RingHandle >= 0)
+    {
+        close(m_RingHandle);
+    }
+
+    if (m_SubmissionEntries != nullptr)
+    {
+        munmap(m_SubmissionEntries, m_NumberSubmissionEntries * sizeof(io_uring_sqe));
+    }
+
+    if (m_CompletionRing != MAP_FAILED &&
+        m_CompletionRing != m_SubmissionRing)
+    {
+        munmap(m_CompletionRing, m_CompletionRingSize);
+    }
+
+    if (m_SubmissionRing != MAP_FAILED)
+    {
+        munmap(m_SubmissionRing, m_SubmissionRingSize);
+    }
+
+    if (m_BufferRing != nullptr)
+    {
+        munmap(m_BufferRing, m_BufferRingSize);
+    }
+}
+
+StatusCode
+IoRing::Init(
+    const uint32_t p_NumberEntries)
+{
+    if (m_RingHandle >= 0)
+    {
+        return Status::AlreadyInitialized;
+    }
+
+    io_uring_params parameters {};
+
+    if ((m_RingHandle = static_cast<FileDescriptor>(syscall(__NR_io_uring_setup, p_NumberEntries, &parameters))) < 0)
+    {
+        return Status::EventLoopCreationFailed;
+    }
+
+    //
+    // Bounded waits rely on passing the timeout along with the enter call.
+    //
+    if (!(parameters.features & IORING_FEAT_EXT_ARG))
+    {
+        return Status::EventLoopCreationFailed;
+    }
+
+    m_SubmissionRingSize = parameters.sq_off.array + parameters.sq_entries * sizeof(uint32_t);
+    m_CompletionRingSize = parameters.cq_off.cqes + parameters.cq_entries * sizeof(io_uring_cqe);
+
+    if (parameters.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        //
+        // Both rings live in a single mapping.
+        //
+        m_SubmissionRingSize = std::max(m_SubmissionRingSize, m_CompletionRingSize);
+        m_CompletionRingSize = m_SubmissionRingSize;
+    }
+
+    m_SubmissionRing = mmap(nullptr, m_SubmissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingHandle, IORING_OFF_SQ_RING);
+
+    if (m_SubmissionRing == MAP_FAILED)
+    {
+        return Status::EventLoopCreationFailed;
+    }
+
+    if (parameters.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        m_CompletionRing = m_SubmissionRing;
+    }
+    else
+    {
+        m_CompletionRing = mmap(nullptr, m_CompletionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingHandle, IORING_OFF_CQ_RING);
+
+        if (m_CompletionRing == MAP_FAILED)
+        {
+            return Status::EventLoopCreationFailed;
+        }
+    }
+
+    void* submissionEntries = mmap(nullptr, parameters.sq_entries * sizeof(io_uring_sqe), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingHandle, IORING_OFF_SQES);
+
+    if (submissionEntries == MAP_FAILED)
+    {
+        return Status::EventLoopCreationFailed;
+    }
+
+    Byte* submissionRing = static_cast<Byte*>(m_SubmissionRing);
+    Byte* completionRing = static_cast<Byte*>(m_CompletionRing);
+
+    m_SubmissionEntries = static_cast<io_uring_sqe*>(submissionEntries);
+    m_NumberSubmissionEntries = parameters.sq_entries;
+    m_SubmissionHead = reinterpret_cast<uint32_t*>(submissionRing + parameters.sq_off.head);
+    m_SubmissionTail = reinterpret_cast<uint32_t*>(submissionRing + parameters.sq_off.tail);
+    m_SubmissionMask = *reinterpret_cast<uint32_t*>(submissionRing + parameters.sq_off.ring_mask);
+    m_LocalSubmissionTail = *m_SubmissionTail;
+    m_CompletionHead = reinterpret_cast<uint32_t*>(completionRing + parameters.cq_off.head);
+    m_CompletionTail = reinterpret_cast<uint32_t*>(completionRing + parameters.cq_off.tail);
+    m_CompletionMask = *reinterpret_cast<uint32_t*>(completionRing + parameters.cq_off.ring_mask);
+    m_CompletionEntries = reinterpret_cast<io_uring_cqe*>(completionRing + parameters.cq_off.cqes);
+
+    //
+    // Submission entries are used in ring order, so the indirection array is an identity mapping set once.
+    //
+    uint32_t* submissionArray = reinterpret_cast<uint32_t*>(submissionRing + parameters.sq_off.array);
+
+    for (uint32_t entryIndex = 0; entryIndex < m_NumberSubmissionEntries; ++entryIndex)
+    {
+        submissionArray[entryIndex] = entryIndex;
+    }
+
+    return Status::Success;
+}
+
+StatusCode
+IoRing::RegisterBufferRing(
+    const uint32_t p_NumberBuffers)
+{
+    if (p_NumberBuffers == 0 ||
+        p_NumberBuffers > (1u << 15) ||
+        (p_NumberBuffers & (p_NumberBuffers - 1)) != 0)
+    {
+        return Status::EventLoopRegistrationFailed;
+    }
+
+    m_BufferRingSize = p_NumberBuffers * sizeof(io_uring_buf);
+
+    void* bufferRing = mmap(nullptr, m_BufferRingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (bufferRing == MAP_FAILED)
+    {
+        return Status::OutOfMemory;
+    }
+
+    m_BufferRing = static_cast<io_uring_buf_ring*>(bufferRing);
+    m_BufferRingMask = static_cast<uint16_t>(p_NumberBuffers - 1);
+    m_BufferRingTail = 0;
+
+    io_uring_buf_reg registration {};
+    registration.ring_addr = reinterpret_cast<uint64_t>(m_BufferRing);
+    registration.ring_entries = p_NumberBuffers;
+    registration.bgid = c_BufferGroupId;
+
+    if (syscall(__NR_io_uring_register, m_RingHandle, IORING_REGISTER_PBUF_RING, &registration, 1) < 0)
+    {
+        return Status::EventLoopRegistrationFailed;
+    }
+
+    return Status::Success;
+}
+
+void
+IoRing::ProvideBuffer(
+    Byte* p_Data,
+    const uint32_t p_Size,
+    const uint16_t p_BufferId)
+{
+    //
+    // Entries are addressed from the ring base; the flexible array member of the kernel header does not
+    // start at offset zero when compiled as C++.
+    //
+    io_uring_buf& buffer = reinterpret_cast<io_uring_buf*>(m_BufferRing)[m_BufferRingTail & m_BufferRingMask];
+    buffer.addr = reinterpret_cast<uint64_t>(p_Data);
+    buffer.len = p_Size;
+    buffer.bid = p_BufferId;
+
+    //
+    // The tail overlays the reserved field of the first entry, so it is published on its own.
+    //
+    std::atomic_ref<uint16_t>(m_BufferRing->tail).store(++m_BufferRingTail, std::memory_order_release);
+}
+
+bool
+IoRing::PrepareMultishotAccept(
+    const FileDescriptor p_Handle,
+    const uint64_t p_UserData)
+{
+    io_uring_sqe* entry = GetSubmissionEntry();
+
+    if (entry == nullptr)
+    {
+        return false;
+    }
+
+    entry->opcode = IORING_OP_ACCEPT;
+    entry->fd = p_Handle;
+    entry->ioprio = IORING_ACCEPT_MULTISHOT;
+    entry->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    entry->user_data = p_UserData;
+
+    return true;
+}
+
+bool
+IoRing::PrepareMultishotPoll(
+    const FileDescriptor p_Handle,
+    const uint32_t p_Events,
+    const uint64_t p_UserData)
+{
+    io_uring_sqe* entry = GetSubmissionEntry();
+
+    if (entry == nullptr)
+    {
+        return false;
+    }
+
+    entry->opcode = IORING_OP_POLL_ADD;
+    entry->fd = p_Handle;
+    entry->len = IORING_POLL_ADD_MULTI;
+    entry->poll32_events = p_Events;
+    entry->user_data = p_UserData;
+
+    return true;
+}
+
+bool
+IoRing::PrepareCancel(
+    const uint64_t p_UserData)
+{
+    io_uring_sqe* entry = GetSubmissionEntry();
+
+    if (entry == nullptr)
+    {
+        return false;
+    }
+
+    entry->opcode = IORING_OP_ASYNC_CANCEL;
+    entry->fd = -1;
+    entry->addr = p_UserData;
+    entry->user_data = 0;
+
+    return true;
+}
+
+bool
+IoRing::PrepareReceive(
+    const FileDescriptor p_Handle,
+    const uint64_t p_UserData)
+{
+    io_uring_sqe* entry = GetSubmissionEntry();
+
+    if (entry == nullptr)
+    {
+        return false;
+    }
+
+    entry->opcode = IORING_OP_RECV;
+    entry->fd = p_Handle;
+    entry->flags = IOSQE_BUFFER_SELECT;
+    entry->buf_group = c_BufferGroupId;
+    entry->user_data = p_UserData;
+
+    return true;
+}
+
+bool
+IoRing::PrepareSendMessage(
+    const FileDescriptor p_Handle,
+    const msghdr* p_Message,
+    const uint64_t p_UserData)
+{
+    io_uring_sqe* entry = GetSubmissionEntry();
+
+    if (entry == nullptr)
+    {
+        return false;
+    }
+
+    entry->opcode = IORING_OP_SENDMSG;
+    entry->fd = p_Handle;
+    entry->addr = reinterpret_cast<uint64_t>(p_Message);
+    entry->len = 1u;
+    entry->msg_flags = MSG_NOSIGNAL;
+    entry->user_data = p_UserData;
+
+    return true;
+}
+
+uint32_t
+IoRing::Wait(
+    const int32_t p_TimeoutMilliseconds)
+{
+    //
+    // Release the completions handed out by the previous wait.
+    //
+    std::atomic_ref<uint32_t>(*m_CompletionHead).store(*m_CompletionHead + m_NumberCompletions, std::memory_order_release);
+    m_NumberCompletions = 0;
+
+    const uint32_t completionHead = *m_CompletionHead;
+
+    if (std::atomic_ref<uint32_t>(*m_CompletionTail).load(std::memory_order_acquire) != completionHead)
+    {
+        //
+        // Completions are already available; only hand the queued operations over.
+        //
+        Enter(0u, 0u, nullptr, 0u);
+    }
+    else
+    {
+        __kernel_timespec timeout {};
+        timeout.tv_sec = p_TimeoutMilliseconds / 1000;
+        timeout.tv_nsec = (p_TimeoutMilliseconds % 1000) * 1000000ll;
+
+        io_uring_getevents_arg argument {};
+        argument.sigmask_sz = _NSIG / 8;
+        argument.ts = reinterpret_cast<uint64_t>(&timeout);
+
+        //
+        // Timeouts and interrupted waits are treated as a wait with no completions.
+        //
+        Enter(1u, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &argument, sizeof(argument));
+    }
+
+    m_NumberCompletions = std::atomic_ref<uint32_t>(*m_CompletionTail).load(std::memory_order_acquire) - completionHead;
+
+    return m_NumberCompletions;
+}
+
+uint64_t
+IoRing::GetCompletionUserData(
+    const uint32_t p_CompletionIndex) const
+{
+    return m_CompletionEntries[(*m_CompletionHead + p_CompletionIndex) & m_CompletionMask].user_data;
+}
+
+int32_t
+IoRing::GetCompletionResult(
+    const uint32_t p_CompletionIndex) const
+{
+    return m_CompletionEntries[(*m_CompletionHead + p_CompletionIndex) & m_CompletionMask].res;
+}
+
+uint32_t
+IoRing::GetCompletionFlags(
+    const uint32_t p_CompletionIndex) const
+{
+    return m_CompletionEntries[(*m_CompletionHead + p_CompletionIndex) & m_CompletionMask].flags;
+}
+
+io_uring_sqe*
+IoRing::GetSubmissionEntry()
+{
+    if (m_LocalSubmissionTail - std::atomic_ref<uint32_t>(*m_SubmissionHead).load(std::memory_order_acquire) >= m_NumberSubmissionEntries)
+    {
+        //
+        // Queue full; hand the queued operations over to the kernel to free up entries.
+        //
+        Enter(0u, 0u, nullptr, 0u);
+
+        if (m_LocalSubmissionTail - std::atomic_ref<uint32_t>(*m_SubmissionHead).load(std::memory_order_acquire) >= m_NumberSubmissionEntries)
+        {
+            return nullptr;
+        }
+    }
+
+    io_uring_sqe* entry = &m_SubmissionEntries[m_LocalSubmissionTail & m_SubmissionMask];
+    std::memset(entry, 0, sizeof(io_uring_sqe));
+    ++m_LocalSubmissionTail;
+
+    return entry;
+}
+
+int32_t
+IoRing::Enter(
+    const uint32_t p_MinNumberCompletions,
+    const uint32_t p_Flags,
+    const void* p_Argument,
+    const size_t p_ArgumentSize)
+{
+    //
+    // Publish the queued entries. Entries the kernel did not take on a previous call are submitted again.
+    //
+    std::atomic_ref<uint32_t>(*m_SubmissionTail).store(m_LocalSubmissionTail, std::memory_order_release);
+    const uint32_t numberQueuedEntries = m_LocalSubmissionTail - std::atomic_ref<uint32_t>(*m_SubmissionHead).load(std::memory_order_acquire);
+
+    if (numberQueuedEntries == 0 &&
+        p_MinNumberCompletions == 0)
+    {
+        return 0;
+    }
+
+    int32_t result;
+
+    do
+    {
+        result = static_cast<int32_t>(syscall(
+            __NR_io_uring_enter,
+            m_RingHandle,
+            numberQueuedEntries,
+            p_MinNumberCompletions,
+            p_Flags,
+            p_Argument,
+            p_ArgumentSize));
+    }
+    while (result < 0 && errno == EINTR && p_MinNumberCompletions == 0);
+
+    return result;
+}
+
+} // namespace gX.
@@ -0,0 +1,265 @@
+// *************************************
+// Ganymede Xpedia
+// Common
+// 'gXIoRing.hh'
+// Author: jcjuarez
+// *************************************
+
+#ifndef GX_IO_RING_
+#define GX_IO_RING_
+
+#include <cstddef>
+#include <cstdint>
+#include "gXStatus.hh"
+#include <sys/socket.h>
+#include <linux/io_uring.h>
+
+namespace gX
+{
+
+//
+// Minimal io_uring instance driven through the raw system calls, meant to be owned by a single thread.
+// Operations are queued with Prepare* methods and handed to the kernel in one batch on the next wait.
+// Receives pick their memory from a ring of provided buffers registered with the instance.
+//
+class IoRing
+{
+
+public:
+
+    //
+    // Constructor.
+    //
+    IoRing();
+
+    //
+    // Destructor. Releases the underlying io_uring instance and its mappings.
+    //
+    ~IoRing();
+
+    //
+    // Initializes the instance with the specified number of submission entries.
+    //
+    StatusCode
+    Init(
+        const uint32_t p_NumberEntries);
+
+    //
+    // Registers the ring of provided receive buffers. The number of buffers must be a power of two.
+    //
+    StatusCode
+    RegisterBufferRing(
+        const uint32_t p_NumberBuffers);
+
+    //
+    // Hands a buffer over to the provided buffer ring. The identifier is reported back on the
+    // completion of the receive that consumed the buffer.
+    //
+    void
+    ProvideBuffer(
+        Byte* p_Data,
+        const uint32_t p_Size,
+        const uint16_t p_BufferId);
+
+    //
+    // Queues an accept that keeps producing a completion per incoming connection.
+    //
+    bool
+    PrepareMultishotAccept(
+        const FileDescriptor p_Handle,
+        const uint64_t p_UserData);
+
+    //
+    // Queues a poll that keeps producing a completion every time the file descriptor becomes ready.
+    //
+    bool
+    PrepareMultishotPoll(
+        const FileDescriptor p_Handle,
+        const uint32_t p_Events,
+        const uint64_t p_UserData);
+
+    //
+    // Queues the cancellation of the operation queued with the specified user data, which then completes
+    // with -ECANCELED. The cancellation itself completes with zero user data.
+    //
+    bool
+    PrepareCancel(
+        const uint64_t p_UserData);
+
+    //
+    // Queues a receive into a buffer picked from the provided buffer ring.
+    //
+    bool
+    PrepareReceive(
+        const FileDescriptor p_Handle,
+        const uint64_t p_UserData);
+
+    //
+    // Queues a scatter-gather send of the specified message. The message, its I/O vector and
+    // the data it points to must stay valid until the send completes.
+    //
+    bool
+    PrepareSendMessage(
+        const FileDescriptor p_Handle,
+        const msghdr* p_Message,
+        const uint64_t p_UserData);
+
+    //
+    // Submits all queued operations and waits for completions up to the specified timeout.
+    // Returns the number of completions, which can be accessed through GetCompletion* methods
+    // until the next wait.
+    //
+    uint32_t
+    Wait(
+        const int32_t p_TimeoutMilliseconds);
+
+    //
+    // Returns the user data of a completion.
+    //
+    uint64_t
+    GetCompletionUserData(
+        const uint32_t p_CompletionIndex) const;
+
+    //
+    // Returns the result of a completion; negative values are errno codes.
+    //
+    int32_t
+    GetCompletionResult(
+        const uint32_t p_CompletionIndex) const;
+
+    //
+    // Returns the IORING_CQE_F_* flags of a completion.
+    //
+    uint32_t
+    GetCompletionFlags(
+        const uint32_t p_CompletionIndex) const;
+
+    //
+    // Identifier of the provided buffer group used for receives.
+    //
+    static constexpr uint16_t c_BufferGroupId = 0u;
+
+private:
+
+    //
+    // Returns a cleared submission entry, flushing the queue to the kernel if it is full.
+    // Returns null if no entry could be freed.
+    //
+    io_uring_sqe*
+    GetSubmissionEntry();
+
+    //
+    // Invokes io_uring_enter for the queued submissions.
+    //
+    int32_t
+    Enter(
+        const uint32_t p_MinNumberCompletions,
+        const uint32_t p_Flags,
+        const void* p_Argument,
+        const size_t p_ArgumentSize);
+
+    //
+    // Handle for the underlying io_uring instance.
+    //
+    FileDescriptor m_RingHandle;
+
+    //
+    // Mapping of the submission queue ring.
+    //
+    void* m_SubmissionRing;
+
+    //
+    // Size of the submission queue ring mapping.
+    //
+    size_t m_SubmissionRingSize;
+
+    //
+    // Mapping of the completion queue ring. Shared with the submission ring when the kernel supports it.
+    //
+    void* m_CompletionRing;
+
+    //
+    // Size of the completion queue ring mapping.
+    //
+    size_t m_CompletionRingSize;
+
+    //
+    // Mapping of the submission entries.
+    //
+    io_uring_sqe* m_SubmissionEntries;
+
+    //
+    // Number of submission entries.
+    //
+    uint32_t m_NumberSubmissionEntries;
+
+    //
+    // Kernel-owned head of the submission queue.
+    //
+    uint32_t* m_SubmissionHead;
+
+    //
+    // Tail of the submission queue published to the kernel.
+    //
+    uint32_t* m_SubmissionTail;
+
+    //
+    // Index mask of the submission queue.
+    //
+    uint32_t m_SubmissionMask;
+
+    //
+    // Tail of the submission queue including the entries not yet published.
+    //
+    uint32_t m_LocalSubmissionTail;
+
+    //
+    // Head of the completion queue, advanced by this side.
+    //
+    uint32_t* m_CompletionHead;
+
+    //
+    // Kernel-owned tail of the completion queue.
+    //
+    uint32_t* m_CompletionTail;
+
+    //
+    // Index mask of the completion queue.
+    //
+    uint32_t m_CompletionMask;
+
+    //
+    // Completion entries.
+    //
+    io_uring_cqe* m_CompletionEntries;
+
+    //
+    // Number of completions returned by the last wait, released on the next one.
+    //
+    uint32_t m_NumberCompletions;
+
+    //
+    // Mapping of the provided buffer ring.
+    //
+    io_uring_buf_ring* m_BufferRing;
+
+    //
+    // Size of the provided buffer ring mapping.
+    //
+    size_t m_BufferRingSize;
+
+    //
+    // Index mask of the provided buffer ring.
+    //
+    uint16_t m_BufferRingMask;
+
+    //
+    // Tail of the provided buffer ring.
+    //
+    uint16_t m_BufferRingTail;
+
+};
+
+} // namespace gX.
+
+#endif
@@ -0,0 +1,119 @@
+// *************************************
+// Ganymede Xpedia
+// Common
+// 'gXLatencyHistogram.cc'
+// Author: jcjuarez
+// *************************************
+
+#include <bit>
+#include <cmath>
+#include <algorithm>
+#include "gXLatencyHistogram.hh"
+
+namespace gX
+{
+
+LatencyHistogram::LatencyHistogram()
+{
+    for (std::atomic<uint64_t>& count : m_Counts)
+    {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+void
+LatencyHistogram::Record(
+    const uint64_t p_Value)
+{
+    //
+    // Single writer; a plain load and store avoids the cost of an atomic read-modify-write.
+    //
+    std::atomic<uint64_t>& count = m_Counts[GetBucketIndex(p_Value)];
+    count.store(count.load(std::memory_order_relaxed) + 1u, std::memory_order_relaxed);
+}
+
+void
+LatencyHistogram::MergeInto(
+    std::vector<uint64_t>& p_Counts) const
+{
+    for (uint32_t bucketIndex = 0; bucketIndex < c_NumberBuckets; ++bucketIndex)
+    {
+        p_Counts[bucketIndex] += m_Counts[bucketIndex].load(std::memory_order_relaxed);
+    }
+}
+
+uint32_t
+LatencyHistogram::GetBucketIndex(
+    const uint64_t p_Value)
+{
+    if (p_Value < c_NumberSubBuckets)
+    {
+        return static_cast<uint32_t>(p_Value);
+    }
+
+    if (p_Value > c_MaxValue)
+    {
+        return c_NumberBuckets - 1u;
+    }
+
+    //
+    // The exponent selects the power of two range and the bits right below the leading one select the linear bucket within it.
+    //
+    const uint32_t exponent = static_cast<uint32_t>(std::bit_width(p_Value)) - 1u;
+    const uint32_t shift = exponent - c_SubBucketBits;
+
+    return (shift + 1u) * c_NumberSubBuckets + static_cast<uint32_t>(p_Value >> shift) - c_NumberSubBuckets;
+}
+
+uint64_t
+LatencyHistogram::GetBucketValue(
+    const uint32_t p_BucketIndex)
+{
+    if (p_BucketIndex < c_NumberSubBuckets)
+    {
+        return p_BucketIndex;
+    }
+
+    const uint32_t shift = p_BucketIndex / c_NumberSubBuckets - 1u;
+    const uint64_t subBucket = p_BucketIndex % c_NumberSubBuckets + c_NumberSubBuckets;
+
+    return ((subBucket + 1u) << shift) - 1u;
+}
+
+uint64_t
+LatencyHistogram::GetValueAtPercentile(
+    const std::vector<uint64_t>& p_Counts,
+    const double p_Percentile)
+{
+    uint64_t totalCount = 0;
+
+    for (const uint64_t count : p_Counts)
+    {
+        totalCount += count;
+    }
+
+    if (totalCount == 0)
+    {
+        return 0;
+    }
+
+    const uint64_t targetCount = std::max<uint64_t>(
+        1u,
+        static_cast<uint64_t>(std::ceil(std::clamp(p_Percentile, 0.0, 100.0) / 100.0 * static_cast<double>(totalCount))));
+
+    uint64_t cumulativeCount = 0;
+
+    for (uint32_t bucketIndex = 0; bucketIndex < p_Counts.size(); ++bucketIndex)
+    {
+        cumulativeCount += p_Counts[bucketIndex];
+
+        if (cumulativeCount >= targetCount)
+        {
+            return GetBucketValue(bucketIndex);
+        }
+    }
+
+    return GetBucketValue(static_cast<uint32_t>(p_Counts.size()) - 1u);
+}
+
+} // namespace gX.
@@ -0,0 +1,107 @@
+// *************************************
+// Ganymede Xpedia
+// Common
+// 'gXLatencyHistogram.hh'
+// Author: jcjuarez
+// *************************************
+
+#ifndef GX_LATENCY_HISTOGRAM_
+#define GX_LATENCY_HISTOGRAM_
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include "gXStatus.hh"
+
+namespace gX
+{
+
+//
+// Log-linear latency histogram in the style of HDR histograms. Every power of two range is split
+// into c_NumberSubBuckets linear buckets, which bounds the relative error of any recorded value
+// to 1 / c_NumberSubBuckets regardless of its magnitude.
+// Meant to have a single writer; recording is lock-free and readers may merge it concurrently.
+//
+class LatencyHistogram
+{
+
+public:
+
+    //
+    // Constructor. Creates an empty histogram.
+    //
+    LatencyHistogram();
+
+    //
+    // Records a value. Must only be called from the thread owning the histogram.
+    //
+    void
+    Record(
+        const uint64_t p_Value);
+
+    //
+    // Adds the counts of the histogram into the specified buckets, which must hold c_NumberBuckets entries.
+    // Safe to call while the owning thread is recording.
+    //
+    void
+    MergeInto(
+        std::vector<uint64_t>& p_Counts) const;
+
+    //
+    // Returns the bucket holding the specified value. Values beyond c_MaxValue land in the last bucket.
+    //
+    static
+    uint32_t
+    GetBucketIndex(
+        const uint64_t p_Value);
+
+    //
+    // Returns the highest value held by the specified bucket.
+    //
+    static
+    uint64_t
+    GetBucketValue(
+        const uint32_t p_BucketIndex);
+
+    //
+    // Returns the value below which the specified percentile [0, 100] of the counts falls.
+    // Returns zero for empty counts.
+    //
+    static
+    uint64_t
+    GetValueAtPercentile(
+        const std::vector<uint64_t>& p_Counts,
+        const double p_Percentile);
+
+    //
+    // Number of bits of precision within each power of two range.
+    //
+    static constexpr uint32_t c_SubBucketBits = 5u;
+
+    //
+    // Number of linear buckets within each power of two range.
+    //
+    static constexpr uint32_t c_NumberSubBuckets = 1u << c_SubBucketBits;
+
+    //
+    // Total number of buckets.
+    //
+    static constexpr uint32_t c_NumberBuckets = 1024u;
+
+    //
+    // Highest value tracked with full precision.
+    //
+    static constexpr uint64_t c_MaxValue = (uint64_t { 1 } << (c_NumberBuckets / c_NumberSubBuckets + c_SubBucketBits - 1)) - 1u;
+
+private:
+
+    //
+    // Number of values recorded in each bucket.
+    //
+    std::atomic<uint64_t> m_Counts[c_NumberBuckets];
+
+};
+
+} // namespace gX.
+
+#endif
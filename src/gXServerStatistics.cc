@@ -0,0 +1,354 @@
+// *************************************
+// Ganymede Xpedia
+// gXDTP (Data Transmission Protocol)
+// 'gXServerStatistics.cc'
+// Author: jcjuarez
+// *************************************
+
+#include <new>
+#include <cstring>
+#include <endian.h>
+#include "gXServerStatistics.hh"
+
+namespace gX
+{
+
+EndpointStatistics::EndpointStatistics()
+    : m_NumberFailedRequests(0)
+{}
+
+ThreadStatistics::ThreadStatistics(
+    const uint32_t p_NumberEndpoints)
+    : m_NumberAcceptedConnections(0),
+      m_NumberBytesRead(0),
+      m_NumberBytesWritten(0),
+      m_NumberUnknownPacketTags(0),
+      m_NumberChecksumFailures(0),
+      m_NumberExpiredRequests(0),
+      m_NumberTimedOutConnections(0),
+      m_Endpoints(std::make_unique<EndpointStatistics[]>(p_NumberEndpoints))
+{}
+
+StatisticsSnapshot::StatisticsSnapshot()
+    : m_NumberAcceptedConnections(0),
+      m_NumberBytesRead(0),
+      m_NumberBytesWritten(0),
+      m_NumberRejectedRequests(0),
+      m_NumberShedRequests(0),
+      m_NumberUnknownPacketTags(0),
+      m_NumberChecksumFailures(0),
+      m_NumberExpiredRequests(0),
+      m_NumberTimedOutConnections(0),
+      m_NumberRequestsInExecution(0)
+{}
+
+StatusCode
+StatisticsSnapshot::Serialize(
+    ResponseWriter& p_Response) const
+{
+    const uint64_t counters[] = {
+        m_NumberAcceptedConnections,
+        m_NumberBytesRead,
+        m_NumberBytesWritten,
+        m_NumberRejectedRequests,
+        m_NumberShedRequests,
+        m_NumberUnknownPacketTags,
+        m_NumberChecksumFailures,
+        m_NumberExpiredRequests,
+        m_NumberTimedOutConnections,
+        m_NumberRequestsInExecution
+    };
+
+    StatusCode status = AppendInteger(p_Response, c_Version);
+
+    for (const uint64_t counter : counters)
+    {
+        if (Status::Succeeded(status))
+        {
+            status = AppendInteger(p_Response, counter);
+        }
+    }
+
+    if (Status::Succeeded(status))
+    {
+        status = AppendInteger(p_Response, LatencyHistogram::c_NumberBuckets);
+    }
+
+    if (Status::Succeeded(status))
+    {
+        status = AppendInteger(p_Response, static_cast<uint32_t>(m_Endpoints.size()));
+    }
+
+    for (const EndpointSnapshot& endpoint : m_Endpoints)
+    {
+        if (Status::Failed(status))
+        {
+            break;
+        }
+
+        status = AppendInteger(p_Response, endpoint.m_PacketTag);
+
+        if (Status::Succeeded(status))
+        {
+            status = AppendInteger(p_Response, endpoint.m_NumberFailedRequests);
+        }
+
+        if (Status::Succeeded(status))
+        {
+            status = AppendHistogram(p_Response, endpoint.m_QueueWaitTime);
+        }
+
+        if (Status::Succeeded(status))
+        {
+            status = AppendHistogram(p_Response, endpoint.m_ExecutionTime);
+        }
+
+        if (Status::Succeeded(status))
+        {
+            status = AppendHistogram(p_Response, endpoint.m_EndToEndTime);
+        }
+    }
+
+    return status;
+}
+
+StatusCode
+StatisticsSnapshot::Deserialize(
+    std::string_view p_Data)
+{
+    uint32_t version;
+    uint32_t numberBuckets;
+    uint32_t numberEndpoints;
+
+    if (!ReadInteger(p_Data, version) ||
+        version != c_Version ||
+        !ReadInteger(p_Data, m_NumberAcceptedConnections) ||
+        !ReadInteger(p_Data, m_NumberBytesRead) ||
+        !ReadInteger(p_Data, m_NumberBytesWritten) ||
+        !ReadInteger(p_Data, m_NumberRejectedRequests) ||
+        !ReadInteger(p_Data, m_NumberShedRequests) ||
+        !ReadInteger(p_Data, m_NumberUnknownPacketTags) ||
+        !ReadInteger(p_Data, m_NumberChecksumFailures) ||
+        !ReadInteger(p_Data, m_NumberExpiredRequests) ||
+        !ReadInteger(p_Data, m_NumberTimedOutConnections) ||
+        !ReadInteger(p_Data, m_NumberRequestsInExecution) ||
+        !ReadInteger(p_Data, numberBuckets) ||
+        numberBuckets != LatencyHistogram::c_NumberBuckets ||
+        !ReadInteger(p_Data, numberEndpoints))
+    {
+        return Status::InvalidFrame;
+    }
+
+    try
+    {
+        m_Endpoints.clear();
+
+        for (uint32_t endpointIndex = 0; endpointIndex < numberEndpoints; ++endpointIndex)
+        {
+            EndpointSnapshot& endpoint = m_Endpoints.emplace_back();
+
+            if (!ReadInteger(p_Data, endpoint.m_PacketTag) ||
+                !ReadInteger(p_Data, endpoint.m_NumberFailedRequests) ||
+                !ReadHistogram(p_Data, endpoint.m_QueueWaitTime) ||
+                !ReadHistogram(p_Data, endpoint.m_ExecutionTime) ||
+                !ReadHistogram(p_Data, endpoint.m_EndToEndTime))
+            {
+                return Status::InvalidFrame;
+            }
+        }
+    }
+    catch (const std::bad_alloc& e)
+    {
+        return Status::OutOfMemory;
+    }
+
+    return Status::Success;
+}
+
+template<typename Integer>
+StatusCode
+StatisticsSnapshot::AppendInteger(
+    ResponseWriter& p_Response,
+    const Integer p_Value)
+{
+    const Integer value = sizeof(Integer) == sizeof(uint64_t) ?
+        static_cast<Integer>(htobe64(p_Value)) :
+        static_cast<Integer>(htobe32(static_cast<uint32_t>(p_Value)));
+
+    return p_Response.Append(std::string_view(reinterpret_cast<const char*>(&value), sizeof(value)));
+}
+
+template<typename Integer>
+bool
+StatisticsSnapshot::ReadInteger(
+    std::string_view& p_Data,
+    Integer& p_Value)
+{
+    if (p_Data.size() < sizeof(Integer))
+    {
+        return false;
+    }
+
+    std::memcpy(&p_Value, p_Data.data(), sizeof(Integer));
+    p_Data.remove_prefix(sizeof(Integer));
+
+    p_Value = sizeof(Integer) == sizeof(uint64_t) ?
+        static_cast<Integer>(be64toh(p_Value)) :
+        static_cast<Integer>(be32toh(static_cast<uint32_t>(p_Value)));
+
+    return true;
+}
+
+StatusCode
+StatisticsSnapshot::AppendHistogram(
+    ResponseWriter& p_Response,
+    const std::vector<uint64_t>& p_Counts)
+{
+    uint32_t numberBuckets = 0;
+
+    for (const uint64_t count : p_Counts)
+    {
+        numberBuckets += count != 0 ? 1u : 0u;
+    }
+
+    StatusCode status = AppendInteger(p_Response, numberBuckets);
+
+    for (uint32_t bucketIndex = 0; bucketIndex < p_Counts.size() && Status::Succeeded(status); ++bucketIndex)
+    {
+        if (p_Counts[bucketIndex] != 0)
+        {
+            status = AppendInteger(p_Response, bucketIndex);
+
+            if (Status::Succeeded(status))
+            {
+                status = AppendInteger(p_Response, p_Counts[bucketIndex]);
+            }
+        }
+    }
+
+    return status;
+}
+
+bool
+StatisticsSnapshot::ReadHistogram(
+    std::string_view& p_Data,
+    std::vector<uint64_t>& p_Counts)
+{
+    uint32_t numberBuckets;
+
+    if (!ReadInteger(p_Data, numberBuckets))
+    {
+        return false;
+    }
+
+    p_Counts.assign(LatencyHistogram::c_NumberBuckets, 0u);
+
+    for (uint32_t index = 0; index < numberBuckets; ++index)
+    {
+        uint32_t bucketIndex;
+        uint64_t count;
+
+        if (!ReadInteger(p_Data, bucketIndex) ||
+            !ReadInteger(p_Data, count) ||
+            bucketIndex >= LatencyHistogram::c_NumberBuckets)
+        {
+            return false;
+        }
+
+        p_Counts[bucketIndex] = count;
+    }
+
+    return true;
+}
+
+ServerStatistics::ServerStatistics()
+{}
+
+StatusCode
+ServerStatistics::Init(
+    const std::vector<PacketTag>& p_PacketTags,
+    const uint32_t p_NumberThreads)
+{
+    try
+    {
+        m_PacketTags = p_PacketTags;
+
+        for (uint32_t threadIndex = 0; threadIndex < p_NumberThreads; ++threadIndex)
+        {
+            m_Threads.emplace_back(std::make_unique<ThreadStatistics>(static_cast<uint32_t>(m_PacketTags.size())));
+        }
+    }
+    catch (const std::bad_alloc& e)
+    {
+        return Status::OutOfMemory;
+    }
+
+    return Status::Success;
+}
+
+ThreadStatistics*
+ServerStatistics::GetThreadStatistics(
+    const uint32_t p_ThreadIndex)
+{
+    return p_ThreadIndex < m_Threads.size() ?
+        m_Threads[p_ThreadIndex].get() :
+        nullptr;
+}
+
+EndpointStatistics*
+ServerStatistics::GetEndpointStatistics(
+    ThreadStatistics& p_ThreadStatistics,
+    const uint32_t p_EndpointIndex) const
+{
+    return &p_ThreadStatistics.m_Endpoints[p_EndpointIndex];
+}
+
+StatusCode
+ServerStatistics::TakeSnapshot(
+    StatisticsSnapshot& p_Snapshot) const
+{
+    try
+    {
+        p_Snapshot.m_Endpoints.resize(m_PacketTags.size());
+
+        for (uint32_t endpointIndex = 0; endpointIndex < m_PacketTags.size(); ++endpointIndex)
+        {
+            StatisticsSnapshot::EndpointSnapshot& endpoint = p_Snapshot.m_Endpoints[endpointIndex];
+            endpoint.m_PacketTag = m_PacketTags[endpointIndex];
+            endpoint.m_NumberFailedRequests = 0;
+            endpoint.m_QueueWaitTime.assign(LatencyHistogram::c_NumberBuckets, 0u);
+            endpoint.m_ExecutionTime.assign(LatencyHistogram::c_NumberBuckets, 0u);
+            endpoint.m_EndToEndTime.assign(LatencyHistogram::c_NumberBuckets, 0u);
+        }
+    }
+    catch (const std::bad_alloc& e)
+    {
+        return Status::OutOfMemory;
+    }
+
+    for (const std::unique_ptr<ThreadStatistics>& thread : m_Threads)
+    {
+        p_Snapshot.m_NumberAcceptedConnections += thread->m_NumberAcceptedConnections.load(std::memory_order_relaxed);
+        p_Snapshot.m_NumberBytesRead += thread->m_NumberBytesRead.load(std::memory_order_relaxed);
+        p_Snapshot.m_NumberBytesWritten += thread->m_NumberBytesWritten.load(std::memory_order_relaxed);
+        p_Snapshot.m_NumberUnknownPacketTags += thread->m_NumberUnknownPacketTags.load(std::memory_order_relaxed);
+        p_Snapshot.m_NumberChecksumFailures += thread->m_NumberChecksumFailures.load(std::memory_order_relaxed);
+        p_Snapshot.m_NumberExpiredRequests += thread->m_NumberExpiredRequests.load(std::memory_order_relaxed);
+        p_Snapshot.m_NumberTimedOutConnections += thread->m_NumberTimedOutConnections.load(std::memory_order_relaxed);
+
+        for (uint32_t endpointIndex = 0; endpointIndex < m_PacketTags.size(); ++endpointIndex)
+        {
+            const EndpointStatistics& source = thread->m_Endpoints[endpointIndex];
+            StatisticsSnapshot::EndpointSnapshot& endpoint = p_Snapshot.m_Endpoints[endpointIndex];
+
+            endpoint.m_NumberFailedRequests += source.m_NumberFailedRequests.load(std::memory_order_relaxed);
+            source.m_QueueWaitTime.MergeInto(endpoint.m_QueueWaitTime);
+            source.m_ExecutionTime.MergeInto(endpoint.m_ExecutionTime);
+            source.m_EndToEndTime.MergeInto(endpoint.m_EndToEndTime);
+        }
+    }
+
+    return Status::Success;
+}
+
+} // namespace gX.
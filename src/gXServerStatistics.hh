@@ -0,0 +1,357 @@
+// *************************************
+// Ganymede Xpedia
+// gXDTP (Data Transmission Protocol)
+// 'gXServerStatistics.hh'
+// Author: jcjuarez
+// *************************************
+
+#ifndef GX_SERVER_STATISTICS_
+#define GX_SERVER_STATISTICS_
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <string_view>
+#include "gXStatus.hh"
+#include "gXEndpoint.hh"
+#include "gXLatencyHistogram.hh"
+#include "gXDataTransmissionProtocol.hh"
+
+namespace gX
+{
+
+//
+// Statistics of a single endpoint recorded by a single thread.
+//
+struct EndpointStatistics
+{
+
+    //
+    // Constructor.
+    //
+    EndpointStatistics();
+
+    //
+    // Number of executions that returned a failure status.
+    //
+    std::atomic<uint64_t> m_NumberFailedRequests;
+
+    //
+    // Time requests waited in the queue before a worker picked them up, in nanoseconds.
+    //
+    LatencyHistogram m_QueueWaitTime;
+
+    //
+    // Time spent executing the endpoint, in nanoseconds.
+    //
+    LatencyHistogram m_ExecutionTime;
+
+    //
+    // Time from the request being decoded until its response was handed back to its shard, in nanoseconds.
+    //
+    LatencyHistogram m_EndToEndTime;
+
+};
+
+//
+// Counters and histograms of a single server thread. Only written by its thread, so recording
+// never contends; readers merge all threads when taking a snapshot.
+//
+struct alignas(64) ThreadStatistics
+{
+
+    //
+    // Constructor.
+    //
+    ThreadStatistics(
+        const uint32_t p_NumberEndpoints);
+
+    //
+    // Adds to a counter of the thread. Must only be called from the owning thread.
+    //
+    static
+    inline
+    void
+    Add(
+        std::atomic<uint64_t>& p_Counter,
+        const uint64_t p_Value)
+    {
+        p_Counter.store(p_Counter.load(std::memory_order_relaxed) + p_Value, std::memory_order_relaxed);
+    }
+
+    //
+    // Number of connections accepted.
+    //
+    std::atomic<uint64_t> m_NumberAcceptedConnections;
+
+    //
+    // Number of bytes read from connections.
+    //
+    std::atomic<uint64_t> m_NumberBytesRead;
+
+    //
+    // Number of bytes written to connections.
+    //
+    std::atomic<uint64_t> m_NumberBytesWritten;
+
+    //
+    // Number of requests received for packet tags without an endpoint.
+    //
+    std::atomic<uint64_t> m_NumberUnknownPacketTags;
+
+    //
+    // Number of requests whose payload did not match their checksum.
+    //
+    std::atomic<uint64_t> m_NumberChecksumFailures;
+
+    //
+    // Number of requests dropped with DeadlineExceeded because their deadline passed before they executed.
+    //
+    std::atomic<uint64_t> m_NumberExpiredRequests;
+
+    //
+    // Number of connections closed on their read or idle timeout.
+    //
+    std::atomic<uint64_t> m_NumberTimedOutConnections;
+
+    //
+    // Statistics of each endpoint, indexed as resolved by the server statistics.
+    //
+    std::unique_ptr<EndpointStatistics[]> m_Endpoints;
+
+};
+
+//
+// Point-in-time view of the server statistics, merged across all threads.
+// Travels as the payload of the statistics endpoint, serialized in network byte order:
+//
+//   [u32] Format version.
+//   [u64] Accepted connections, bytes read, bytes written, rejected requests,
+//         shed requests, unknown packet tags and requests in execution.
+//   [u32] Number of histogram buckets.
+//   [u32] Number of endpoints, each followed by:
+//         [u32] Packet tag.
+//         [u64] Failed requests.
+//         Queue wait, execution and end-to-end histograms, each as:
+//           [u32] Number of non-empty buckets, each followed by [u32] bucket index and [u64] count.
+//
+struct StatisticsSnapshot
+{
+
+    //
+    // Statistics of a single endpoint. Histogram buckets are those of LatencyHistogram.
+    //
+    struct EndpointSnapshot
+    {
+
+        //
+        // Packet tag of the endpoint.
+        //
+        PacketTag m_PacketTag;
+
+        //
+        // Number of executions that returned a failure status.
+        //
+        uint64_t m_NumberFailedRequests;
+
+        //
+        // Queue wait time buckets, in nanoseconds.
+        //
+        std::vector<uint64_t> m_QueueWaitTime;
+
+        //
+        // Execution time buckets, in nanoseconds.
+        //
+        std::vector<uint64_t> m_ExecutionTime;
+
+        //
+        // End-to-end time buckets, in nanoseconds.
+        //
+        std::vector<uint64_t> m_EndToEndTime;
+
+    };
+
+    //
+    // Constructor.
+    //
+    StatisticsSnapshot();
+
+    //
+    // Serializes the snapshot into a response payload.
+    //
+    StatusCode
+    Serialize(
+        ResponseWriter& p_Response) const;
+
+    //
+    // Deserializes a snapshot from the payload returned by the statistics endpoint.
+    //
+    StatusCode
+    Deserialize(
+        std::string_view p_Data);
+
+    //
+    // Number of connections accepted.
+    //
+    uint64_t m_NumberAcceptedConnections;
+
+    //
+    // Number of bytes read from connections.
+    //
+    uint64_t m_NumberBytesRead;
+
+    //
+    // Number of bytes written to connections.
+    //
+    uint64_t m_NumberBytesWritten;
+
+    //
+    // Number of requests rejected because the request queue was full.
+    //
+    uint64_t m_NumberRejectedRequests;
+
+    //
+    // Number of requests shed because of a standing queueing delay.
+    //
+    uint64_t m_NumberShedRequests;
+
+    //
+    // Number of requests received for packet tags without an endpoint.
+    //
+    uint64_t m_NumberUnknownPacketTags;
+
+    //
+    // Number of requests whose payload did not match their checksum.
+    //
+    uint64_t m_NumberChecksumFailures;
+
+    //
+    // Number of requests dropped with DeadlineExceeded because their deadline passed before they executed.
+    //
+    uint64_t m_NumberExpiredRequests;
+
+    //
+    // Number of connections closed on their read or idle timeout.
+    //
+    uint64_t m_NumberTimedOutConnections;
+
+    //
+    // Number of requests in execution when the snapshot was taken.
+    //
+    uint64_t m_NumberRequestsInExecution;
+
+    //
+    // Statistics of each endpoint.
+    //
+    std::vector<EndpointSnapshot> m_Endpoints;
+
+    //
+    // Current format version.
+    //
+    static constexpr uint32_t c_Version = 4u;
+
+private:
+
+    //
+    // Appends an integer in network byte order to the response payload.
+    //
+    template<typename Integer>
+    static
+    StatusCode
+    AppendInteger(
+        ResponseWriter& p_Response,
+        const Integer p_Value);
+
+    //
+    // Reads an integer in network byte order from the data, advancing past it.
+    //
+    template<typename Integer>
+    static
+    bool
+    ReadInteger(
+        std::string_view& p_Data,
+        Integer& p_Value);
+
+    //
+    // Appends the non-empty buckets of a histogram to the response payload.
+    //
+    static
+    StatusCode
+    AppendHistogram(
+        ResponseWriter& p_Response,
+        const std::vector<uint64_t>& p_Counts);
+
+    //
+    // Reads the non-empty buckets of a histogram from the data, advancing past them.
+    //
+    static
+    bool
+    ReadHistogram(
+        std::string_view& p_Data,
+        std::vector<uint64_t>& p_Counts);
+
+};
+
+//
+// Statistics of the server, kept per thread and per endpoint.
+// The set of endpoints and threads is fixed at initialization.
+//
+class ServerStatistics
+{
+
+public:
+
+    //
+    // Constructor.
+    //
+    ServerStatistics();
+
+    //
+    // Allocates the statistics of the specified number of threads for the specified endpoints.
+    //
+    StatusCode
+    Init(
+        const std::vector<PacketTag>& p_PacketTags,
+        const uint32_t p_NumberThreads);
+
+    //
+    // Returns the statistics of a thread, or null if statistics are not collected.
+    //
+    ThreadStatistics*
+    GetThreadStatistics(
+        const uint32_t p_ThreadIndex);
+
+    //
+    // Returns the statistics of an endpoint recorded by a thread. The endpoint index is the position
+    // of its packet tag in the list the statistics were initialized with.
+    //
+    EndpointStatistics*
+    GetEndpointStatistics(
+        ThreadStatistics& p_ThreadStatistics,
+        const uint32_t p_EndpointIndex) const;
+
+    //
+    // Merges the statistics of all threads into the snapshot.
+    //
+    StatusCode
+    TakeSnapshot(
+        StatisticsSnapshot& p_Snapshot) const;
+
+private:
+
+    //
+    // Packet tags of the endpoints, in the order their statistics are stored.
+    //
+    std::vector<PacketTag> m_PacketTags;
+
+    //
+    // Statistics of each thread.
+    //
+    std::vector<std::unique_ptr<ThreadStatistics>> m_Threads;
+
+};
+
+} // namespace gX.
+
+#endif
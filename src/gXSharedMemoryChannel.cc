@@ -0,0 +1,349 @@
+// *************************************
+// Ganymede Xpedia
+// gXDTP (Data Transmission Protocol)
+// 'gXSharedMemoryChannel.cc'
+// Author: jcjuarez
+// *************************************
+
+#include <bit>
+#include <fcntl.h>
+#include <cstring>
+#include <utility>
+#include <unistd.h>
+#include <algorithm>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/eventfd.h>
+#include "gXSharedMemoryChannel.hh"
+
+namespace gX
+{
+
+SharedMemoryRing::SharedMemoryRing()
+    : m_State(nullptr),
+      m_Data(nullptr),
+      m_Capacity(0)
+{}
+
+void
+SharedMemoryRing::Attach(
+    State* p_State,
+    Byte* p_Data,
+    const uint64_t p_Capacity)
+{
+    m_State = p_State;
+    m_Data = p_Data;
+    m_Capacity = p_Capacity;
+}
+
+size_t
+SharedMemoryRing::Write(
+    const iovec* p_Vector,
+    const size_t p_NumberVectors)
+{
+    const uint64_t tail = m_State->m_Tail.load(std::memory_order_relaxed);
+    size_t freeSize = GetWritableSize();
+    size_t writtenSize = 0;
+
+    for (size_t vectorIndex = 0; vectorIndex < p_NumberVectors && freeSize != 0; ++vectorIndex)
+    {
+        const Byte* data = static_cast<const Byte*>(p_Vector[vectorIndex].iov_base);
+        const size_t size = std::min(p_Vector[vectorIndex].iov_len, freeSize);
+        const uint64_t offset = (tail + writtenSize) & (m_Capacity - 1u);
+        const size_t firstSize = std::min<uint64_t>(size, m_Capacity - offset);
+
+        std::memcpy(m_Data + offset, data, firstSize);
+        std::memcpy(m_Data, data + firstSize, size - firstSize);
+
+        writtenSize += size;
+        freeSize -= size;
+    }
+
+    if (writtenSize != 0)
+    {
+        //
+        // Sequentially consistent, so that either the consumer sees the data before sleeping or this end sees it waiting.
+        //
+        m_State->m_Tail.store(tail + writtenSize, std::memory_order_seq_cst);
+    }
+
+    return writtenSize;
+}
+
+size_t
+SharedMemoryRing::Read(
+    Byte* p_Data,
+    const size_t p_Size)
+{
+    const uint64_t head = m_State->m_Head.load(std::memory_order_relaxed);
+    const size_t size = std::min<uint64_t>(p_Size, GetReadableSize());
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    const uint64_t offset = head & (m_Capacity - 1u);
+    const size_t firstSize = std::min<uint64_t>(size, m_Capacity - offset);
+
+    std::memcpy(p_Data, m_Data + offset, firstSize);
+    std::memcpy(p_Data + firstSize, m_Data, size - firstSize);
+
+    m_State->m_Head.store(head + size, std::memory_order_seq_cst);
+
+    return size;
+}
+
+uint64_t
+SharedMemoryRing::GetReadableSize() const
+{
+    //
+    // The positions are shared with the peer, so they are clamped rather than trusted.
+    //
+    const uint64_t usedSize = m_State->m_Tail.load(std::memory_order_acquire) - m_State->m_Head.load(std::memory_order_relaxed);
+
+    return std::min(usedSize, m_Capacity);
+}
+
+uint64_t
+SharedMemoryRing::GetWritableSize() const
+{
+    const uint64_t usedSize = m_State->m_Tail.load(std::memory_order_relaxed) - m_State->m_Head.load(std::memory_order_acquire);
+
+    return usedSize < m_Capacity ?
+        m_Capacity - usedSize :
+        0;
+}
+
+bool
+SharedMemoryRing::PrepareConsumerWait()
+{
+    m_State->m_IsConsumerWaiting.store(1u, std::memory_order_seq_cst);
+
+    if (GetReadableSize() != 0)
+    {
+        m_State->m_IsConsumerWaiting.store(0, std::memory_order_relaxed);
+
+        return false;
+    }
+
+    return true;
+}
+
+bool
+SharedMemoryRing::PrepareProducerWait()
+{
+    m_State->m_IsProducerWaiting.store(1u, std::memory_order_seq_cst);
+
+    if (GetWritableSize() != 0)
+    {
+        m_State->m_IsProducerWaiting.store(0, std::memory_order_relaxed);
+
+        return false;
+    }
+
+    return true;
+}
+
+bool
+SharedMemoryRing::ShouldWakeConsumer()
+{
+    //
+    // Plain load first, so that the common case of a busy consumer costs no locked instruction.
+    //
+    return m_State->m_IsConsumerWaiting.load(std::memory_order_seq_cst) != 0 &&
+        m_State->m_IsConsumerWaiting.exchange(0, std::memory_order_relaxed) != 0;
+}
+
+bool
+SharedMemoryRing::ShouldWakeProducer()
+{
+    return m_State->m_IsProducerWaiting.load(std::memory_order_seq_cst) != 0 &&
+        m_State->m_IsProducerWaiting.exchange(0, std::memory_order_relaxed) != 0;
+}
+
+SharedMemoryChannel::SharedMemoryChannel()
+    : m_Memory(nullptr),
+      m_MemorySize(0),
+      m_MemoryHandle(-1),
+      m_ServerDoorbellHandle(-1),
+      m_ClientDoorbellHandle(-1)
+{}
+
+SharedMemoryChannel::~SharedMemoryChannel()
+{
+    if (m_Memory != nullptr)
+    {
+        munmap(m_Memory, m_MemorySize);
+    }
+
+    for (const FileDescriptor handle : {m_MemoryHandle, m_ServerDoorbellHandle, m_ClientDoorbellHandle})
+    {
+        if (handle >= 0)
+        {
+            close(handle);
+        }
+    }
+}
+
+StatusCode
+SharedMemoryChannel::Create(
+    const uint32_t p_RingCapacity)
+{
+    const uint64_t ringCapacity = std::bit_ceil(std::clamp(p_RingCapacity, c_MinRingCapacity, c_MaxRingCapacity));
+
+    if ((m_ServerDoorbellHandle = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0 ||
+        (m_ClientDoorbellHandle = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0)
+    {
+        return Status::EventLoopCreationFailed;
+    }
+
+    //
+    // Seal the size, so that the client cannot shrink the memory under the server's mapping.
+    //
+    if ((m_MemoryHandle = memfd_create("gx-dtp-channel", MFD_CLOEXEC | MFD_ALLOW_SEALING)) < 0 ||
+        ftruncate(m_MemoryHandle, static_cast<off_t>(c_DataOffset + ringCapacity * 2u)) < 0 ||
+        fcntl(m_MemoryHandle, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) < 0)
+    {
+        return Status::OutOfMemory;
+    }
+
+    const StatusCode status = Map(ringCapacity);
+
+    if (Status::Failed(status))
+    {
+        return status;
+    }
+
+    //
+    // Fresh memory is zeroed, which leaves both rings empty with no end waiting.
+    //
+    Layout* layout = static_cast<Layout*>(m_Memory);
+    layout->m_Magic = c_Magic;
+    layout->m_Version = c_Version;
+    layout->m_RingCapacity = ringCapacity;
+
+    return Status::Success;
+}
+
+StatusCode
+SharedMemoryChannel::Attach(
+    const FileDescriptor p_MemoryHandle,
+    const FileDescriptor p_ServerDoorbellHandle,
+    const FileDescriptor p_ClientDoorbellHandle)
+{
+    m_MemoryHandle = p_MemoryHandle;
+    m_ServerDoorbellHandle = p_ServerDoorbellHandle;
+    m_ClientDoorbellHandle = p_ClientDoorbellHandle;
+
+    struct stat memoryStatus;
+
+    if (fstat(m_MemoryHandle, &memoryStatus) < 0 ||
+        static_cast<uint64_t>(memoryStatus.st_size) < c_DataOffset + c_MinRingCapacity * 2u)
+    {
+        return Status::InvalidFrame;
+    }
+
+    const uint64_t ringCapacity = (static_cast<uint64_t>(memoryStatus.st_size) - c_DataOffset) / 2u;
+
+    if (!std::has_single_bit(ringCapacity) ||
+        ringCapacity > c_MaxRingCapacity)
+    {
+        return Status::InvalidFrame;
+    }
+
+    const StatusCode status = Map(ringCapacity);
+
+    if (Status::Failed(status))
+    {
+        return status;
+    }
+
+    const Layout* layout = static_cast<const Layout*>(m_Memory);
+
+    if (layout->m_Magic != c_Magic ||
+        layout->m_Version != c_Version ||
+        layout->m_RingCapacity != ringCapacity)
+    {
+        return Status::InvalidFrame;
+    }
+
+    return Status::Success;
+}
+
+SharedMemoryRing&
+SharedMemoryChannel::GetRequestRing()
+{
+    return m_RequestRing;
+}
+
+SharedMemoryRing&
+SharedMemoryChannel::GetResponseRing()
+{
+    return m_ResponseRing;
+}
+
+FileDescriptor
+SharedMemoryChannel::GetMemoryHandle() const
+{
+    return m_MemoryHandle;
+}
+
+FileDescriptor
+SharedMemoryChannel::GetServerDoorbellHandle() const
+{
+    return m_ServerDoorbellHandle;
+}
+
+FileDescriptor
+SharedMemoryChannel::GetClientDoorbellHandle() const
+{
+    return m_ClientDoorbellHandle;
+}
+
+FileDescriptor
+SharedMemoryChannel::ReleaseServerDoorbellHandle()
+{
+    return std::exchange(m_ServerDoorbellHandle, -1);
+}
+
+void
+SharedMemoryChannel::Notify(
+    const FileDescriptor p_DoorbellHandle)
+{
+    eventfd_write(p_DoorbellHandle, 1u);
+}
+
+void
+SharedMemoryChannel::ClearNotifications(
+    const FileDescriptor p_DoorbellHandle)
+{
+    eventfd_t value;
+    eventfd_read(p_DoorbellHandle, &value);
+}
+
+StatusCode
+SharedMemoryChannel::Map(
+    const uint64_t p_RingCapacity)
+{
+    const size_t memorySize = c_DataOffset + p_RingCapacity * 2u;
+    void* memory = mmap(nullptr, memorySize, PROT_READ | PROT_WRITE, MAP_SHARED, m_MemoryHandle, 0);
+
+    if (memory == MAP_FAILED)
+    {
+        return Status::OutOfMemory;
+    }
+
+    m_Memory = memory;
+    m_MemorySize = memorySize;
+
+    Layout* layout = static_cast<Layout*>(m_Memory);
+    Byte* data = static_cast<Byte*>(m_Memory) + c_DataOffset;
+
+    m_RequestRing.Attach(&layout->m_RequestState, data, p_RingCapacity);
+    m_ResponseRing.Attach(&layout->m_ResponseState, data + p_RingCapacity, p_RingCapacity);
+
+    return Status::Success;
+}
+
+} // namespace gX.
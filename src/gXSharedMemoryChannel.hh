@@ -0,0 +1,371 @@
+// *************************************
+// Ganymede Xpedia
+// gXDTP (Data Transmission Protocol)
+// 'gXSharedMemoryChannel.hh'
+// Author: jcjuarez
+// *************************************
+
+#ifndef GX_SHARED_MEMORY_CHANNEL_
+#define GX_SHARED_MEMORY_CHANNEL_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <sys/uio.h>
+#include "gXStatus.hh"
+#include "gXDataTransmissionProtocol.hh"
+
+namespace gX
+{
+
+//
+// Single-producer single-consumer byte ring in memory shared between two processes.
+// Both ends only ever move their own position, so neither needs a lock; the positions grow
+// without bound and are reduced modulo the capacity, which is a power of two.
+//
+class SharedMemoryRing
+{
+
+public:
+
+    //
+    // Positions and wait flags of the ring, placed in the shared memory along with the data.
+    //
+    struct State
+    {
+
+        //
+        // Number of bytes ever written by the producer.
+        //
+        alignas(64) std::atomic<uint64_t> m_Tail;
+
+        //
+        // Number of bytes ever read by the consumer.
+        //
+        alignas(64) std::atomic<uint64_t> m_Head;
+
+        //
+        // Set by the consumer before sleeping on an empty ring; the producer rings its doorbell on the next write.
+        //
+        alignas(64) std::atomic<uint32_t> m_IsConsumerWaiting;
+
+        //
+        // Set by the producer before sleeping on a full ring; the consumer rings its doorbell on the next read.
+        //
+        std::atomic<uint32_t> m_IsProducerWaiting;
+
+    };
+
+    //
+    // Constructor. The ring is unusable until attached.
+    //
+    SharedMemoryRing();
+
+    //
+    // Attaches the ring to its state and data in shared memory.
+    //
+    void
+    Attach(
+        State* p_State,
+        Byte* p_Data,
+        const uint64_t p_Capacity);
+
+    //
+    // Copies as much of the data described by the I/O vector as fits into the ring.
+    // Returns the number of bytes written; zero if the ring is full. Only called by the producer.
+    //
+    size_t
+    Write(
+        const iovec* p_Vector,
+        const size_t p_NumberVectors);
+
+    //
+    // Copies up to the specified number of bytes out of the ring.
+    // Returns the number of bytes read; zero if the ring is empty. Only called by the consumer.
+    //
+    size_t
+    Read(
+        Byte* p_Data,
+        const size_t p_Size);
+
+    //
+    // Returns the number of bytes ready to be read.
+    //
+    uint64_t
+    GetReadableSize() const;
+
+    //
+    // Returns the number of bytes that can be written.
+    //
+    uint64_t
+    GetWritableSize() const;
+
+    //
+    // Announces that the consumer is about to sleep. Returns false, withdrawing the announcement,
+    // if data arrived meanwhile and the consumer must not sleep.
+    //
+    bool
+    PrepareConsumerWait();
+
+    //
+    // Announces that the producer is about to sleep. Returns false, withdrawing the announcement,
+    // if room was made meanwhile and the producer must not sleep.
+    //
+    bool
+    PrepareProducerWait();
+
+    //
+    // Determines whether the consumer sleeps and must be woken up after a write, withdrawing its announcement.
+    //
+    bool
+    ShouldWakeConsumer();
+
+    //
+    // Determines whether the producer sleeps and must be woken up after a read, withdrawing its announcement.
+    //
+    bool
+    ShouldWakeProducer();
+
+private:
+
+    //
+    // Shared state of the ring.
+    //
+    State* m_State;
+
+    //
+    // Shared data of the ring.
+    //
+    Byte* m_Data;
+
+    //
+    // Size of the data; a power of two. Kept privately so that the peer cannot make accesses go out of bounds.
+    //
+    uint64_t m_Capacity;
+
+};
+
+//
+// Pair of shared memory rings, one per direction, through which a client on the same host exchanges
+// DTP frames with the server without going through the socket layer. Each end sleeps on its own
+// eventfd doorbell, which the other end only rings when it announced that it is sleeping.
+// The channel is set up over an AF_UNIX connection, which passes the memory and doorbell handles
+// to the client and whose closure tears the channel down.
+//
+class SharedMemoryChannel
+{
+
+public:
+
+    //
+    // Constructor.
+    //
+    SharedMemoryChannel();
+
+    //
+    // Destructor. Unmaps the memory and closes the handles still owned.
+    //
+    ~SharedMemoryChannel();
+
+    //
+    // Channels own their memory and handles; they cannot be copied.
+    //
+    SharedMemoryChannel(
+        const SharedMemoryChannel&) = delete;
+
+    SharedMemoryChannel&
+    operator=(
+        const SharedMemoryChannel&) = delete;
+
+    //
+    // Creates the memory and doorbells of a new channel, with rings of the specified capacity
+    // rounded up to a power of two. Used by the server.
+    //
+    StatusCode
+    Create(
+        const uint32_t p_RingCapacity);
+
+    //
+    // Maps the memory of a channel created by the server and takes ownership of its handles,
+    // which are closed on failure. Used by the client.
+    //
+    StatusCode
+    Attach(
+        const FileDescriptor p_MemoryHandle,
+        const FileDescriptor p_ServerDoorbellHandle,
+        const FileDescriptor p_ClientDoorbellHandle);
+
+    //
+    // Returns the ring carrying requests from the client to the server.
+    //
+    SharedMemoryRing&
+    GetRequestRing();
+
+    //
+    // Returns the ring carrying responses from the server to the client.
+    //
+    SharedMemoryRing&
+    GetResponseRing();
+
+    //
+    // Returns the handle of the channel memory.
+    //
+    FileDescriptor
+    GetMemoryHandle() const;
+
+    //
+    // Returns the doorbell the server sleeps on.
+    //
+    FileDescriptor
+    GetServerDoorbellHandle() const;
+
+    //
+    // Returns the doorbell the client sleeps on.
+    //
+    FileDescriptor
+    GetClientDoorbellHandle() const;
+
+    //
+    // Hands the ownership of the server doorbell over to the caller.
+    //
+    FileDescriptor
+    ReleaseServerDoorbellHandle();
+
+    //
+    // Rings a doorbell.
+    //
+    static
+    void
+    Notify(
+        const FileDescriptor p_DoorbellHandle);
+
+    //
+    // Resets a doorbell after waking up on it.
+    //
+    static
+    void
+    ClearNotifications(
+        const FileDescriptor p_DoorbellHandle);
+
+    //
+    // Reserved DTP packet tag a client sends over an AF_UNIX connection, with no payload, to set up a channel.
+    // The response carries the memory, server doorbell and client doorbell handles, in that order.
+    //
+    static constexpr PacketTag c_SetupPacketTag = 0xFFFFFFFEu;
+
+    //
+    // Number of handles passed to the client on setup.
+    //
+    static constexpr uint32_t c_NumberHandles = 3u;
+
+private:
+
+    //
+    // Header at the start of the channel memory. The request and response data follow at c_DataOffset.
+    //
+    struct Layout
+    {
+
+        //
+        // Channel identifier, for detecting foreign memory.
+        //
+        uint32_t m_Magic;
+
+        //
+        // Version of the layout.
+        //
+        uint32_t m_Version;
+
+        //
+        // Capacity of each ring.
+        //
+        uint64_t m_RingCapacity;
+
+        //
+        // State of the request ring.
+        //
+        SharedMemoryRing::State m_RequestState;
+
+        //
+        // State of the response ring.
+        //
+        SharedMemoryRing::State m_ResponseState;
+
+    };
+
+    //
+    // Maps the memory and attaches the rings to it.
+    //
+    StatusCode
+    Map(
+        const uint64_t p_RingCapacity);
+
+    //
+    // Mapped channel memory. Null if not mapped.
+    //
+    void* m_Memory;
+
+    //
+    // Size of the mapped memory.
+    //
+    size_t m_MemorySize;
+
+    //
+    // Handle of the channel memory.
+    //
+    FileDescriptor m_MemoryHandle;
+
+    //
+    // Doorbell the server sleeps on.
+    //
+    FileDescriptor m_ServerDoorbellHandle;
+
+    //
+    // Doorbell the client sleeps on.
+    //
+    FileDescriptor m_ClientDoorbellHandle;
+
+    //
+    // Ring carrying requests from the client to the server.
+    //
+    SharedMemoryRing m_RequestRing;
+
+    //
+    // Ring carrying responses from the server to the client.
+    //
+    SharedMemoryRing m_ResponseRing;
+
+    //
+    // Channel memory identifier.
+    //
+    static constexpr uint32_t c_Magic = 0x67584348u;
+
+    //
+    // Channel memory layout version.
+    //
+    static constexpr uint32_t c_Version = 1u;
+
+    //
+    // Offset of the ring data in the channel memory, past the header.
+    //
+    static constexpr uint64_t c_DataOffset = 4096u;
+
+    //
+    // Minimum ring capacity.
+    //
+    static constexpr uint32_t c_MinRingCapacity = 4096u;
+
+    //
+    // Maximum ring capacity.
+    //
+    static constexpr uint32_t c_MaxRingCapacity = 1u << 30;
+
+    static_assert(sizeof(Layout) <= c_DataOffset, "The channel header must fit before the ring data.");
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Ring positions must be lock free to be shared across processes.");
+
+};
+
+} // namespace gX.
+
+#endif
@@ -0,0 +1,335 @@
+// *************************************
+// Ganymede Xpedia
+// Common
+// 'gXSlabAllocator.cc'
+// Author: jcjuarez
+// *************************************
+
+#include <bit>
+#include <unistd.h>
+#include <limits>
+#include <algorithm>
+#include <sys/mman.h>
+#include "gXSlabAllocator.hh"
+
+namespace gX
+{
+
+SlabAllocator::SlabAllocator()
+    : m_MaxMemorySize(0),
+      m_MemorySize(0),
+      m_Region(nullptr),
+      m_RegionSize(0)
+{
+    for (SizeClass& sizeClass : m_SizeClasses)
+    {
+        sizeClass.m_FreeBlocks = nullptr;
+    }
+}
+
+SlabAllocator::~SlabAllocator()
+{
+    if (m_Region != nullptr)
+    {
+        munmap(m_Region, m_RegionSize);
+    }
+
+    for (void* slab : m_Slabs)
+    {
+        munmap(slab, c_SlabSize);
+    }
+}
+
+StatusCode
+SlabAllocator::Init(
+    const uint64_t p_MaxMemorySize,
+    const bool p_EnableHugePages)
+{
+    m_MaxMemorySize = p_MaxMemorySize;
+
+    if (!p_EnableHugePages)
+    {
+        return Status::Success;
+    }
+
+    if (p_MaxMemorySize == 0)
+    {
+        return Status::InvalidArgument;
+    }
+
+    const size_t regionSize = (p_MaxMemorySize + c_HugePageSize - 1u) / c_HugePageSize * c_HugePageSize;
+
+    //
+    // Explicit huge pages are reserved at mapping time, so the mapping fails rather than faulting later if the
+    // host has too few of them. Fall back to transparent huge pages, pre-faulted by touching every page.
+    //
+    void* region = mmap(nullptr, regionSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+
+    if (region == MAP_FAILED)
+    {
+        region = mmap(nullptr, regionSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (region == MAP_FAILED)
+        {
+            return Status::OutOfMemory;
+        }
+
+        madvise(region, regionSize, MADV_HUGEPAGE);
+
+        const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+        for (size_t offset = 0; offset < regionSize; offset += pageSize)
+        {
+            static_cast<volatile Byte*>(region)[offset] = 0;
+        }
+    }
+
+    try
+    {
+        m_IsRegionSlabTaken.assign(regionSize / c_SlabSize, false);
+    }
+    catch (const std::bad_alloc& e)
+    {
+        munmap(region, regionSize);
+
+        return Status::OutOfMemory;
+    }
+
+    m_Region = static_cast<Byte*>(region);
+    m_RegionSize = regionSize;
+
+    return Status::Success;
+}
+
+void*
+SlabAllocator::Allocate(
+    const size_t p_Size)
+{
+    if (p_Size > c_SlabSize)
+    {
+        if (p_Size > std::numeric_limits<size_t>::max() - c_SlabSize)
+        {
+            return nullptr;
+        }
+
+        //
+        // Large blocks are taken on their own and returned on free, so that a burst of large frames
+        // neither holds on to memory for good nor keeps it from the other classes under the limit.
+        //
+        return TakeMemory(GetBlockSize(p_Size));
+    }
+
+    const uint32_t sizeClassIndex = GetSizeClassIndex(p_Size);
+
+    {
+        SizeClass& sizeClass = m_SizeClasses[sizeClassIndex];
+        std::unique_lock<std::mutex> lock(sizeClass.m_Lock);
+
+        if (sizeClass.m_FreeBlocks != nullptr)
+        {
+            void* block = sizeClass.m_FreeBlocks;
+            sizeClass.m_FreeBlocks = *static_cast<void**>(block);
+
+            return block;
+        }
+    }
+
+    return Refill(sizeClassIndex);
+}
+
+void
+SlabAllocator::Free(
+    void* p_Block,
+    const size_t p_Size)
+{
+    if (p_Block == nullptr)
+    {
+        return;
+    }
+
+    if (p_Size > c_SlabSize)
+    {
+        ReturnMemory(static_cast<Byte*>(p_Block), GetBlockSize(p_Size));
+
+        return;
+    }
+
+    SizeClass& sizeClass = m_SizeClasses[GetSizeClassIndex(p_Size)];
+    std::unique_lock<std::mutex> lock(sizeClass.m_Lock);
+
+    *static_cast<void**>(p_Block) = sizeClass.m_FreeBlocks;
+    sizeClass.m_FreeBlocks = p_Block;
+}
+
+uint64_t
+SlabAllocator::GetMemorySize() const
+{
+    return m_MemorySize.load(std::memory_order_relaxed);
+}
+
+size_t
+SlabAllocator::GetBlockSize(
+    const size_t p_Size)
+{
+    if (p_Size > c_SlabSize)
+    {
+        return (p_Size + c_SlabSize - 1u) / c_SlabSize * c_SlabSize;
+    }
+
+    return size_t(1) << (GetSizeClassIndex(p_Size) + c_MinBlockSizeBits);
+}
+
+uint32_t
+SlabAllocator::GetSizeClassIndex(
+    const size_t p_Size)
+{
+    return static_cast<uint32_t>(std::bit_width((std::max<size_t>(p_Size, 1u) - 1u) >> c_MinBlockSizeBits));
+}
+
+void*
+SlabAllocator::Refill(
+    const uint32_t p_SizeClassIndex)
+{
+    const size_t blockSize = size_t(1) << (p_SizeClassIndex + c_MinBlockSizeBits);
+    Byte* slab = TakeMemory(c_SlabSize);
+
+    if (slab == nullptr)
+    {
+        return nullptr;
+    }
+
+    if (m_Region == nullptr)
+    {
+        try
+        {
+            std::unique_lock<std::mutex> lock(m_SlabLock);
+            m_Slabs.push_back(slab);
+        }
+        catch (const std::bad_alloc& e)
+        {
+            ReturnMemory(slab, c_SlabSize);
+
+            return nullptr;
+        }
+    }
+
+    if (c_SlabSize > blockSize)
+    {
+        //
+        // Keep the first block of the slab for the caller and make the rest available to the class.
+        //
+        SizeClass& sizeClass = m_SizeClasses[p_SizeClassIndex];
+        std::unique_lock<std::mutex> lock(sizeClass.m_Lock);
+
+        for (size_t blockOffset = c_SlabSize - blockSize; blockOffset != 0; blockOffset -= blockSize)
+        {
+            *reinterpret_cast<void**>(slab + blockOffset) = sizeClass.m_FreeBlocks;
+            sizeClass.m_FreeBlocks = slab + blockOffset;
+        }
+    }
+
+    return slab;
+}
+
+Byte*
+SlabAllocator::TakeMemory(
+    const size_t p_Size)
+{
+    if (!ReserveMemory(p_Size))
+    {
+        return nullptr;
+    }
+
+    Byte* memory;
+
+    if (m_Region != nullptr)
+    {
+        memory = TakeRegionMemory(p_Size);
+    }
+    else
+    {
+        //
+        // Mapped directly rather than drawn from the heap, so that the memory goes back to the system on return.
+        //
+        void* mapping = mmap(nullptr, p_Size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        memory = mapping != MAP_FAILED ? static_cast<Byte*>(mapping) : nullptr;
+    }
+
+    if (memory == nullptr)
+    {
+        m_MemorySize.fetch_sub(p_Size, std::memory_order_relaxed);
+    }
+
+    return memory;
+}
+
+void
+SlabAllocator::ReturnMemory(
+    Byte* p_Memory,
+    const size_t p_Size)
+{
+    if (m_Region != nullptr)
+    {
+        const size_t firstSlab = static_cast<size_t>(p_Memory - m_Region) / c_SlabSize;
+        std::unique_lock<std::mutex> lock(m_SlabLock);
+
+        std::fill_n(m_IsRegionSlabTaken.begin() + firstSlab, p_Size / c_SlabSize, false);
+    }
+    else
+    {
+        munmap(p_Memory, p_Size);
+    }
+
+    m_MemorySize.fetch_sub(p_Size, std::memory_order_relaxed);
+}
+
+Byte*
+SlabAllocator::TakeRegionMemory(
+    const size_t p_Size)
+{
+    const size_t numberSlabs = p_Size / c_SlabSize;
+    size_t numberFreeSlabs = 0;
+
+    std::unique_lock<std::mutex> lock(m_SlabLock);
+
+    //
+    // First fit over the slabs of the region. Only slab refills and large blocks get here.
+    //
+    for (size_t slabIndex = 0; slabIndex < m_IsRegionSlabTaken.size(); ++slabIndex)
+    {
+        numberFreeSlabs = m_IsRegionSlabTaken[slabIndex] ? 0 : numberFreeSlabs + 1u;
+
+        if (numberFreeSlabs == numberSlabs)
+        {
+            const size_t firstSlab = slabIndex + 1u - numberSlabs;
+
+            std::fill_n(m_IsRegionSlabTaken.begin() + firstSlab, numberSlabs, true);
+
+            return m_Region + firstSlab * c_SlabSize;
+        }
+    }
+
+    return nullptr;
+}
+
+bool
+SlabAllocator::ReserveMemory(
+    const uint64_t p_Size)
+{
+    uint64_t memorySize = m_MemorySize.load(std::memory_order_relaxed);
+
+    do
+    {
+        if (m_MaxMemorySize != 0 &&
+            p_Size > m_MaxMemorySize - memorySize)
+        {
+            return false;
+        }
+    }
+    while (!m_MemorySize.compare_exchange_weak(memorySize, memorySize + p_Size, std::memory_order_relaxed));
+
+    return true;
+}
+
+} // namespace gX.
@@ -0,0 +1,320 @@
+// *************************************
+// Ganymede Xpedia
+// Common
+// 'gXSlabAllocator.hh'
+// Author: jcjuarez
+// *************************************
+
+#ifndef GX_SLAB_ALLOCATOR_
+#define GX_SLAB_ALLOCATOR_
+
+#include <bit>
+#include <new>
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "gXStatus.hh"
+
+namespace gX
+{
+
+//
+// Thread-safe size-classed slab allocator. Blocks of up to a slab are rounded up to a power-of-two size
+// class and carved out of slabs, and freed blocks are kept on the free list of their class, so that
+// steady-state allocation is a free list pop rather than a system call. Larger blocks are taken on their
+// own and returned as soon as they are freed. Memory comes either from the system or from a region
+// reserved up front on pre-faulted huge pages. The memory taken is bounded by a cap, past which
+// allocations fail instead of driving the host out of memory.
+//
+class SlabAllocator
+{
+
+public:
+
+    //
+    // Constructor.
+    //
+    SlabAllocator();
+
+    //
+    // Destructor. Returns all the memory taken. No block may be in use at this point.
+    //
+    ~SlabAllocator();
+
+    //
+    // Allocators hand out their memory by address; they cannot be copied.
+    //
+    SlabAllocator(
+        const SlabAllocator&) = delete;
+
+    SlabAllocator&
+    operator=(
+        const SlabAllocator&) = delete;
+
+    //
+    // Initializes the allocator with the maximum amount of memory it may take; zero for no limit.
+    // Huge pages reserve and pre-fault the whole amount at once, which must then be bounded.
+    //
+    StatusCode
+    Init(
+        const uint64_t p_MaxMemorySize,
+        const bool p_EnableHugePages);
+
+    //
+    // Allocates a block of at least the specified size, aligned to a cache line.
+    // Returns null if the memory limit was reached or the system is out of memory.
+    //
+    void*
+    Allocate(
+        const size_t p_Size);
+
+    //
+    // Frees a block allocated with the same size.
+    //
+    void
+    Free(
+        void* p_Block,
+        const size_t p_Size);
+
+    //
+    // Returns the amount of memory currently taken: the slabs, including the free blocks kept for reuse,
+    // and the large blocks in use.
+    //
+    uint64_t
+    GetMemorySize() const;
+
+    //
+    // Returns the usable size of the blocks serving allocations of the specified size.
+    //
+    static
+    size_t
+    GetBlockSize(
+        const size_t p_Size);
+
+    //
+    // Alignment of the blocks; a cache line, so that blocks used from different threads do not share one.
+    //
+    static constexpr size_t c_BlockAlignment = 64u;
+
+private:
+
+    //
+    // Free list of a size class.
+    //
+    struct SizeClass
+    {
+
+        //
+        // Exclusive lock for synchronizing access to the free list.
+        //
+        std::mutex m_Lock;
+
+        //
+        // First free block; each free block holds a pointer to the next.
+        //
+        void* m_FreeBlocks;
+
+    };
+
+    //
+    // Returns the size class serving allocations of the specified size.
+    //
+    static
+    uint32_t
+    GetSizeClassIndex(
+        const size_t p_Size);
+
+    //
+    // Takes a slab for a size class, within the memory limit, and places its spare blocks on the free list
+    // of the class. Slabs are kept for the lifetime of the allocator.
+    //
+    void*
+    Refill(
+        const uint32_t p_SizeClassIndex);
+
+    //
+    // Takes memory from the system or the region, within the memory limit. Returns null on failure.
+    //
+    Byte*
+    TakeMemory(
+        const size_t p_Size);
+
+    //
+    // Returns memory taken with the same size to the system or the region, and releases it from the limit.
+    //
+    void
+    ReturnMemory(
+        Byte* p_Memory,
+        const size_t p_Size);
+
+    //
+    // Finds free memory in the region, in whole slabs. Returns null if no free run is large enough.
+    //
+    Byte*
+    TakeRegionMemory(
+        const size_t p_Size);
+
+    //
+    // Reserves memory against the limit. Returns false if the limit would be exceeded.
+    //
+    bool
+    ReserveMemory(
+        const uint64_t p_Size);
+
+    //
+    // Smallest block size, which keeps every block aligned.
+    //
+    static constexpr uint32_t c_MinBlockSizeBits = static_cast<uint32_t>(std::countr_zero(c_BlockAlignment));
+
+    //
+    // Size of the slabs blocks are carved out of. Larger blocks are taken one at a time, in whole slabs.
+    //
+    static constexpr size_t c_SlabSize = 256u * 1024u;
+
+    //
+    // Number of size classes, covering blocks of up to a slab.
+    //
+    static constexpr uint32_t c_NumberSizeClasses = static_cast<uint32_t>(std::bit_width(c_SlabSize)) - c_MinBlockSizeBits;
+
+    //
+    // Size of a huge page, which the region is rounded up to.
+    //
+    static constexpr size_t c_HugePageSize = 2u * 1024u * 1024u;
+
+    //
+    // Maximum amount of memory to take; zero for no limit.
+    //
+    uint64_t m_MaxMemorySize;
+
+    //
+    // Amount of memory currently taken.
+    //
+    std::atomic<uint64_t> m_MemorySize;
+
+    //
+    // Region reserved on huge pages, which all memory is carved out of. Null if the heap is used.
+    //
+    Byte* m_Region;
+
+    //
+    // Size of the region.
+    //
+    size_t m_RegionSize;
+
+    //
+    // Whether each slab-sized unit of the region is taken.
+    //
+    std::vector<bool> m_IsRegionSlabTaken;
+
+    //
+    // Exclusive lock for synchronizing access to the slabs taken from the system and to the region.
+    //
+    std::mutex m_SlabLock;
+
+    //
+    // Slabs taken from the system, returned on destruction.
+    //
+    std::vector<void*> m_Slabs;
+
+    //
+    // Free lists of every size class.
+    //
+    std::array<SizeClass, c_NumberSizeClasses> m_SizeClasses;
+
+};
+
+//
+// Standard allocator drawing from a slab allocator, for containers and shared objects.
+// Throws std::bad_alloc when the slab allocator fails, as standard allocators do.
+//
+template<typename Type>
+class SlabAllocatorAdapter
+{
+
+public:
+
+    using value_type = Type;
+
+    //
+    // Constructor.
+    //
+    explicit
+    SlabAllocatorAdapter(
+        SlabAllocator* p_SlabAllocator)
+        : m_SlabAllocator(p_SlabAllocator)
+    {}
+
+    //
+    // Rebinding constructor.
+    //
+    template<typename OtherType>
+    SlabAllocatorAdapter(
+        const SlabAllocatorAdapter<OtherType>& p_Other)
+        : m_SlabAllocator(p_Other.GetSlabAllocator())
+    {}
+
+    //
+    // Allocates memory for the specified number of objects.
+    //
+    Type*
+    allocate(
+        const size_t p_NumberObjects)
+    {
+        static_assert(alignof(Type) <= SlabAllocator::c_BlockAlignment, "Slab blocks are aligned to a cache line.");
+
+        void* block = m_SlabAllocator->Allocate(p_NumberObjects * sizeof(Type));
+
+        if (block == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+
+        return static_cast<Type*>(block);
+    }
+
+    //
+    // Frees memory allocated for the specified number of objects.
+    //
+    void
+    deallocate(
+        Type* p_Objects,
+        const size_t p_NumberObjects)
+    {
+        m_SlabAllocator->Free(p_Objects, p_NumberObjects * sizeof(Type));
+    }
+
+    //
+    // Returns the slab allocator drawn from.
+    //
+    SlabAllocator*
+    GetSlabAllocator() const
+    {
+        return m_SlabAllocator;
+    }
+
+    //
+    // Adapters are interchangeable when they draw from the same slab allocator.
+    //
+    template<typename OtherType>
+    bool
+    operator==(
+        const SlabAllocatorAdapter<OtherType>& p_Other) const
+    {
+        return m_SlabAllocator == p_Other.GetSlabAllocator();
+    }
+
+private:
+
+    //
+    // Slab allocator drawn from.
+    //
+    SlabAllocator* m_SlabAllocator;
+
+};
+
+} // namespace gX.
+
+#endif
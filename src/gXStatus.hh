@@ -133,6 +133,66 @@ public:
     //
     STATUS_CODE_DEFINITION(UnknownPacketTag, 0x8'0000010);
 
+    //
+    // Event loop creation failed.
+    //
+    STATUS_CODE_DEFINITION(EventLoopCreationFailed, 0x8'0000011);
+
+    //
+    // Registration of a file descriptor into the event loop failed.
+    //
+    STATUS_CODE_DEFINITION(EventLoopRegistrationFailed, 0x8'0000012);
+
+    //
+    // Received frame is malformed (bad magic or unsupported version).
+    //
+    STATUS_CODE_DEFINITION(InvalidFrame, 0x8'0000013);
+
+    //
+    // Received frame exceeds the maximum allowed packet size.
+    //
+    STATUS_CODE_DEFINITION(PacketTooLarge, 0x8'0000014);
+
+    //
+    // Connection to the remote server could not be established.
+    //
+    STATUS_CODE_DEFINITION(ConnectionFailed, 0x8'0000015);
+
+    //
+    // Connection to the remote server was lost while transmitting data.
+    //
+    STATUS_CODE_DEFINITION(ConnectionLost, 0x8'0000016);
+
+    //
+    // Remote server address could not be resolved.
+    //
+    STATUS_CODE_DEFINITION(AddressResolutionFailed, 0x8'0000017);
+
+    //
+    // Server is overloaded and rejected the request without executing it; retry later.
+    //
+    STATUS_CODE_DEFINITION(ServerBusy, 0x8'0000018);
+
+    //
+    // Request was shed without being executed because the server queueing delay stayed above its target.
+    //
+    STATUS_CODE_DEFINITION(Overloaded, 0x8'0000019);
+
+    //
+    // Argument or configuration value is outside of its accepted range.
+    //
+    STATUS_CODE_DEFINITION(InvalidArgument, 0x8'000001A);
+
+    //
+    // Payload of the received frame does not match the checksum it was sent with.
+    //
+    STATUS_CODE_DEFINITION(ChecksumMismatch, 0x8'000001B);
+
+    //
+    // Request was dropped without being executed because its deadline passed while it was queued.
+    //
+    STATUS_CODE_DEFINITION(DeadlineExceeded, 0x8'000001C);
+
 };
 
 } // namespace gX.
@@ -0,0 +1,280 @@
+// *************************************
+// Ganymede Xpedia
+// Common
+// 'gXTask.hh'
+// Author: jcjuarez
+// *************************************
+
+#ifndef GX_TASK_
+#define GX_TASK_
+
+#include <utility>
+#include <optional>
+#include <exception>
+#include <coroutine>
+
+namespace gX
+{
+
+//
+// Lazily started coroutine producing a value of the specified type.
+// A task runs when it is awaited, and the awaiting coroutine is resumed right after it finishes
+// through symmetric transfer, on whichever thread finished it.
+//
+template<typename ResultType>
+class Task
+{
+
+public:
+
+    //
+    // Promise of the coroutine; holds the result and the coroutine to resume once finished.
+    //
+    struct promise_type
+    {
+
+        //
+        // Awaiter run when the coroutine finishes; transfers control to the awaiting coroutine.
+        //
+        struct FinalAwaiter
+        {
+
+            bool
+            await_ready() const noexcept
+            {
+                return false;
+            }
+
+            std::coroutine_handle<>
+            await_suspend(
+                std::coroutine_handle<promise_type> p_Coroutine) noexcept
+            {
+                const std::coroutine_handle<> continuation = p_Coroutine.promise().m_Continuation;
+
+                return continuation ?
+                    continuation :
+                    std::noop_coroutine();
+            }
+
+            void
+            await_resume() const noexcept
+            {}
+
+        };
+
+        Task
+        get_return_object()
+        {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always
+        initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        FinalAwaiter
+        final_suspend() const noexcept
+        {
+            return {};
+        }
+
+        void
+        return_value(
+            ResultType p_Result)
+        {
+            m_Result.emplace(std::move(p_Result));
+        }
+
+        void
+        unhandled_exception()
+        {
+            m_Exception = std::current_exception();
+        }
+
+        //
+        // Result of the coroutine, set once it returns.
+        //
+        std::optional<ResultType> m_Result;
+
+        //
+        // Exception that escaped the coroutine, rethrown to the awaiting coroutine.
+        //
+        std::exception_ptr m_Exception;
+
+        //
+        // Coroutine awaiting this one.
+        //
+        std::coroutine_handle<> m_Continuation;
+
+    };
+
+    //
+    // Constructor. Creates an empty task.
+    //
+    Task()
+        : m_Coroutine(nullptr)
+    {}
+
+    //
+    // Move constructor.
+    //
+    Task(
+        Task&& p_Task) noexcept
+        : m_Coroutine(std::exchange(p_Task.m_Coroutine, nullptr))
+    {}
+
+    //
+    // Move assignment operator.
+    //
+    Task&
+    operator=(
+        Task&& p_Task) noexcept
+    {
+        if (this != &p_Task)
+        {
+            Release();
+            m_Coroutine = std::exchange(p_Task.m_Coroutine, nullptr);
+        }
+
+        return *this;
+    }
+
+    Task(
+        const Task&) = delete;
+
+    Task&
+    operator=(
+        const Task&) = delete;
+
+    //
+    // Destructor. Destroys the coroutine frame.
+    //
+    ~Task()
+    {
+        Release();
+    }
+
+    //
+    // Determines whether the task holds a coroutine.
+    //
+    bool
+    IsValid() const
+    {
+        return static_cast<bool>(m_Coroutine);
+    }
+
+    bool
+    await_ready() const noexcept
+    {
+        return false;
+    }
+
+    //
+    // Starts the task, which resumes the awaiting coroutine once finished.
+    //
+    std::coroutine_handle<>
+    await_suspend(
+        std::coroutine_handle<> p_Continuation) noexcept
+    {
+        m_Coroutine.promise().m_Continuation = p_Continuation;
+
+        return m_Coroutine;
+    }
+
+    ResultType
+    await_resume()
+    {
+        if (m_Coroutine.promise().m_Exception)
+        {
+            std::rethrow_exception(m_Coroutine.promise().m_Exception);
+        }
+
+        return std::move(*m_Coroutine.promise().m_Result);
+    }
+
+private:
+
+    //
+    // Constructor. Takes ownership of the coroutine.
+    //
+    explicit
+    Task(
+        std::coroutine_handle<promise_type> p_Coroutine)
+        : m_Coroutine(p_Coroutine)
+    {}
+
+    //
+    // Destroys the coroutine frame, if any.
+    //
+    void
+    Release()
+    {
+        if (m_Coroutine)
+        {
+            m_Coroutine.destroy();
+            m_Coroutine = nullptr;
+        }
+    }
+
+    //
+    // Coroutine of the task.
+    //
+    std::coroutine_handle<promise_type> m_Coroutine;
+
+};
+
+//
+// Eagerly started coroutine that nobody awaits; its frame is released as soon as it finishes.
+// Used to drive a task to completion from regular code.
+//
+class DetachedTask
+{
+
+public:
+
+    //
+    // Promise of the coroutine.
+    //
+    struct promise_type
+    {
+
+        DetachedTask
+        get_return_object() const noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never
+        initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never
+        final_suspend() const noexcept
+        {
+            return {};
+        }
+
+        void
+        return_void() const noexcept
+        {}
+
+        void
+        unhandled_exception() const noexcept
+        {
+            //
+            // Nobody could observe the exception; fail the same way an exception escaping a thread does.
+            //
+            std::terminate();
+        }
+
+    };
+
+};
+
+} // namespace gX.
+
+#endif
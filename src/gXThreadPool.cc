@@ -5,43 +5,235 @@
 // Author: jcjuarez
 // *************************************
 
+#include <cstdint>
+#include <algorithm>
 #include "gXThreadPool.hh"
+#include "gXCpuTopology.hh"
 #include <iostream> // delete.
 
 namespace gX
 {
 
+thread_local ThreadPool* ThreadPool::t_CurrentThreadPool = nullptr;
+
+thread_local uint16_t ThreadPool::t_CurrentWorkerIndex = 0;
+
+thread_local uint8_t ThreadPool::t_CurrentPriorityClass = 0;
+
+ThreadPoolPriorityClass::ThreadPoolPriorityClass(
+    const uint32_t p_Weight,
+    const uint16_t p_MaxConcurrency)
+    : m_Weight(p_Weight),
+      m_MaxConcurrency(p_MaxConcurrency)
+{}
+
+size_t
+ThreadPoolBatch::GetSize() const
+{
+    return m_Tasks.size();
+}
+
+bool
+ThreadPoolBatch::IsEmpty() const
+{
+    return m_Tasks.empty();
+}
+
+void
+ThreadPoolBatch::Clear()
+{
+    m_Tasks.clear();
+    m_PriorityClasses.clear();
+}
+
 ThreadPool::ThreadPool()
-    : m_Stop(false)
+    : m_PriorityPolicy(ThreadPoolPriorityPolicy::WeightedFair),
+      m_VirtualTime(0),
+      m_NumberThreads(0),
+      m_Scheduler(ThreadPoolScheduler::SharedQueue),
+      m_MaxNumberQueuedTasks(0),
+      m_NumberRejectedTasks(0),
+      m_Stop(false),
+      m_NumberQueuedTasks(0),
+      m_NumberParkedWorkers(0),
+      m_NextWorkerQueueIndex(0),
+      m_NumberStartedWorkers(0),
+      m_StartupStatus(Status::Success)
 {}
 
 StatusCode
 ThreadPool::Init(
-    const uint16_t p_NumberThreads)
+    const uint16_t p_NumberThreads,
+    const ThreadPoolScheduler p_Scheduler,
+    const uint32_t p_MaxNumberQueuedTasks,
+    const std::vector<ThreadPoolPriorityClass>& p_PriorityClasses,
+    const ThreadPoolPriorityPolicy p_PriorityPolicy,
+    const std::vector<uint16_t>& p_WorkerCpus)
 {
+    if (p_PriorityClasses.size() > c_MaxNumberPriorityClasses)
+    {
+        return Status::InvalidArgument;
+    }
+
+    for (const uint16_t cpu : p_WorkerCpus)
+    {
+        if (!CpuTopology::IsCpuAvailable(cpu))
+        {
+            return Status::InvalidArgument;
+        }
+    }
+
     m_NumberThreads = p_NumberThreads;
+    m_Scheduler = p_Scheduler;
+    m_MaxNumberQueuedTasks = p_MaxNumberQueuedTasks;
+    m_PriorityPolicy = p_PriorityPolicy;
+
+    StatusCode status = Status::Success;
 
     //
     // Spawn threads for the thread pool.
     //
     try
     {
+        //
+        // Without explicit priority classes all tasks share a single unlimited class.
+        //
+        const std::vector<ThreadPoolPriorityClass> priorityClasses = p_PriorityClasses.empty() ?
+            std::vector<ThreadPoolPriorityClass>(1u) :
+            p_PriorityClasses;
+
+        for (const ThreadPoolPriorityClass& priorityClass : priorityClasses)
+        {
+            std::unique_ptr<PriorityClassState> priorityClassState = std::make_unique<PriorityClassState>();
+            priorityClassState->m_Stride = c_StrideScale / std::max(1u, priorityClass.m_Weight);
+            priorityClassState->m_MaxConcurrency = priorityClass.m_MaxConcurrency;
+            priorityClassState->m_NumberQueuedTasks = 0;
+            priorityClassState->m_NumberRunningTasks = 0;
+
+            m_PriorityClasses.emplace_back(std::move(priorityClassState));
+        }
+
+        m_Passes.assign(m_PriorityClasses.size(), 0u);
+
+        //
+        // Order the CPUs by node and hand each worker a slot of the ordered list, so that consecutive workers
+        // share a node and every node gets workers in proportion to its CPUs. Workers are pinned to all the
+        // specified CPUs of their node, leaving the kernel free to balance them within it.
+        //
+        std::vector<uint16_t> workerCpus = p_WorkerCpus;
+
+        std::stable_sort(workerCpus.begin(), workerCpus.end(),
+            [](const uint16_t p_FirstCpu, const uint16_t p_SecondCpu)
+            {
+                return CpuTopology::GetNumaNode(p_FirstCpu) < CpuTopology::GetNumaNode(p_SecondCpu);
+            });
+
+        m_WorkerCpus.resize(m_NumberThreads);
+        m_WorkerNumaNodes.assign(m_NumberThreads, 0u);
+
         for (uint16_t threadIndex = 0; threadIndex < m_NumberThreads; ++threadIndex)
         {
-            m_WorkerThreads.emplace_back(&ThreadPool::TaskHandler, this);
+            m_Workers.push_back(threadIndex);
+
+            if (workerCpus.empty())
+            {
+                continue;
+            }
+
+            const uint16_t numaNode = CpuTopology::GetNumaNode(workerCpus[static_cast<size_t>(threadIndex) * workerCpus.size() / m_NumberThreads]);
+
+            for (const uint16_t cpu : workerCpus)
+            {
+                if (CpuTopology::GetNumaNode(cpu) == numaNode)
+                {
+                    m_WorkerCpus[threadIndex].push_back(cpu);
+                }
+            }
+
+            m_WorkerNumaNodes[threadIndex] = numaNode;
+        }
+
+        //
+        // Locality only matters once the workers span several nodes.
+        //
+        const auto [firstNumaNode, lastNumaNode] = std::minmax_element(m_WorkerNumaNodes.begin(), m_WorkerNumaNodes.end());
+
+        if (firstNumaNode != m_WorkerNumaNodes.end() &&
+            *firstNumaNode != *lastNumaNode)
+        {
+            m_NumaNodeWorkers.resize(*lastNumaNode + 1u);
+
+            for (uint16_t threadIndex = 0; threadIndex < m_NumberThreads; ++threadIndex)
+            {
+                m_NumaNodeWorkers[m_WorkerNumaNodes[threadIndex]].push_back(threadIndex);
+            }
+        }
+
+        //
+        // Each worker fills in its own queue slot; all queues exist before any worker starts stealing.
+        //
+        if (m_Scheduler == ThreadPoolScheduler::WorkStealing)
+        {
+            m_WorkerQueues.resize(m_NumberThreads);
+        }
+
+        for (uint16_t threadIndex = 0; threadIndex < m_NumberThreads; ++threadIndex)
+        {
+            if (m_Scheduler == ThreadPoolScheduler::WorkStealing)
+            {
+                m_WorkerThreads.emplace_back(&ThreadPool::WorkStealingTaskHandler, this, threadIndex);
+            }
+            else
+            {
+                m_WorkerThreads.emplace_back(&ThreadPool::TaskHandler, this, threadIndex);
+            }
 
             if (!m_WorkerThreads.back().joinable())
             {
-                return Status::ThreadLaunchFailed;
+                status = Status::ThreadLaunchFailed;
+
+                break;
             }
         }
     }
     catch (const std::system_error& exception)
     {
-        return Status::ThreadLaunchFailed;
+        status = Status::ThreadLaunchFailed;
+    }
+    catch (const std::bad_alloc& exception)
+    {
+        status = Status::OutOfMemory;
     }
 
-    return Status::Success;
+    {
+        std::unique_lock<std::mutex> lock(m_Lock);
+
+        if (Status::Succeeded(status))
+        {
+            m_Condition.wait(lock,
+                [this]
+                {
+                    return this->m_NumberStartedWorkers == this->m_NumberThreads;
+                });
+
+            status = m_StartupStatus;
+        }
+
+        if (Status::Failed(status))
+        {
+            //
+            // Release the workers already spawned and refuse any submission.
+            //
+            m_Stop = true;
+        }
+    }
+
+    if (Status::Failed(status))
+    {
+        m_Condition.notify_all();
+    }
+
+    return status;
 }
 
 ThreadPool::~ThreadPool()
@@ -60,6 +252,26 @@ ThreadPool::~ThreadPool()
     {
         worker_thread.join();
     }
+
+    //
+    // A task submitted concurrently with the stop request can land in a worker queue after its
+    // owner exited; execute any such leftover so that no future is left unsatisfied.
+    //
+    for (std::unique_ptr<WorkerQueue>& workerQueue : m_WorkerQueues)
+    {
+        if (!workerQueue)
+        {
+            continue;
+        }
+
+        for (std::deque<InlineTask>& tasks : workerQueue->m_Tasks)
+        {
+            for (InlineTask& task : tasks)
+            {
+                task();
+            }
+        }
+    }
 }
 
 uint16_t
@@ -68,12 +280,461 @@ ThreadPool::GetNumberThreads() const
     return m_NumberThreads;
 }
 
+uint8_t
+ThreadPool::GetCurrentPriorityClass() const
+{
+    return t_CurrentThreadPool == this ?
+        t_CurrentPriorityClass :
+        0u;
+}
+
+uint8_t
+ThreadPool::GetNumberPriorityClasses() const
+{
+    return static_cast<uint8_t>(m_PriorityClasses.size());
+}
+
+uint64_t
+ThreadPool::GetNumberRejectedTasks() const
+{
+    return m_NumberRejectedTasks.load(std::memory_order_relaxed);
+}
+
+uint16_t
+ThreadPool::GetCurrentWorkerIndex() const
+{
+    return t_CurrentThreadPool == this ?
+        t_CurrentWorkerIndex :
+        m_NumberThreads;
+}
+
+StatusCode
+ThreadPool::Schedule(
+    InlineTask&& p_Task,
+    const uint8_t p_PriorityClass)
+{
+    if (p_PriorityClass >= m_PriorityClasses.size())
+    {
+        return Status::InvalidArgument;
+    }
+
+    PriorityClassState& priorityClass = *m_PriorityClasses[p_PriorityClass];
+
+    if (m_Scheduler == ThreadPoolScheduler::SharedQueue)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_Lock);
+
+            if (m_Stop)
+            {
+                return Status::ServiceIsStopped;
+            }
+
+            if (m_MaxNumberQueuedTasks != 0 &&
+                m_NumberQueuedTasks.load(std::memory_order_relaxed) >= m_MaxNumberQueuedTasks)
+            {
+                m_NumberRejectedTasks.fetch_add(1, std::memory_order_relaxed);
+
+                return Status::ServerBusy;
+            }
+
+            priorityClass.m_Tasks.emplace(std::move(p_Task));
+            priorityClass.m_NumberQueuedTasks.fetch_add(1, std::memory_order_relaxed);
+            m_NumberQueuedTasks.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        //
+        // Notify the task handler of a new task to be executed.
+        //
+        m_Condition.notify_one();
+
+        return Status::Success;
+    }
+
+    if (m_Stop || m_WorkerQueues.empty())
+    {
+        return Status::ServiceIsStopped;
+    }
+
+    //
+    // Tasks submitted from a worker of this pool stay on its local queue for cache locality;
+    // external submissions are spread across the workers of their node in round-robin order.
+    //
+    uint16_t workerIndex = t_CurrentWorkerIndex;
+
+    if (t_CurrentThreadPool != this)
+    {
+        const std::vector<uint16_t>& submissionWorkers = GetSubmissionWorkers();
+
+        workerIndex = submissionWorkers[m_NextWorkerQueueIndex.fetch_add(1, std::memory_order_relaxed) % submissionWorkers.size()];
+    }
+
+    WorkerQueue& workerQueue = *m_WorkerQueues[workerIndex];
+
+    //
+    // Publishing the task before checking for parked workers pairs with workers registering as
+    // parked before re-checking for tasks, so either side always observes the other.
+    // The counters are raised first so that they never drop below the number of queued tasks.
+    //
+    const uint64_t numberQueuedTasks = m_NumberQueuedTasks.fetch_add(1, std::memory_order_seq_cst);
+
+    if (m_MaxNumberQueuedTasks != 0 &&
+        numberQueuedTasks >= m_MaxNumberQueuedTasks)
+    {
+        //
+        // Queue is full; take the reservation back. The counter may transiently exceed the
+        // capacity, which at worst makes an idle worker look for a task that is not there.
+        //
+        m_NumberQueuedTasks.fetch_sub(1, std::memory_order_relaxed);
+        m_NumberRejectedTasks.fetch_add(1, std::memory_order_relaxed);
+
+        return Status::ServerBusy;
+    }
+
+    priorityClass.m_NumberQueuedTasks.fetch_add(1, std::memory_order_seq_cst);
+
+    {
+        std::unique_lock<std::mutex> lock(workerQueue.m_Lock);
+        workerQueue.m_Tasks[p_PriorityClass].emplace_back(std::move(p_Task));
+    }
+
+    if (m_NumberParkedWorkers.load(std::memory_order_seq_cst) != 0)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_Lock);
+        }
+
+        m_Condition.notify_one();
+    }
+
+    return Status::Success;
+}
+
+StatusCode
+ThreadPool::EnqueueBatch(
+    ThreadPoolBatch& p_Batch,
+    size_t& p_NumberEnqueuedTasks)
+{
+    p_NumberEnqueuedTasks = 0;
+
+    const size_t numberTasks = p_Batch.m_Tasks.size();
+
+    if (numberTasks == 0)
+    {
+        return Status::Success;
+    }
+
+    for (const uint8_t priorityClass : p_Batch.m_PriorityClasses)
+    {
+        if (priorityClass >= m_PriorityClasses.size())
+        {
+            return Status::InvalidArgument;
+        }
+    }
+
+    size_t numberAcceptedTasks = numberTasks;
+
+    if (m_Scheduler == ThreadPoolScheduler::SharedQueue)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_Lock);
+
+            if (m_Stop)
+            {
+                return Status::ServiceIsStopped;
+            }
+
+            if (m_MaxNumberQueuedTasks != 0)
+            {
+                const uint64_t numberQueuedTasks = m_NumberQueuedTasks.load(std::memory_order_relaxed);
+
+                numberAcceptedTasks = numberQueuedTasks >= m_MaxNumberQueuedTasks ?
+                    0u :
+                    std::min<uint64_t>(numberTasks, m_MaxNumberQueuedTasks - numberQueuedTasks);
+            }
+
+            for (size_t taskIndex = 0; taskIndex < numberAcceptedTasks; ++taskIndex)
+            {
+                PriorityClassState& priorityClass = *m_PriorityClasses[p_Batch.m_PriorityClasses[taskIndex]];
+
+                priorityClass.m_Tasks.emplace(std::move(p_Batch.m_Tasks[taskIndex]));
+                priorityClass.m_NumberQueuedTasks.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            m_NumberQueuedTasks.fetch_add(numberAcceptedTasks, std::memory_order_relaxed);
+        }
+
+        //
+        // One worker per task; beyond the number of threads every worker is needed anyway.
+        //
+        if (numberAcceptedTasks >= m_NumberThreads)
+        {
+            m_Condition.notify_all();
+        }
+        else
+        {
+            for (size_t taskIndex = 0; taskIndex < numberAcceptedTasks; ++taskIndex)
+            {
+                m_Condition.notify_one();
+            }
+        }
+    }
+    else
+    {
+        if (m_Stop || m_WorkerQueues.empty())
+        {
+            return Status::ServiceIsStopped;
+        }
+
+        //
+        // Reserve room for the whole batch at once and give back whatever does not fit, following the
+        // same publication order as single submissions.
+        //
+        const uint64_t numberQueuedTasks = m_NumberQueuedTasks.fetch_add(numberTasks, std::memory_order_seq_cst);
+
+        if (m_MaxNumberQueuedTasks != 0 &&
+            numberQueuedTasks + numberTasks > m_MaxNumberQueuedTasks)
+        {
+            numberAcceptedTasks = numberQueuedTasks >= m_MaxNumberQueuedTasks ?
+                0u :
+                static_cast<size_t>(m_MaxNumberQueuedTasks - numberQueuedTasks);
+
+            m_NumberQueuedTasks.fetch_sub(numberTasks - numberAcceptedTasks, std::memory_order_relaxed);
+        }
+
+        for (size_t taskIndex = 0; taskIndex < numberAcceptedTasks; ++taskIndex)
+        {
+            m_PriorityClasses[p_Batch.m_PriorityClasses[taskIndex]]->m_NumberQueuedTasks.fetch_add(1, std::memory_order_seq_cst);
+        }
+
+        //
+        // A worker keeps the whole batch on its local queue. External submissions split it into contiguous
+        // runs over as many consecutive queues of their node as there are tasks, taking each queue lock once.
+        //
+        const bool isWorkerThread = t_CurrentThreadPool == this;
+        const std::vector<uint16_t>& submissionWorkers = isWorkerThread ?
+            m_Workers :
+            GetSubmissionWorkers();
+        const size_t numberTargetQueues = isWorkerThread ?
+            1u :
+            std::min(numberAcceptedTasks, submissionWorkers.size());
+        const size_t firstQueueIndex = isWorkerThread ?
+            t_CurrentWorkerIndex :
+            m_NextWorkerQueueIndex.fetch_add(static_cast<uint32_t>(numberTargetQueues), std::memory_order_relaxed);
+        size_t taskIndex = 0;
+
+        for (size_t targetIndex = 0; targetIndex < numberTargetQueues; ++targetIndex)
+        {
+            WorkerQueue& workerQueue = *m_WorkerQueues[submissionWorkers[(firstQueueIndex + targetIndex) % submissionWorkers.size()]];
+            const size_t lastTaskIndex = numberAcceptedTasks * (targetIndex + 1u) / numberTargetQueues;
+
+            std::unique_lock<std::mutex> lock(workerQueue.m_Lock);
+
+            for (; taskIndex < lastTaskIndex; ++taskIndex)
+            {
+                workerQueue.m_Tasks[p_Batch.m_PriorityClasses[taskIndex]].emplace_back(std::move(p_Batch.m_Tasks[taskIndex]));
+            }
+        }
+
+        const size_t numberWakeups = std::min<size_t>(numberAcceptedTasks, m_NumberParkedWorkers.load(std::memory_order_seq_cst));
+
+        if (numberWakeups != 0)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_Lock);
+            }
+
+            for (size_t wakeupIndex = 0; wakeupIndex < numberWakeups; ++wakeupIndex)
+            {
+                m_Condition.notify_one();
+            }
+        }
+    }
+
+    p_NumberEnqueuedTasks = numberAcceptedTasks;
+
+    if (numberAcceptedTasks < numberTasks)
+    {
+        m_NumberRejectedTasks.fetch_add(numberTasks - numberAcceptedTasks, std::memory_order_relaxed);
+
+        return Status::ServerBusy;
+    }
+
+    return Status::Success;
+}
+
+uint8_t
+ThreadPool::SelectPriorityClass(
+    const std::vector<uint64_t>& p_Passes,
+    const uint64_t p_VirtualTime,
+    const uint64_t p_ExcludedPriorityClasses) const
+{
+    const uint8_t numberPriorityClasses = static_cast<uint8_t>(m_PriorityClasses.size());
+    uint8_t selectedPriorityClass = numberPriorityClasses;
+    uint64_t selectedPass = UINT64_MAX;
+
+    for (uint8_t priorityClassIndex = 0; priorityClassIndex < numberPriorityClasses; ++priorityClassIndex)
+    {
+        const PriorityClassState& priorityClass = *m_PriorityClasses[priorityClassIndex];
+
+        if ((p_ExcludedPriorityClasses & (1ull << priorityClassIndex)) != 0 ||
+            priorityClass.m_NumberQueuedTasks.load(std::memory_order_relaxed) == 0 ||
+            (priorityClass.m_MaxConcurrency != 0 &&
+             priorityClass.m_NumberRunningTasks.load(std::memory_order_relaxed) >= priorityClass.m_MaxConcurrency))
+        {
+            continue;
+        }
+
+        if (m_PriorityPolicy == ThreadPoolPriorityPolicy::StrictPriority)
+        {
+            return priorityClassIndex;
+        }
+
+        //
+        // A class that was idle resumes at the current virtual time rather than with the credit it
+        // would have accumulated, so that it cannot monopolize the workers once it becomes busy.
+        //
+        const uint64_t pass = std::max(p_Passes[priorityClassIndex], p_VirtualTime);
+
+        if (pass < selectedPass)
+        {
+            selectedPriorityClass = priorityClassIndex;
+            selectedPass = pass;
+        }
+    }
+
+    return selectedPriorityClass;
+}
+
+void
+ThreadPool::ChargePriorityClass(
+    std::vector<uint64_t>& p_Passes,
+    uint64_t& p_VirtualTime,
+    const uint8_t p_PriorityClass) const
+{
+    const uint64_t pass = std::max(p_Passes[p_PriorityClass], p_VirtualTime);
+
+    p_VirtualTime = pass;
+    p_Passes[p_PriorityClass] = pass + m_PriorityClasses[p_PriorityClass]->m_Stride;
+}
+
+bool
+ThreadPool::TryAcquireExecutionSlot(
+    PriorityClassState& p_PriorityClass)
+{
+    if (p_PriorityClass.m_MaxConcurrency == 0)
+    {
+        return true;
+    }
+
+    uint16_t numberRunningTasks = p_PriorityClass.m_NumberRunningTasks.load(std::memory_order_relaxed);
+
+    do
+    {
+        if (numberRunningTasks >= p_PriorityClass.m_MaxConcurrency)
+        {
+            return false;
+        }
+    }
+    while (!p_PriorityClass.m_NumberRunningTasks.compare_exchange_weak(numberRunningTasks, numberRunningTasks + 1u, std::memory_order_seq_cst));
+
+    return true;
+}
+
 void
-ThreadPool::TaskHandler()
+ThreadPool::ReleaseExecutionSlot(
+    PriorityClassState& p_PriorityClass)
 {
+    if (p_PriorityClass.m_MaxConcurrency == 0)
+    {
+        return;
+    }
+
+    p_PriorityClass.m_NumberRunningTasks.fetch_sub(1, std::memory_order_seq_cst);
+
+    //
+    // Tasks of the class may have been left queued while it was at its limit, with every idle worker
+    // parked; the lock is taken so that the wakeup cannot slip in between a worker's check and its wait.
+    //
+    if (p_PriorityClass.m_NumberQueuedTasks.load(std::memory_order_seq_cst) != 0 &&
+        (m_Scheduler == ThreadPoolScheduler::SharedQueue ||
+         m_NumberParkedWorkers.load(std::memory_order_seq_cst) != 0))
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_Lock);
+        }
+
+        m_Condition.notify_one();
+    }
+}
+
+bool
+ThreadPool::HasRunnableTasks() const
+{
+    for (const std::unique_ptr<PriorityClassState>& priorityClass : m_PriorityClasses)
+    {
+        if (priorityClass->m_NumberQueuedTasks.load(std::memory_order_seq_cst) != 0 &&
+            (priorityClass->m_MaxConcurrency == 0 ||
+             priorityClass->m_NumberRunningTasks.load(std::memory_order_seq_cst) < priorityClass->m_MaxConcurrency))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+uint8_t
+ThreadPool::DequeueSharedTask(
+    InlineTask& p_Task)
+{
+    uint64_t excludedPriorityClasses = 0;
+
     FOREVER
     {
-        std::function<void()> task;
+        const uint8_t priorityClassIndex = SelectPriorityClass(m_Passes, m_VirtualTime, excludedPriorityClasses);
+
+        if (priorityClassIndex == m_PriorityClasses.size())
+        {
+            return priorityClassIndex;
+        }
+
+        PriorityClassState& priorityClass = *m_PriorityClasses[priorityClassIndex];
+
+        if (!TryAcquireExecutionSlot(priorityClass))
+        {
+            excludedPriorityClasses |= 1ull << priorityClassIndex;
+
+            continue;
+        }
+
+        //
+        //  Retrieve and move task from the queue for non-blocking execution.
+        //
+        p_Task = std::move(priorityClass.m_Tasks.front());
+        priorityClass.m_Tasks.pop();
+        priorityClass.m_NumberQueuedTasks.fetch_sub(1, std::memory_order_relaxed);
+        m_NumberQueuedTasks.fetch_sub(1, std::memory_order_relaxed);
+
+        ChargePriorityClass(m_Passes, m_VirtualTime, priorityClassIndex);
+
+        return priorityClassIndex;
+    }
+}
+
+void
+ThreadPool::TaskHandler(
+    const uint16_t p_WorkerIndex)
+{
+    if (!StartWorker(p_WorkerIndex))
+    {
+        return;
+    }
+
+    FOREVER
+    {
+        InlineTask task;
+        uint8_t priorityClassIndex;
 
         {
             std::unique_lock<std::mutex> lock(m_Lock);
@@ -81,27 +742,268 @@ ThreadPool::TaskHandler()
             m_Condition.wait(lock,
                 [this]
                 {
-                    return this->m_Stop || !this->m_Tasks.empty();
+                    return this->m_Stop || this->HasRunnableTasks();
                 });
 
             //
             // If the destructor has been invoked, wait for finishing all pending 
             // tasks and then terminate the invoked thread.
             //
-            if (m_Stop && m_Tasks.empty())
+            if (m_Stop && m_NumberQueuedTasks == 0)
             {
                 return;
             }
 
+            priorityClassIndex = DequeueSharedTask(task);
+        }
+
+        if (priorityClassIndex == m_PriorityClasses.size())
+        {
             //
-            //  Retrieve and move task from the queue for non-blocking execution.
+            // Only possible while stopping, with the remaining tasks held back by their concurrency limits.
             //
-            task = std::move(m_Tasks.front());
-            m_Tasks.pop();
+            std::this_thread::yield();
+
+            continue;
         }
 
+        t_CurrentPriorityClass = priorityClassIndex;
         task();
+
+        ReleaseExecutionSlot(*m_PriorityClasses[priorityClassIndex]);
     }      
 }
 
-} // namespace gX.
\ No newline at end of file
+void
+ThreadPool::WorkStealingTaskHandler(
+    const uint16_t p_WorkerIndex)
+{
+    if (!StartWorker(p_WorkerIndex))
+    {
+        return;
+    }
+
+    const uint8_t numberPriorityClasses = static_cast<uint8_t>(m_PriorityClasses.size());
+
+    FOREVER
+    {
+        InlineTask task;
+        uint8_t priorityClassIndex = numberPriorityClasses;
+
+        //
+        // Spin for a while before parking; under load a new task usually shows up
+        // sooner than the cost of a sleep and wakeup cycle.
+        //
+        for (uint32_t spinIteration = 0; spinIteration < c_NumberSpinIterations && priorityClassIndex == numberPriorityClasses; ++spinIteration)
+        {
+            priorityClassIndex = TryDequeueTask(p_WorkerIndex, task);
+
+            if (priorityClassIndex == numberPriorityClasses)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        if (priorityClassIndex != numberPriorityClasses)
+        {
+            t_CurrentPriorityClass = priorityClassIndex;
+            task();
+
+            ReleaseExecutionSlot(*m_PriorityClasses[priorityClassIndex]);
+
+            continue;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(m_Lock);
+
+            m_NumberParkedWorkers.fetch_add(1, std::memory_order_seq_cst);
+
+            m_Condition.wait(lock,
+                [this]
+                {
+                    return this->m_Stop || this->HasRunnableTasks();
+                });
+
+            m_NumberParkedWorkers.fetch_sub(1, std::memory_order_relaxed);
+
+            //
+            // If the destructor has been invoked, wait for finishing all pending 
+            // tasks and then terminate the invoked thread.
+            //
+            if (m_Stop && m_NumberQueuedTasks == 0)
+            {
+                return;
+            }
+        }
+    }
+}
+
+bool
+ThreadPool::StartWorker(
+    const uint16_t p_WorkerIndex)
+{
+    t_CurrentThreadPool = this;
+    t_CurrentWorkerIndex = p_WorkerIndex;
+
+    StatusCode status = Status::Success;
+
+    if (!m_WorkerCpus[p_WorkerIndex].empty())
+    {
+        status = CpuTopology::PinCurrentThread(m_WorkerCpus[p_WorkerIndex]);
+    }
+
+    if (Status::Succeeded(status) &&
+        m_Scheduler == ThreadPoolScheduler::WorkStealing)
+    {
+        //
+        // Set up the queue from the pinned worker so that its memory is first touched on the worker node.
+        //
+        try
+        {
+            std::unique_ptr<WorkerQueue> workerQueue = std::make_unique<WorkerQueue>();
+            workerQueue->m_Tasks.resize(m_PriorityClasses.size());
+            workerQueue->m_Passes.assign(m_PriorityClasses.size(), 0u);
+            workerQueue->m_VirtualTime = 0;
+
+            //
+            // Walk the workers in round-robin order from this one, moving those on other nodes to the end.
+            //
+            for (uint16_t workerOffset = 0; workerOffset < m_NumberThreads; ++workerOffset)
+            {
+                workerQueue->m_Peers.push_back(static_cast<uint16_t>((p_WorkerIndex + workerOffset) % m_NumberThreads));
+            }
+
+            std::stable_partition(workerQueue->m_Peers.begin(), workerQueue->m_Peers.end(),
+                [this, p_WorkerIndex](const uint16_t p_PeerIndex)
+                {
+                    return m_WorkerNumaNodes[p_PeerIndex] == m_WorkerNumaNodes[p_WorkerIndex];
+                });
+
+            m_WorkerQueues[p_WorkerIndex] = std::move(workerQueue);
+        }
+        catch (const std::bad_alloc& exception)
+        {
+            status = Status::OutOfMemory;
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(m_Lock);
+
+    if (Status::Failed(status) &&
+        Status::Succeeded(m_StartupStatus))
+    {
+        m_StartupStatus = status;
+    }
+
+    ++m_NumberStartedWorkers;
+    m_Condition.notify_all();
+
+    m_Condition.wait(lock,
+        [this]
+        {
+            return this->m_Stop || this->m_NumberStartedWorkers == this->m_NumberThreads;
+        });
+
+    return m_NumberStartedWorkers == m_NumberThreads &&
+        Status::Succeeded(m_StartupStatus);
+}
+
+const std::vector<uint16_t>&
+ThreadPool::GetSubmissionWorkers() const
+{
+    if (m_NumaNodeWorkers.empty())
+    {
+        return m_Workers;
+    }
+
+    const uint16_t numaNode = CpuTopology::GetCurrentNumaNode();
+
+    return numaNode < m_NumaNodeWorkers.size() && !m_NumaNodeWorkers[numaNode].empty() ?
+        m_NumaNodeWorkers[numaNode] :
+        m_Workers;
+}
+
+uint8_t
+ThreadPool::TryDequeueTask(
+    const uint16_t p_WorkerIndex,
+    InlineTask& p_Task)
+{
+    const uint8_t numberPriorityClasses = static_cast<uint8_t>(m_PriorityClasses.size());
+
+    if (m_NumberQueuedTasks.load(std::memory_order_relaxed) == 0)
+    {
+        return numberPriorityClasses;
+    }
+
+    WorkerQueue& localQueue = *m_WorkerQueues[p_WorkerIndex];
+    const size_t numberPeers = localQueue.m_Peers.size();
+    uint64_t excludedPriorityClasses = 0;
+
+    //
+    // Each worker keeps its own passes, so weighted fairness holds per worker and thus across the pool.
+    //
+    FOREVER
+    {
+        const uint8_t priorityClassIndex = SelectPriorityClass(localQueue.m_Passes, localQueue.m_VirtualTime, excludedPriorityClasses);
+
+        if (priorityClassIndex == numberPriorityClasses)
+        {
+            return numberPriorityClasses;
+        }
+
+        excludedPriorityClasses |= 1ull << priorityClassIndex;
+
+        PriorityClassState& priorityClass = *m_PriorityClasses[priorityClassIndex];
+
+        if (!TryAcquireExecutionSlot(priorityClass))
+        {
+            continue;
+        }
+
+        //
+        // Start at the local queue and then walk the peers, skipping queues locked by someone else.
+        // The local queue is always waited for since only thieves compete for it.
+        //
+        for (size_t peerOffset = 0; peerOffset < numberPeers; ++peerOffset)
+        {
+            WorkerQueue& workerQueue = *m_WorkerQueues[localQueue.m_Peers[peerOffset]];
+            std::unique_lock<std::mutex> lock(workerQueue.m_Lock, std::defer_lock);
+
+            if (peerOffset == 0)
+            {
+                lock.lock();
+            }
+            else if (!lock.try_lock())
+            {
+                continue;
+            }
+
+            std::deque<InlineTask>& tasks = workerQueue.m_Tasks[priorityClassIndex];
+
+            if (tasks.empty())
+            {
+                continue;
+            }
+
+            p_Task = std::move(tasks.front());
+            tasks.pop_front();
+            priorityClass.m_NumberQueuedTasks.fetch_sub(1, std::memory_order_relaxed);
+            m_NumberQueuedTasks.fetch_sub(1, std::memory_order_relaxed);
+
+            ChargePriorityClass(localQueue.m_Passes, localQueue.m_VirtualTime, priorityClassIndex);
+
+            return priorityClassIndex;
+        }
+
+        //
+        // Nothing of the class could be taken right now; give the slot back and try the next class.
+        //
+        if (priorityClass.m_MaxConcurrency != 0)
+        {
+            priorityClass.m_NumberRunningTasks.fetch_sub(1, std::memory_order_seq_cst);
+        }
+    }
+}
+
+} // namespace gX.
@@ -8,6 +8,7 @@
 #ifndef GX_THREAD_POOL_
 #define GX_THREAD_POOL_
 
+#include <deque>
 #include <queue>
 #include <mutex>
 #include <atomic>
@@ -18,11 +19,145 @@
 #include <optional>
 #include <functional>
 #include "gXStatus.hh"
+#include "gXInlineTask.hh"
 #include <condition_variable>
 
 namespace gX
 {
 
+//
+// Scheduling policies supported by the thread pool.
+//
+enum class ThreadPoolScheduler : uint8_t
+{
+
+    //
+    // Single FIFO queue shared by all workers under one lock.
+    //
+    SharedQueue,
+
+    //
+    // Per-worker queues. Idle workers steal from their peers, spinning for a while before parking.
+    //
+    WorkStealing
+
+};
+
+//
+// Policies for choosing which priority class a worker serves next.
+//
+enum class ThreadPoolPriorityPolicy : uint8_t
+{
+
+    //
+    // Always serve the lowest-indexed class with runnable tasks. Lower classes can starve higher ones.
+    //
+    StrictPriority,
+
+    //
+    // Serve classes in proportion to their weights (stride scheduling), so that no class starves.
+    //
+    WeightedFair
+
+};
+
+//
+// Configuration of a priority class of the thread pool.
+//
+struct ThreadPoolPriorityClass
+{
+
+    //
+    // Constructor.
+    //
+    ThreadPoolPriorityClass(
+        const uint32_t p_Weight = c_DefaultWeight,
+        const uint16_t p_MaxConcurrency = c_DefaultMaxConcurrency);
+
+    //
+    // Relative share of the workers the class gets under weighted fair scheduling.
+    //
+    uint32_t m_Weight;
+
+    //
+    // Maximum number of tasks of the class executed at the same time. Zero means unlimited.
+    //
+    uint16_t m_MaxConcurrency;
+
+    //
+    // Default weight.
+    //
+    static constexpr uint32_t c_DefaultWeight = 1u;
+
+    //
+    // Default maximum concurrency.
+    //
+    static constexpr uint16_t c_DefaultMaxConcurrency = 0u;
+
+};
+
+//
+// Tasks gathered for submission to a thread pool in one go.
+// The batch keeps its storage across submissions, so reusing it does not allocate once warmed up.
+//
+class ThreadPoolBatch
+{
+
+public:
+
+    //
+    // Adds a fire-and-forget task for the specified priority class to the batch.
+    // The function and its arguments are stored inline in the task, as with ThreadPool::Post.
+    //
+    template<typename Function, typename... Args>
+    void
+    Add(
+        const uint8_t p_PriorityClass,
+        Function&& p_Function, Args&&... p_args)
+    {
+        m_Tasks.emplace_back(
+            [function = std::forward<Function>(p_Function), ...args = std::forward<Args>(p_args)]() mutable
+            {
+                std::invoke(function, args...);
+            });
+
+        m_PriorityClasses.push_back(p_PriorityClass);
+    }
+
+    //
+    // Returns the number of tasks in the batch.
+    //
+    size_t
+    GetSize() const;
+
+    //
+    // Determines whether the batch holds no tasks.
+    //
+    bool
+    IsEmpty() const;
+
+    //
+    // Removes all the tasks from the batch, destroying those that were not enqueued.
+    //
+    void
+    Clear();
+
+private:
+
+    friend class ThreadPool;
+
+    //
+    // Tasks of the batch, in submission order.
+    //
+    std::vector<InlineTask> m_Tasks;
+
+    //
+    // Priority class of each task.
+    //
+    std::vector<uint8_t> m_PriorityClasses;
+
+};
+
 //
 // Thread pool class for handling concurrent tasks through preallocated threads.
 //
@@ -38,10 +173,20 @@ public:
 
     //
     // Initializes the thread pool.
+    // Submissions are rejected while the number of queued tasks is at the maximum; zero means unbounded.
+    // Tasks are queued per priority class; with no classes specified, the pool has a single one.
+    // With worker CPUs specified, workers are spread over them grouped per NUMA node, and each worker is
+    // pinned to the specified CPUs of its node; empty means unpinned workers. Returns InvalidArgument if
+    // any of the CPUs is not available to the process.
     //
     StatusCode
     Init(
-        const uint16_t p_NumberThreads);
+        const uint16_t p_NumberThreads,
+        const ThreadPoolScheduler p_Scheduler = ThreadPoolScheduler::SharedQueue,
+        const uint32_t p_MaxNumberQueuedTasks = 0u,
+        const std::vector<ThreadPoolPriorityClass>& p_PriorityClasses = {},
+        const ThreadPoolPriorityPolicy p_PriorityPolicy = ThreadPoolPriorityPolicy::WeightedFair,
+        const std::vector<uint16_t>& p_WorkerCpus = {});
 
     //
     // Destructor. Ensures all threads are finished properly.
@@ -54,6 +199,32 @@ public:
     uint16_t
     GetNumberThreads() const;
 
+    //
+    // Returns the number of priority classes of the pool.
+    //
+    uint8_t
+    GetNumberPriorityClasses() const;
+
+    //
+    // Returns the number of tasks rejected because the queue was full.
+    //
+    uint64_t
+    GetNumberRejectedTasks() const;
+
+    //
+    // Returns the index of the calling thread among the pool workers, or the number of
+    // threads if the calling thread does not belong to the pool.
+    //
+    uint16_t
+    GetCurrentWorkerIndex() const;
+
+    //
+    // Returns the priority class of the task the calling worker is executing, or zero if the
+    // calling thread does not belong to the pool.
+    //
+    uint8_t
+    GetCurrentPriorityClass() const;
+
     //
     //  Enqueues a task into the queue.
     //
@@ -72,38 +243,230 @@ public:
         
         std::future<ReturnType> packagedTaskResult = packagedTask->get_future();
 
+        //
+        // If thread pool is in destruction process or its queue is full fail the enqueue request.
+        //
+        if (Status::Failed(Schedule(
+            [packagedTask]()
+            {
+                (*packagedTask)();
+            },
+            0u)))
         {
-            std::unique_lock<std::mutex> lock(m_Lock);
+            return std::nullopt;
+        }
 
-            //
-            // If thread pool is in destruction process fail the enqueue request.
-            //
-            if (m_Stop)
-            {
-                return std::nullopt;
-            }
+        return std::make_optional<std::future<ReturnType>>(std::move(packagedTaskResult));
+    }
+
+    //
+    // Posts a fire-and-forget task into the queue. The function and its arguments are stored inline
+    // in the task, so no memory is allocated and no result is reported back.
+    // Returns ServiceIsStopped if the pool is stopping or ServerBusy if its queue is full.
+    //
+    template<typename Function, typename... Args>
+    StatusCode
+    Post(
+        Function&& p_Function, Args&&... p_args)
+    {
+        return PostWithPriority(0u, std::forward<Function>(p_Function), std::forward<Args>(p_args)...);
+    }
 
-            m_Tasks.emplace(
-                [packagedTask]()
+    //
+    // Posts a fire-and-forget task into the queue of the specified priority class.
+    // Returns ServiceIsStopped if the pool is stopping or ServerBusy if its queue is full.
+    //
+    template<typename Function, typename... Args>
+    StatusCode
+    PostWithPriority(
+        const uint8_t p_PriorityClass,
+        Function&& p_Function, Args&&... p_args)
+    {
+        return Schedule(
+            InlineTask(
+                [function = std::forward<Function>(p_Function), ...args = std::forward<Args>(p_args)]() mutable
                 {
-                    (*packagedTask)();
-                });
-        }
+                    std::invoke(function, args...);
+                }),
+            p_PriorityClass);
+    }
+
+    //
+    // Enqueues the tasks of a batch, in order, taking the queue locks once for the whole batch and waking
+    // up only as many workers as there are tasks. If the pool is stopping or its queue fills up, the remaining
+    // tasks are left in the batch and ServiceIsStopped or ServerBusy is returned. Either way the number of
+    // enqueued tasks, which are always the first ones of the batch, is returned through the output parameter.
+    //
+    StatusCode
+    EnqueueBatch(
+        ThreadPoolBatch& p_Batch,
+        size_t& p_NumberEnqueuedTasks);
+
+private:
+
+    //
+    // Scheduling state of a priority class.
+    //
+    struct alignas(64) PriorityClassState
+    {
 
         //
-        // Notify the task handler of a new task to be executed.
+        // Distance the pass of the class advances by per executed task; inversely proportional to its weight.
         //
-        m_Condition.notify_one();
-        return std::make_optional<std::future<ReturnType>>(std::move(packagedTaskResult));
-    }
+        uint64_t m_Stride;
 
-private:
+        //
+        // Maximum number of tasks of the class executed at the same time. Zero means unlimited.
+        //
+        uint16_t m_MaxConcurrency;
+
+        //
+        // Number of queued tasks of the class.
+        //
+        std::atomic<uint64_t> m_NumberQueuedTasks;
+
+        //
+        // Number of tasks of the class in execution. Only tracked for classes with a concurrency limit.
+        //
+        std::atomic<uint16_t> m_NumberRunningTasks;
+
+        //
+        // Queue of tasks of the class for the shared queue scheduler. Guarded by the pool lock.
+        //
+        std::queue<InlineTask> m_Tasks;
+
+    };
+
+    //
+    // Per-worker task queue for the work stealing scheduler.
+    // Allocated by its worker once pinned, so that it lives on the node of the worker.
+    //
+    struct alignas(64) WorkerQueue
+    {
+
+        //
+        // Exclusive lock for synchronizing access to the worker tasks.
+        // Only contended when a peer steals from this worker.
+        //
+        std::mutex m_Lock;
+
+        //
+        // Tasks of the worker per priority class, executed in FIFO order by both the owner and thieves.
+        //
+        std::vector<std::deque<InlineTask>> m_Tasks;
+
+        //
+        // Pass of each priority class as seen by the worker. Only accessed by the owner.
+        //
+        std::vector<uint64_t> m_Passes;
+
+        //
+        // Virtual time of the worker; the pass of the class it served last. Only accessed by the owner.
+        //
+        uint64_t m_VirtualTime;
+
+        //
+        // Workers whose queues the owner takes tasks from, starting with itself and then its peers on the
+        // same NUMA node, so that tasks only cross nodes when the whole node is idle. Only accessed by the owner.
+        //
+        std::vector<uint16_t> m_Peers;
+
+    };
+
+    //
+    // Hands a task over to the scheduler.
+    // Returns ServiceIsStopped if the pool is stopping or ServerBusy if its queue is full.
+    //
+    StatusCode
+    Schedule(
+        InlineTask&& p_Task,
+        const uint8_t p_PriorityClass);
+
+    //
+    // Picks the next priority class to serve among those with runnable tasks, excluding the
+    // ones in the mask, based on the specified passes. Returns the number of classes if none is runnable.
+    //
+    uint8_t
+    SelectPriorityClass(
+        const std::vector<uint64_t>& p_Passes,
+        const uint64_t p_VirtualTime,
+        const uint64_t p_ExcludedPriorityClasses) const;
+
+    //
+    // Advances the pass of a class that has just been served, along with the virtual time.
+    //
+    void
+    ChargePriorityClass(
+        std::vector<uint64_t>& p_Passes,
+        uint64_t& p_VirtualTime,
+        const uint8_t p_PriorityClass) const;
+
+    //
+    // Reserves an execution slot for a task of the class. Fails if the class is at its concurrency limit.
+    //
+    bool
+    TryAcquireExecutionSlot(
+        PriorityClassState& p_PriorityClass);
+
+    //
+    // Releases the execution slot of a finished task of the class, waking up a worker if tasks of the
+    // class were held back by its concurrency limit.
+    //
+    void
+    ReleaseExecutionSlot(
+        PriorityClassState& p_PriorityClass);
+
+    //
+    // Determines whether any priority class has queued tasks and room to execute them.
+    //
+    bool
+    HasRunnableTasks() const;
+
+    //
+    // Takes the next task for the shared queue scheduler. Must be called with the pool lock held.
+    // Returns the number of classes if no task is runnable.
+    //
+    uint8_t
+    DequeueSharedTask(
+        InlineTask& p_Task);
+
+    //
+    // Pins the calling worker and, with the work stealing scheduler, sets up its queue. Then waits for
+    // the rest of the workers to do the same. Returns whether the worker can start executing tasks.
+    //
+    bool
+    StartWorker(
+        const uint16_t p_WorkerIndex);
+
+    //
+    // Returns the workers tasks submitted from outside the pool are spread across: those on the NUMA node
+    // of the calling thread if the pool spans several nodes and has workers on it, or all of them otherwise.
+    //
+    const std::vector<uint16_t>&
+    GetSubmissionWorkers() const;
 
     //
     // Handles and executes tasks from the queue.
     //
     void
-    TaskHandler();
+    TaskHandler(
+        const uint16_t p_WorkerIndex);
+
+    //
+    // Handles and executes tasks with the work stealing scheduler.
+    //
+    void
+    WorkStealingTaskHandler(
+        const uint16_t p_WorkerIndex);
+
+    //
+    // Takes a task from the worker queue or, if empty, steals one from a peer.
+    // Returns the number of classes if no task could be taken, or the priority class of the task otherwise.
+    //
+    uint8_t
+    TryDequeueTask(
+        const uint16_t p_WorkerIndex,
+        InlineTask& p_Task);
 
     //
     // Worker threads to execute tasks in the pool.
@@ -111,12 +474,28 @@ private:
     std::vector<std::thread> m_WorkerThreads;
 
     //
-    // Queue of packaged tasks to be executed.
+    // Priority classes of the pool. Lower indexes have higher priority under strict priority scheduling.
     //
-    std::queue<std::function<void()>> m_Tasks;
-    
+    std::vector<std::unique_ptr<PriorityClassState>> m_PriorityClasses;
+
+    //
+    // Policy for choosing which priority class to serve next.
+    //
+    ThreadPoolPriorityPolicy m_PriorityPolicy;
+
+    //
+    // Pass of each priority class for the shared queue scheduler. Guarded by the pool lock.
+    //
+    std::vector<uint64_t> m_Passes;
+
+    //
+    // Virtual time of the shared queue scheduler; the pass of the class served last. Guarded by the pool lock.
+    //
+    uint64_t m_VirtualTime;
+
     //
     // Exclusive lock for synchronizing access to the tasks queue.
+    // With the work stealing scheduler it only guards parking and waking up workers.
     //
     std::mutex m_Lock;
 
@@ -130,13 +509,108 @@ private:
     //
     uint16_t m_NumberThreads;
 
+    //
+    // Scheduling policy of the pool.
+    //
+    ThreadPoolScheduler m_Scheduler;
+
+    //
+    // Maximum number of queued tasks. Zero means unbounded.
+    //
+    uint32_t m_MaxNumberQueuedTasks;
+
+    //
+    // Number of tasks rejected because the queue was full.
+    //
+    std::atomic<uint64_t> m_NumberRejectedTasks;
+
     //
     // Flag for stopping worker threads.
     //
-    bool m_Stop;
+    std::atomic<bool> m_Stop;
+
+    //
+    // Per-worker queues for the work stealing scheduler.
+    //
+    std::vector<std::unique_ptr<WorkerQueue>> m_WorkerQueues;
+
+    //
+    // Number of tasks queued across all priority classes and worker queues.
+    //
+    std::atomic<uint64_t> m_NumberQueuedTasks;
+
+    //
+    // Number of workers parked waiting for tasks.
+    //
+    std::atomic<uint16_t> m_NumberParkedWorkers;
+
+    //
+    // Round-robin cursor for distributing tasks submitted from outside the pool.
+    //
+    std::atomic<uint32_t> m_NextWorkerQueueIndex;
+
+    //
+    // CPUs each worker is pinned to. Empty sets leave the worker unpinned.
+    //
+    std::vector<std::vector<uint16_t>> m_WorkerCpus;
+
+    //
+    // NUMA node of each worker. Zero for unpinned workers.
+    //
+    std::vector<uint16_t> m_WorkerNumaNodes;
+
+    //
+    // Index of every worker, for spreading external submissions when locality does not apply.
+    //
+    std::vector<uint16_t> m_Workers;
+
+    //
+    // Workers on each NUMA node, indexed by node. Empty unless the workers span several nodes.
+    //
+    std::vector<std::vector<uint16_t>> m_NumaNodeWorkers;
+
+    //
+    // Number of workers done starting up. Guarded by the pool lock.
+    //
+    uint16_t m_NumberStartedWorkers;
+
+    //
+    // First failure of a worker starting up. Guarded by the pool lock.
+    //
+    StatusCode m_StartupStatus;
+
+    //
+    // Pool owning the calling thread, if the calling thread is a worker.
+    //
+    static thread_local ThreadPool* t_CurrentThreadPool;
+
+    //
+    // Index of the calling worker thread within its pool.
+    //
+    static thread_local uint16_t t_CurrentWorkerIndex;
+
+    //
+    // Priority class of the task the calling worker thread is executing.
+    //
+    static thread_local uint8_t t_CurrentPriorityClass;
+
+    //
+    // Number of dequeue attempts an idle worker makes before parking.
+    //
+    static constexpr uint32_t c_NumberSpinIterations = 128u;
+
+    //
+    // Maximum number of priority classes.
+    //
+    static constexpr uint8_t c_MaxNumberPriorityClasses = 64u;
+
+    //
+    // Pass distance of a weight of one; a class with weight W advances by c_StrideScale / W per task.
+    //
+    static constexpr uint64_t c_StrideScale = 1u << 20;
     
 };
 
 } // namespace gX.
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,163 @@
+// *************************************
+// Ganymede Xpedia
+// Common
+// 'gXTimerWheel.cc'
+// Author: jcjuarez
+// *************************************
+
+#include <algorithm>
+#include "gXTimerWheel.hh"
+
+namespace gX
+{
+
+TimerWheel::Timer::Timer()
+    : m_Context(nullptr),
+      m_Next(nullptr),
+      m_PreviousNext(nullptr),
+      m_ExpiryTick(0)
+{}
+
+bool
+TimerWheel::Timer::IsScheduled() const
+{
+    return m_PreviousNext != nullptr;
+}
+
+TimerWheel::TimerWheel(
+    const std::chrono::steady_clock::duration p_Resolution,
+    const std::chrono::steady_clock::time_point p_Time)
+    : m_Resolution(std::max(p_Resolution, std::chrono::steady_clock::duration(1))),
+      m_StartTime(p_Time),
+      m_CurrentTime(p_Time),
+      m_CurrentTick(0),
+      m_NumberTimers(0),
+      m_Slots {}
+{}
+
+void
+TimerWheel::Schedule(
+    Timer& p_Timer,
+    const std::chrono::steady_clock::time_point p_ExpiryTime)
+{
+    Cancel(p_Timer);
+
+    //
+    // Round up, so that timers never expire early.
+    //
+    uint64_t expiryTick = m_CurrentTick + 1u;
+
+    if (p_ExpiryTime > m_StartTime)
+    {
+        const std::chrono::steady_clock::duration delay = p_ExpiryTime - m_StartTime;
+        expiryTick = std::max(expiryTick, static_cast<uint64_t>((delay + m_Resolution - std::chrono::steady_clock::duration(1)) / m_Resolution));
+    }
+
+    p_Timer.m_ExpiryTick = std::min(expiryTick, m_CurrentTick + c_MaxNumberTicks);
+
+    Link(p_Timer);
+}
+
+void
+TimerWheel::Cancel(
+    Timer& p_Timer)
+{
+    if (p_Timer.IsScheduled())
+    {
+        Unlink(p_Timer);
+    }
+}
+
+std::chrono::steady_clock::time_point
+TimerWheel::GetExpiryTime(
+    const Timer& p_Timer) const
+{
+    return m_StartTime + m_Resolution * p_Timer.m_ExpiryTick;
+}
+
+std::chrono::steady_clock::time_point
+TimerWheel::GetCurrentTime() const
+{
+    return m_CurrentTime;
+}
+
+uint64_t
+TimerWheel::GetNumberTimers() const
+{
+    return m_NumberTimers;
+}
+
+std::chrono::steady_clock::time_point
+TimerWheel::GetNextExpiryTime() const
+{
+    if (m_NumberTimers == 0)
+    {
+        return std::chrono::steady_clock::time_point::max();
+    }
+
+    //
+    // The lowest level only holds timers expiring within one revolution of it, so each of its slots maps to a
+    // single tick. Timers of the higher levels move down no earlier than the end of the current revolution,
+    // which bounds the search.
+    //
+    const uint64_t revolutionEndTick = (m_CurrentTick | c_SlotMask) + 1u;
+
+    for (uint64_t tick = m_CurrentTick + 1u; tick < revolutionEndTick; ++tick)
+    {
+        if (m_Slots[tick & c_SlotMask] != nullptr)
+        {
+            return m_StartTime + m_Resolution * tick;
+        }
+    }
+
+    return m_StartTime + m_Resolution * revolutionEndTick;
+}
+
+void
+TimerWheel::Link(
+    Timer& p_Timer)
+{
+    //
+    // The level is picked by how far ahead the timer expires, and the slot by the bits of its expiry
+    // tick for that level; the slot is then reached no later than the timer expires.
+    //
+    const uint64_t numberTicks = p_Timer.m_ExpiryTick - m_CurrentTick;
+    uint32_t level = 0;
+
+    while (level + 1u < c_NumberLevels &&
+        numberTicks >= (1ull << (c_SlotBits * (level + 1u))))
+    {
+        ++level;
+    }
+
+    Timer*& slot = m_Slots[level * c_NumberSlots + ((p_Timer.m_ExpiryTick >> (c_SlotBits * level)) & c_SlotMask)];
+
+    p_Timer.m_Next = slot;
+    p_Timer.m_PreviousNext = &slot;
+
+    if (slot != nullptr)
+    {
+        slot->m_PreviousNext = &p_Timer.m_Next;
+    }
+
+    slot = &p_Timer;
+    ++m_NumberTimers;
+}
+
+void
+TimerWheel::Unlink(
+    Timer& p_Timer)
+{
+    *p_Timer.m_PreviousNext = p_Timer.m_Next;
+
+    if (p_Timer.m_Next != nullptr)
+    {
+        p_Timer.m_Next->m_PreviousNext = p_Timer.m_PreviousNext;
+    }
+
+    p_Timer.m_Next = nullptr;
+    p_Timer.m_PreviousNext = nullptr;
+    --m_NumberTimers;
+}
+
+} // namespace gX.
@@ -0,0 +1,282 @@
+// *************************************
+// Ganymede Xpedia
+// Common
+// 'gXTimerWheel.hh'
+// Author: jcjuarez
+// *************************************
+
+#ifndef GX_TIMER_WHEEL_
+#define GX_TIMER_WHEEL_
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace gX
+{
+
+//
+// Hierarchical timer wheel. Timers are rounded up to ticks of a fixed resolution and hashed into
+// slots by expiry tick; each level covers a span 256 times longer than the one below, and the timers
+// of a higher level slot are moved down as the wheel reaches its span. Scheduling, cancelling and
+// expiring a timer are constant time, and timers are embedded in their owners, so the wheel never
+// allocates. Not thread-safe; meant to be driven by a single event loop.
+//
+class TimerWheel
+{
+
+public:
+
+    //
+    // Timer node, embedded in the object it times. It must be cancelled before being destroyed if scheduled.
+    //
+    struct Timer
+    {
+
+        //
+        // Constructor. Creates an unscheduled timer.
+        //
+        Timer();
+
+        //
+        // Determines whether the timer is scheduled.
+        //
+        bool
+        IsScheduled() const;
+
+        //
+        // Object the timer belongs to, for the expiry handler to act upon.
+        //
+        void* m_Context;
+
+        //
+        // Next timer in the same slot. Managed by the wheel.
+        //
+        Timer* m_Next;
+
+        //
+        // Link pointing to the timer in its slot; null while unscheduled. Managed by the wheel.
+        //
+        Timer** m_PreviousNext;
+
+        //
+        // Tick the timer expires on. Managed by the wheel.
+        //
+        uint64_t m_ExpiryTick;
+
+    };
+
+    //
+    // Constructor. Ticks are counted from the specified time.
+    //
+    TimerWheel(
+        const std::chrono::steady_clock::duration p_Resolution,
+        const std::chrono::steady_clock::time_point p_Time);
+
+    //
+    // Schedules the timer to expire at the first tick not earlier than the specified time, or at the
+    // next tick if that time has passed. Timers already scheduled are moved.
+    //
+    void
+    Schedule(
+        Timer& p_Timer,
+        const std::chrono::steady_clock::time_point p_ExpiryTime);
+
+    //
+    // Cancels the timer, if scheduled.
+    //
+    void
+    Cancel(
+        Timer& p_Timer);
+
+    //
+    // Returns the time a scheduled timer expires at.
+    //
+    std::chrono::steady_clock::time_point
+    GetExpiryTime(
+        const Timer& p_Timer) const;
+
+    //
+    // Returns the time the wheel was last advanced to.
+    //
+    std::chrono::steady_clock::time_point
+    GetCurrentTime() const;
+
+    //
+    // Returns the number of scheduled timers.
+    //
+    uint64_t
+    GetNumberTimers() const;
+
+    //
+    // Returns the earliest time the wheel has to be advanced to for a timer to expire or move down a level,
+    // which is never later than the earliest expiry; the maximum time point if no timer is scheduled.
+    //
+    std::chrono::steady_clock::time_point
+    GetNextExpiryTime() const;
+
+    //
+    // Advances the wheel to the specified time, invoking the handler with every timer expiring on the way.
+    // Expired timers are unscheduled before the handler runs, which may schedule and cancel timers freely.
+    //
+    template<typename Function>
+    void
+    Advance(
+        const std::chrono::steady_clock::time_point p_Time,
+        Function&& p_OnExpired)
+    {
+        if (p_Time <= m_CurrentTime)
+        {
+            return;
+        }
+
+        m_CurrentTime = p_Time;
+
+        const uint64_t targetTick = static_cast<uint64_t>((p_Time - m_StartTime) / m_Resolution);
+
+        while (m_CurrentTick < targetTick)
+        {
+            if (m_NumberTimers == 0)
+            {
+                //
+                // Nothing can expire on the way; jump straight to the target.
+                //
+                m_CurrentTick = targetTick;
+
+                break;
+            }
+
+            ++m_CurrentTick;
+
+            //
+            // Move the timers of the higher level slots whose span starts on this tick down the wheel.
+            // They all land on slots other than the ones being moved, so the order of the levels does not matter.
+            //
+            for (uint32_t level = 1u;
+                level < c_NumberLevels && (m_CurrentTick & ((1ull << (c_SlotBits * level)) - 1u)) == 0;
+                ++level)
+            {
+                Timer* timer = m_Slots[level * c_NumberSlots + ((m_CurrentTick >> (c_SlotBits * level)) & c_SlotMask)];
+
+                while (timer != nullptr)
+                {
+                    Timer* nextTimer = timer->m_Next;
+
+                    Unlink(*timer);
+                    Link(*timer);
+
+                    timer = nextTimer;
+                }
+            }
+
+            //
+            // The head is read again after every handler, since handlers may cancel other timers of the slot.
+            //
+            Timer*& slot = m_Slots[m_CurrentTick & c_SlotMask];
+
+            while (slot != nullptr)
+            {
+                Timer& timer = *slot;
+
+                Unlink(timer);
+                p_OnExpired(timer);
+            }
+        }
+    }
+
+    //
+    // Cancels every scheduled timer, invoking the handler with each of them after it is unscheduled.
+    //
+    template<typename Function>
+    void
+    CancelAll(
+        Function&& p_OnCancelled)
+    {
+        for (Timer*& slot : m_Slots)
+        {
+            while (slot != nullptr)
+            {
+                Timer& timer = *slot;
+
+                Unlink(timer);
+                p_OnCancelled(timer);
+            }
+        }
+    }
+
+private:
+
+    //
+    // Hashes a timer into the slot covering its expiry tick.
+    //
+    void
+    Link(
+        Timer& p_Timer);
+
+    //
+    // Removes a timer from its slot.
+    //
+    void
+    Unlink(
+        Timer& p_Timer);
+
+    //
+    // Number of bits of the tick indexing the slots of each level.
+    //
+    static constexpr uint32_t c_SlotBits = 8u;
+
+    //
+    // Number of slots of each level.
+    //
+    static constexpr uint32_t c_NumberSlots = 1u << c_SlotBits;
+
+    //
+    // Mask selecting a slot index.
+    //
+    static constexpr uint64_t c_SlotMask = c_NumberSlots - 1u;
+
+    //
+    // Number of levels. Timers further away than the wheel spans expire at the end of its span.
+    //
+    static constexpr uint32_t c_NumberLevels = 4u;
+
+    //
+    // Largest number of ticks a timer can be scheduled ahead.
+    //
+    static constexpr uint64_t c_MaxNumberTicks = (1ull << (c_SlotBits * c_NumberLevels)) - 1u;
+
+    //
+    // Duration of a tick.
+    //
+    std::chrono::steady_clock::duration m_Resolution;
+
+    //
+    // Time of tick zero.
+    //
+    std::chrono::steady_clock::time_point m_StartTime;
+
+    //
+    // Time the wheel was last advanced to.
+    //
+    std::chrono::steady_clock::time_point m_CurrentTime;
+
+    //
+    // Last tick processed.
+    //
+    uint64_t m_CurrentTick;
+
+    //
+    // Number of scheduled timers.
+    //
+    uint64_t m_NumberTimers;
+
+    //
+    // Heads of the timer lists of every slot, level after level.
+    //
+    std::array<Timer*, c_NumberLevels * c_NumberSlots> m_Slots;
+
+};
+
+} // namespace gX.
+
+#endif
@@ -10,6 +10,45 @@ PrintRequest(std::string p_Request)
     return gX::Status::Success;
 }
 
+gX::StatusCode
+PrintRequestView(std::string_view p_Request)
+{
+    std::cout << "PrintRequestView execution." << std::endl;
+    std::cout << "MESSAGE: " << p_Request << std::endl;
+
+    return gX::Status::Success;
+}
+
+gX::StatusCode
+EchoRequest(std::string_view p_Request, gX::ResponseWriter& p_Response)
+{
+    return p_Response.Append(p_Request);
+}
+
+gX::StatusCode
+DoubleRequest(std::string_view p_Request, gX::ResponseWriter& p_Response)
+{
+    //
+    // Requests that are not a decimal number make std::stoull throw; the server answers them with a failure.
+    //
+    const uint64_t value = std::stoull(std::string(p_Request));
+
+    return p_Response.Append(std::to_string(value * 2u));
+}
+
+gX::Task<gX::StatusCode>
+DelayedEchoRequest(gX::AsyncEventLoop& p_AsyncEventLoop, std::string_view p_Request, gX::ResponseWriter& p_Response)
+{
+    const gX::StatusCode status = co_await p_AsyncEventLoop.SleepFor(std::chrono::milliseconds(10));
+
+    if (gX::Status::Failed(status))
+    {
+        co_return status;
+    }
+
+    co_return p_Response.Append(p_Request);
+}
+
 int main()
 {
     gX::DataTransmissionServer server("MetadataServer");
@@ -17,7 +56,18 @@ int main()
     gX::DataTransmissionServerConfiguration configuration;
 
     configuration.m_PacketTagResolverTable = {
-        {0, gX::EndpointType(std::bind(&PrintRequest, std::placeholders::_1))}
+        {0, gX::EndpointType(std::bind(&PrintRequest, std::placeholders::_1))},
+        {1, &PrintRequestView},
+        {2, gX::Endpoint::Bind<&EchoRequest>(gX::EndpointExecutionMode::Inline)},
+        {3, gX::CoroutineEndpointType(std::bind(&DelayedEchoRequest, std::ref(server.GetAsyncEventLoop()), std::placeholders::_1, std::placeholders::_2))},
+        {4, [](std::string_view p_Request) -> gX::StatusCode
+            {
+                std::cout << "PrintRequestView lambda execution." << std::endl;
+                std::cout << "MESSAGE: " << p_Request << std::endl;
+
+                return gX::Status::Success;
+            }},
+        {5, gX::Endpoint::Bind<&DoubleRequest>(gX::EndpointExecutionMode::Inline)}
     };
 
     gX::StatusCode status = server.Init(&configuration);